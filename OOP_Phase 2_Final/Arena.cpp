@@ -0,0 +1,115 @@
+#include "StrongHold.h"
+
+using namespace std;
+
+// Constructor
+Arena::Arena(size_t chunkSize)
+    : chunks(nullptr), chunkCursor(nullptr), chunkEnd(nullptr), chunkSize(chunkSize), numLiveBlocks(0) {
+
+    for (int i = 0; i < NUM_SIZE_CLASSES; i++) {
+        freeLists[i] = nullptr;
+    }
+}
+
+// Destructor
+Arena::~Arena() {
+    reset();
+}
+
+// Size class of a block, or -1 when it is too large for the arena
+int Arena::sizeClassOf(size_t size) {
+    if (size == 0) {
+        size = 1;
+    }
+    size_t sizeClass = (size + BLOCK_ALIGNMENT - 1) / BLOCK_ALIGNMENT - 1;
+    return sizeClass < (size_t)NUM_SIZE_CLASSES ? (int)sizeClass : -1;
+}
+
+// Start a new chunk; the rest of the previous chunk is abandoned
+void Arena::addChunk(size_t minSize) {
+    size_t dataSize = max(chunkSize, minSize);
+
+    // The header takes one aligned block so that the data stays aligned
+    char* memory = new char[BLOCK_ALIGNMENT + dataSize];
+    Chunk* chunk = reinterpret_cast<Chunk*>(memory);
+    chunk->next = chunks;
+    chunk->size = dataSize;
+    chunks = chunk;
+
+    chunkCursor = memory + BLOCK_ALIGNMENT;
+    chunkEnd = chunkCursor + dataSize;
+}
+
+void* Arena::allocate(size_t size) {
+    int sizeClass = sizeClassOf(size);
+
+    // Large objects go straight to the heap
+    if (sizeClass < 0) {
+        numLiveBlocks++;
+        return ::operator new(size);
+    }
+
+    // Reuse a freed block of the same size first
+    FreeBlock* block = freeLists[sizeClass];
+    if (block) {
+        freeLists[sizeClass] = block->next;
+        numLiveBlocks++;
+        return block;
+    }
+
+    size_t blockSize = (size_t)(sizeClass + 1) * BLOCK_ALIGNMENT;
+    if (!chunkCursor || (size_t)(chunkEnd - chunkCursor) < blockSize) {
+        addChunk(blockSize);
+    }
+
+    void* memory = chunkCursor;
+    chunkCursor += blockSize;
+    numLiveBlocks++;
+    return memory;
+}
+
+void Arena::deallocate(void* block, size_t size) {
+    if (!block) {
+        return;
+    }
+
+    int sizeClass = sizeClassOf(size);
+    if (sizeClass < 0) {
+        ::operator delete(block);
+    }
+    else {
+        FreeBlock* freeBlock = static_cast<FreeBlock*>(block);
+        freeBlock->next = freeLists[sizeClass];
+        freeLists[sizeClass] = freeBlock;
+    }
+    numLiveBlocks--;
+}
+
+// Free every chunk in one go. Objects still living in the arena are not
+// destroyed, so their owners must have let go of them first.
+void Arena::reset() {
+    while (chunks) {
+        Chunk* next = chunks->next;
+        delete[] reinterpret_cast<char*>(chunks);
+        chunks = next;
+    }
+    chunkCursor = nullptr;
+    chunkEnd = nullptr;
+
+    for (int i = 0; i < NUM_SIZE_CLASSES; i++) {
+        freeLists[i] = nullptr;
+    }
+    numLiveBlocks = 0;
+}
+
+int Arena::getNumLiveBlocks() const {
+    return numLiveBlocks;
+}
+
+size_t Arena::getReservedBytes() const {
+    size_t total = 0;
+    for (Chunk* chunk = chunks; chunk; chunk = chunk->next) {
+        total += chunk->size;
+    }
+    return total;
+}
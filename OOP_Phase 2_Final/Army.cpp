@@ -1,35 +1,26 @@
-#include "Stronghold.h"
+#include "StrongHold.h"
 #include <iostream>
 #include <fstream>
 #include <string>
+#include <climits>
 
 using namespace std;
 
 // Constructor
 Army::Army(const string& name)
     : Entity(name, "Kingdom military force"), totalStrength(0), overallMorale(70),
-    discipline(65), trainingLevel(50), foodConsumption(50), maxUnits(20), numUnits(0),
-    strategy(BALANCED), lastBattleResult(0) {
-
-    // Initialize units array
-    units = new MilitaryUnit * [maxUnits];
-    for (int i = 0; i < maxUnits; i++) {
-        units[i] = nullptr;
-    }
+    discipline(65), trainingLevel(50), foodConsumption(50),
+    strategy(BALANCED), lastBattleResult(0), unitStrengthSum(0), unitMoraleSum(0), unitFoodSum(0) {
 
     // Add some basic units
-    addUnit(new MilitaryUnit("Infantry", 100, 30, 50, 5, 10));
-    addUnit(new MilitaryUnit("Archers", 50, 50, 40, 3, 15));
-    addUnit(new MilitaryUnit("Cavalry", 80, 70, 60, 8, 25));
+    addUnit(MilitaryUnit("Infantry", GARRISON_INFANTRY, 100));
+    addUnit(MilitaryUnit("Archers", GARRISON_ARCHERS, 50));
+    addUnit(MilitaryUnit("Cavalry", GARRISON_CAVALRY, 80));
 }
 
 // Destructor
 Army::~Army() {
-    // Clean up units
-    for (int i = 0; i < numUnits; i++) {
-        delete units[i];
-    }
-    delete[] units;
+    // Units are held by value
 }
 
 // Getters and setters
@@ -92,35 +83,27 @@ void Army::setLastBattleResult(int result) {
 }
 
 // Unit management
-void Army::addUnit(MilitaryUnit* unit) {
-    if (!unit) {
-        throw invalid_argument("Cannot add null unit");
-    }
-
-    // Check if we need to resize the array
-    if (numUnits >= maxUnits) {
-        // Create a new, larger array
-        int newMaxUnits = maxUnits * 2;
-        MilitaryUnit** newUnits = new MilitaryUnit * [newMaxUnits];
+void Army::addUnit(const MilitaryUnit& unit) {
+    units.add(unit);
+    addToTotals(unit);
 
-        // Copy existing units to the new array
-        for (int i = 0; i < numUnits; i++) {
-            newUnits[i] = units[i];
-        }
-
-        // Initialize remaining slots to nullptr
-        for (int i = numUnits; i < newMaxUnits; i++) {
-            newUnits[i] = nullptr;
-        }
+    // Recalculate army stats
+    calculateTotalStrength();
+    calculateOverallMorale();
+    calculateFoodConsumption();
+}
 
-        // Delete the old array and update pointers
-        delete[] units;
-        units = newUnits;
-        maxUnits = newMaxUnits;
+// Add copies of a unit with one recalculation at the end
+void Army::addUnits(const MilitaryUnit& unit, int numCopies) {
+    if (numCopies < 0) {
+        throw invalid_argument("Cannot add a negative number of units");
     }
 
-    // Add the new unit
-    units[numUnits++] = unit;
+    units.reserve(units.size() + numCopies);
+    for (int i = 0; i < numCopies; i++) {
+        units.add(unit);
+    }
+    addToTotals(unit, numCopies);
 
     // Recalculate army stats
     calculateTotalStrength();
@@ -128,21 +111,19 @@ void Army::addUnit(MilitaryUnit* unit) {
     calculateFoodConsumption();
 }
 
+// Make room for a number of units up front
+void Army::reserveUnits(int numUnits) {
+    units.reserve(numUnits);
+}
+
 void Army::removeUnit(int index) {
-    if (index < 0 || index >= numUnits) {
+    if (index < 0 || index >= units.size()) {
         throw out_of_range("Unit index out of range");
     }
 
-    // Delete the unit object
-    delete units[index];
-
-    // Shift remaining elements
-    for (int i = index; i < numUnits - 1; i++) {
-        units[i] = units[i + 1];
-    }
-
-    // Set the last position to nullptr and decrement count
-    units[--numUnits] = nullptr;
+    // Close the gap, keeping the order of the remaining units
+    removeFromTotals(units[index]);
+    units.removeAt(index);
 
     // Recalculate army stats
     calculateTotalStrength();
@@ -150,21 +131,94 @@ void Army::removeUnit(int index) {
     calculateFoodConsumption();
 }
 
-MilitaryUnit* Army::getUnit(int index) const {
-    if (index < 0 || index >= numUnits) {
-        throw out_of_range("Unit index out of range");
-    }
-    return units[index];
+const MilitaryUnit* Army::getUnit(int index) const {
+    return &units.get(index);
 }
 
 int Army::getNumUnits() const {
-    return numUnits;
+    return units.size();
+}
+
+// Changes to a single unit go through the army, which keeps its sums over
+// the units up to date. Like any change to the units, they show in the
+// army's totals once those are recalculated.
+void Army::takeUnitCasualties(int index, int casualties) {
+    MilitaryUnit& unit = units.get(index);
+    removeFromTotals(unit);
+    unit.takeCasualties(casualties);
+    addToTotals(unit);
+}
+
+void Army::adjustUnitMorale(int index, int change) {
+    MilitaryUnit& unit = units.get(index);
+    removeFromTotals(unit);
+    unit.adjustMorale(change);
+    addToTotals(unit);
+}
+
+void Army::trainUnit(int index) {
+    MilitaryUnit& unit = units.get(index);
+    removeFromTotals(unit);
+    unit.train();
+    addToTotals(unit);
+}
+
+void Army::setUnitCount(int index, int count) {
+    MilitaryUnit& unit = units.get(index);
+    removeFromTotals(unit);
+    unit.setCount(count);
+    addToTotals(unit);
+}
+
+void Army::setUnitStats(int index, int attack, int defense) {
+    MilitaryUnit& unit = units.get(index);
+    removeFromTotals(unit);
+    unit.setAttack(attack);
+    unit.setDefense(defense);
+    addToTotals(unit);
+}
+
+// Same formula as MilitaryUnit::getCombatStrength, without looking up the
+// archetype again
+int Army::calculateUnitStrength(const UnitArchetype& archetype, const MilitaryUnit& unit) {
+    int unitStrength = (archetype.attack + unit.attackBonus + archetype.defense + unit.defenseBonus) * unit.count;
+    unitStrength = (unitStrength * unit.morale) / 100;
+    if (unit.isVeteran) {
+        unitStrength = (unitStrength * 120) / 100;
+    }
+    return unitStrength;
+}
+
+// Count a unit, or several copies of it, in the sums over the units
+void Army::addToTotals(const MilitaryUnit& unit, int numCopies) {
+    const UnitArchetype& archetype = UnitCatalog::getArchetypes()[unit.archetypeId];
+    unitStrengthSum += static_cast<long long>(calculateUnitStrength(archetype, unit)) * numCopies;
+    unitMoraleSum += static_cast<long long>(unit.morale) * numCopies;
+    unitFoodSum += static_cast<long long>(archetype.foodConsumption) * unit.count * numCopies;
+}
+
+// Take a unit out of the sums, before it changes or goes
+void Army::removeFromTotals(const MilitaryUnit& unit) {
+    const UnitArchetype& archetype = UnitCatalog::getArchetypes()[unit.archetypeId];
+    unitStrengthSum -= calculateUnitStrength(archetype, unit);
+    unitMoraleSum -= unit.morale;
+    unitFoodSum -= archetype.foodConsumption * unit.count;
+}
+
+// Sum over all units from scratch, e.g. after loading them
+void Army::recountUnits() {
+    unitStrengthSum = 0;
+    unitMoraleSum = 0;
+    unitFoodSum = 0;
+    for (const MilitaryUnit& unit : units) {
+        addToTotals(unit);
+    }
 }
 
 // Combat calculations
 int Army::calculateAttackPower() const {
-    // Base attack is total strength
-    int attackPower = totalStrength;
+    // Base attack is total strength; large armies overflow an int on the way
+    long long attackPower = totalStrength;
 
     // Adjust based on morale
     attackPower = (attackPower * overallMorale) / 100;
@@ -189,12 +243,12 @@ int Army::calculateAttackPower() const {
         break;
     }
 
-    return max(1, attackPower);
+    return static_cast<int>(min<long long>(INT_MAX, max(1LL, attackPower)));
 }
 
 int Army::calculateDefensePower() const {
     // Base defense is total strength / 2 + morale
-    int defensePower = (totalStrength / 2) + overallMorale;
+    long long defensePower = (totalStrength / 2) + overallMorale;
 
     // Adjust based on training level
     defensePower = (defensePower * (50 + trainingLevel / 2)) / 100;
@@ -216,12 +270,12 @@ int Army::calculateDefensePower() const {
         break;
     }
 
-    return max(1, defensePower);
+    return static_cast<int>(min<long long>(INT_MAX, max(1LL, defensePower)));
 }
 
 int Army::calculateMaintenanceCost() const {
     // Base cost is proportional to number of units
-    int baseCost = numUnits * 10;
+    int baseCost = units.size() * 10;
 
     // Add cost based on total strength
     baseCost += totalStrength / 5;
@@ -273,13 +327,13 @@ void Army::applyWeatherEffects(const Weather& weather) {
         int casualties = totalStrength / 20; // 5% casualties
 
         // Apply casualties to each unit
-        for (int i = 0; i < numUnits; i++) {
-            if (units[i]) {
-                int unitCasualties = units[i]->getCount() / 20;
-                if (unitCasualties < 1) unitCasualties = 1;
+        for (MilitaryUnit& unit : units) {
+            int unitCasualties = unit.getCount() / 20;
+            if (unitCasualties < 1) unitCasualties = 1;
 
-                units[i]->takeCasualties(unitCasualties);
-            }
+            removeFromTotals(unit);
+            unit.takeCasualties(unitCasualties);
+            addToTotals(unit);
         }
 
         // Recalculate stats
@@ -294,14 +348,15 @@ void Army::processBattleResults(bool victory, int casualtyPercentage) {
     int remainingCasualties = totalCasualties;
 
     // Distribute casualties among units
-    for (int i = 0; i < numUnits && remainingCasualties > 0; i++) {
-        if (units[i]) {
-            int unitCasualties = (units[i]->getCount() * casualtyPercentage) / 100;
-            if (unitCasualties < 1 && units[i]->getCount() > 0) unitCasualties = 1;
-
-            units[i]->takeCasualties(unitCasualties);
-            remainingCasualties -= unitCasualties;
-        }
+    for (int i = 0; i < units.size() && remainingCasualties > 0; i++) {
+        MilitaryUnit& unit = units[i];
+        int unitCasualties = (unit.getCount() * casualtyPercentage) / 100;
+        if (unitCasualties < 1 && unit.getCount() > 0) unitCasualties = 1;
+
+        removeFromTotals(unit);
+        unit.takeCasualties(unitCasualties);
+        addToTotals(unit);
+        remainingCasualties -= unitCasualties;
     }
 
     // Adjust morale based on battle outcome
@@ -319,6 +374,11 @@ void Army::processBattleResults(bool victory, int casualtyPercentage) {
     calculateOverallMorale();
 }
 
+// Keep the overall morale in a world store slot (store == nullptr moves it back here)
+void Army::bindToStore(WorldStore* store, int slot) {
+    overallMorale.bind(store ? &store->overallMorales : nullptr, slot);
+}
+
 // Adjust overall army morale
 void Army::adjustMorale(int change) {
     overallMorale += change;
@@ -328,10 +388,10 @@ void Army::adjustMorale(int change) {
     if (overallMorale > 100) overallMorale = 100;
 
     // Propagate morale changes to individual units
-    for (int i = 0; i < numUnits; i++) {
-        if (units[i]) {
-            units[i]->adjustMorale(change / 2); // Half effect on individual units
-        }
+    for (MilitaryUnit& unit : units) {
+        removeFromTotals(unit);
+        unit.adjustMorale(change / 2); // Half effect on individual units
+        addToTotals(unit);
     }
 }
 
@@ -342,10 +402,10 @@ void Army::train() {
     if (trainingLevel > 100) trainingLevel = 100;
 
     // Improve unit skills
-    for (int i = 0; i < numUnits; i++) {
-        if (units[i]) {
-            units[i]->train();
-        }
+    for (MilitaryUnit& unit : units) {
+        removeFromTotals(unit);
+        unit.train();
+        addToTotals(unit);
     }
 
     // Boost morale
@@ -356,55 +416,76 @@ void Army::train() {
 }
 
 // Recruit new troops
-void Army::recruit(MilitaryUnit* newUnit) {
-    if (!newUnit) {
-        throw invalid_argument("Cannot recruit null unit");
-    }
-
+void Army::recruit(const MilitaryUnit& newUnit) {
     // Add the new unit
     addUnit(newUnit);
 }
 
-// Calculate army stats
+// Calculate army stats from the sums over the units; debug builds check
+// the sums against a full recount first
 void Army::calculateTotalStrength() {
-    int strength = 0;
-
-    for (int i = 0; i < numUnits; i++) {
-        if (units[i]) {
-            strength += units[i]->getCombatStrength();
-        }
-    }
-
-    totalStrength = strength;
+#ifndef NDEBUG
+    verifyTotals();
+#endif
+    totalStrength = static_cast<int>(unitStrengthSum);
 }
 
 void Army::calculateOverallMorale() {
-    if (numUnits == 0) {
+#ifndef NDEBUG
+    verifyTotals();
+#endif
+    if (units.isEmpty()) {
         overallMorale = 50;
         return;
     }
 
-    int totalMorale = 0;
+    overallMorale = static_cast<int>(unitMoraleSum / units.size());
+}
 
-    for (int i = 0; i < numUnits; i++) {
-        if (units[i]) {
-            totalMorale += units[i]->getMorale();
-        }
+void Army::calculateFoodConsumption() {
+#ifndef NDEBUG
+    verifyTotals();
+#endif
+    foodConsumption = static_cast<int>(unitFoodSum);
+}
+
+// Recount the sums over the units from scratch and throw if a unit changed
+// without the army knowing
+void Army::verifyTotals() const {
+    const UnitArchetype* archetypes = UnitCatalog::getArchetypes();
+    long long strength = 0;
+    long long morale = 0;
+    long long food = 0;
+
+    for (const MilitaryUnit& unit : units) {
+        const UnitArchetype& archetype = archetypes[unit.archetypeId];
+        strength += calculateUnitStrength(archetype, unit);
+        morale += unit.morale;
+        food += archetype.foodConsumption * unit.count;
     }
 
-    overallMorale = totalMorale / numUnits;
+    if (strength != unitStrengthSum || morale != unitMoraleSum || food != unitFoodSum) {
+        throw logic_error("Army totals are out of date with its units");
+    }
 }
 
-void Army::calculateFoodConsumption() {
-    int consumption = 0;
+// Soldiers and combat strength of the active units of each archetype, into
+// arrays of UnitCatalog::getNumArchetypes() entries
+void Army::calculateArchetypeTotals(int* soldiers, int* strengths) const {
+    const UnitArchetype* archetypes = UnitCatalog::getArchetypes();
+    int numArchetypes = UnitCatalog::getNumArchetypes();
+    for (int i = 0; i < numArchetypes; i++) {
+        soldiers[i] = 0;
+        strengths[i] = 0;
+    }
 
-    for (int i = 0; i < numUnits; i++) {
-        if (units[i]) {
-            consumption += units[i]->getFoodConsumption();
+    for (const MilitaryUnit& unit : units) {
+        if (!unit.isActive) {
+            continue;
         }
+        soldiers[unit.archetypeId] += unit.count;
+        strengths[unit.archetypeId] += calculateUnitStrength(archetypes[unit.archetypeId], unit);
     }
-
-    foodConsumption = consumption;
 }
 
 // Update method required by Entity base class
@@ -412,10 +493,10 @@ void Army::update() {
     if (!getIsActive()) return;
 
     // Update all units
-    for (int i = 0; i < numUnits; i++) {
-        if (units[i]) {
-            units[i]->update();
-        }
+    for (MilitaryUnit& unit : units) {
+        removeFromTotals(unit);
+        unit.update();
+        addToTotals(unit);
     }
 
     // Natural morale recovery
@@ -446,11 +527,11 @@ void Army::save(ofstream& file) const {
     file << lastBattleResult << endl;
 
     // Save number of units
-    file << numUnits << endl;
+    file << units.size() << endl;
 
     // Save each unit
-    for (int i = 0; i < numUnits; i++) {
-        units[i]->save(file);
+    for (int i = 0; i < units.size(); i++) {
+        units[i].save(file);
     }
 }
 
@@ -477,11 +558,7 @@ void Army::load(ifstream& file) {
     file >> lastBattleResult;
 
     // Clean up existing units
-    for (int i = 0; i < numUnits; i++) {
-        delete units[i];
-        units[i] = nullptr;
-    }
-    numUnits = 0;
+    units.clear();
 
     // Load number of units
     int loadNumUnits;
@@ -489,9 +566,56 @@ void Army::load(ifstream& file) {
     file.ignore(); // Skip newline
 
     // Load each unit
+    units.reserve(loadNumUnits);
+    for (int i = 0; i < loadNumUnits; i++) {
+        units.emplace("Temp", GARRISON_INFANTRY).load(file);
+    }
+    recountUnits();
+
+    // Recalculate army stats
+    calculateTotalStrength();
+    calculateOverallMorale();
+    calculateFoodConsumption();
+}
+
+// Save army data in binary form
+void Army::saveBinary(SaveWriter& writer) const {
+    Entity::saveBinary(writer);
+    writer.writeInt(totalStrength);
+    writer.writeInt(overallMorale);
+    writer.writeInt(discipline);
+    writer.writeInt(trainingLevel);
+    writer.writeInt(foodConsumption);
+    writer.writeInt(static_cast<int>(strategy));
+    writer.writeInt(lastBattleResult);
+
+    writer.writeInt(units.size());
+    for (const MilitaryUnit& unit : units) {
+        unit.saveBinary(writer);
+    }
+}
+
+// Load army data in binary form
+void Army::loadBinary(SaveReader& reader) {
+    Entity::loadBinary(reader);
+    totalStrength = reader.readInt();
+    overallMorale = reader.readInt();
+    discipline = reader.readInt();
+    trainingLevel = reader.readInt();
+    foodConsumption = reader.readInt();
+    strategy = static_cast<CombatStrategy>(reader.readInt());
+    lastBattleResult = reader.readInt();
+
+    units.clear();
+    int loadNumUnits = reader.readInt();
+    units.reserve(loadNumUnits);
     for (int i = 0; i < loadNumUnits; i++) {
-        MilitaryUnit* unit = new MilitaryUnit("Temp", 0, 0, 0, 0, 0);
-        unit->load(file);
-        addUnit(unit);
+        units.emplace("Temp", GARRISON_INFANTRY).loadBinary(reader);
     }
+    recountUnits();
+
+    // Recalculate army stats
+    calculateTotalStrength();
+    calculateOverallMorale();
+    calculateFoodConsumption();
 }
\ No newline at end of file
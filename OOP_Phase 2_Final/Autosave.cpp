@@ -0,0 +1,151 @@
+#include "StrongHold.h"
+#include <cstdio>
+#include <string>
+
+using namespace std;
+
+// Constructor; takes the engine state and the kingdom list as they are now.
+// start() sets the background thread going.
+AutosaveJob::AutosaveJob(const string& filename, GameEngine& engine)
+    : filename(filename), turn(engine.getCurrentTurn() - 1), kingdoms(nullptr), numKingdoms(engine.getNumKingdoms()),
+    numChunks(0), gameSection(true), chunks(nullptr), chunkStates(nullptr), isFinished(false) {
+
+    engine.writeGameSection(gameSection);
+
+    kingdoms = new Kingdom*[max(numKingdoms, 1)];
+    for (int i = 0; i < numKingdoms; i++) {
+        kingdoms[i] = engine.getKingdom(i);
+    }
+
+    numChunks = (numKingdoms + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    chunks = new SaveWriter*[max(numChunks, 1)];
+    chunkStates = new atomic<int>[max(numChunks, 1)];
+    for (int i = 0; i < numChunks; i++) {
+        chunks[i] = nullptr;
+        chunkStates[i].store(CHUNK_UNCLAIMED);
+    }
+}
+
+// Destructor; waits for the background thread
+AutosaveJob::~AutosaveJob() {
+    wait();
+
+    for (int i = 0; i < numChunks; i++) {
+        delete chunks[i];
+    }
+    delete[] chunks;
+    delete[] chunkStates;
+    delete[] kingdoms;
+}
+
+void AutosaveJob::start() {
+    worker = thread(&AutosaveJob::run, this);
+}
+
+// Make sure the kingdom's chunk has been serialized, doing it on the
+// calling thread if nobody has started on it yet
+void AutosaveJob::claim(int kingdomIndex) {
+    if (kingdomIndex < 0 || kingdomIndex >= numKingdoms) {
+        throw out_of_range("Kingdom index out of range");
+    }
+    claimChunk(kingdomIndex / CHUNK_SIZE);
+}
+
+void AutosaveJob::claimChunk(int chunk) {
+    int state = CHUNK_UNCLAIMED;
+    if (chunkStates[chunk].compare_exchange_strong(state, CHUNK_SERIALIZING)) {
+        SaveWriter* writer = new SaveWriter(true);
+        try {
+            int end = min(numKingdoms, (chunk + 1) * CHUNK_SIZE);
+            for (int i = chunk * CHUNK_SIZE; i < end; i++) {
+                writer->beginSection(SECTION_KINGDOM);
+                kingdoms[i]->saveBinary(*writer);
+                writer->endSection();
+            }
+        }
+        catch (const exception& e) {
+            delete writer;
+            writer = nullptr;
+
+            lock_guard<mutex> lock(jobMutex);
+            if (errorMessage.empty()) {
+                errorMessage = e.what();
+            }
+        }
+
+        {
+            lock_guard<mutex> lock(jobMutex);
+            chunks[chunk] = writer;
+            chunkStates[chunk].store(CHUNK_DONE);
+        }
+        chunkDone.notify_all();
+        return;
+    }
+
+    if (state == CHUNK_DONE) {
+        return;
+    }
+
+    // Someone else is serializing it
+    unique_lock<mutex> lock(jobMutex);
+    chunkDone.wait(lock, [this, chunk] { return chunkStates[chunk].load() == CHUNK_DONE; });
+}
+
+// Background thread: serialize what the turn has not claimed, then put the
+// chunks together and write the file
+void AutosaveJob::run() {
+    auto startTime = chrono::steady_clock::now();
+
+    for (int chunk = numChunks - 1; chunk >= 0; chunk--) {
+        claimChunk(chunk);
+    }
+
+    try {
+        if (!errorMessage.empty()) {
+            throw runtime_error(errorMessage);
+        }
+
+        SaveWriter writer;
+        writer.appendSections(gameSection);
+        for (int i = 0; i < numChunks; i++) {
+            writer.appendSections(*chunks[i]);
+            delete chunks[i];
+            chunks[i] = nullptr;
+        }
+
+        // Write beside the old autosave and swap it in, so a crash never
+        // leaves a half-written file in its place
+        string tempFilename = filename + ".tmp";
+        writer.writeToFile(tempFilename);
+        if (rename(tempFilename.c_str(), filename.c_str()) != 0) {
+            // Some platforms will not rename over an existing file
+            remove(filename.c_str());
+            if (rename(tempFilename.c_str(), filename.c_str()) != 0) {
+                throw runtime_error("Could not replace " + filename);
+            }
+        }
+
+        // A full save replaces the deltas that built on the old file
+        remove((filename + ".delta").c_str());
+
+        double elapsedMilliseconds = chrono::duration<double, milli>(chrono::steady_clock::now() - startTime).count();
+        LogLine() << "Autosaved turn " << turn << " to " << filename << " in "
+            << fixed << setprecision(1) << elapsedMilliseconds << " ms.";
+    }
+    catch (const exception& e) {
+        LogLine(LOG_WARNING) << "Autosave of turn " << turn << " to " << filename << " failed: " << e.what();
+    }
+
+    isFinished.store(true);
+}
+
+// Wait for the background thread to finish
+void AutosaveJob::wait() {
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
+
+bool AutosaveJob::getIsFinished() const {
+    return isFinished.load();
+}
@@ -1,4 +1,4 @@
-#include "Stronghold.h"
+#include "StrongHold.h"
 #include <iostream>
 #include <fstream>
 #include <string>
@@ -8,35 +8,22 @@ using namespace std;
 // Constructor
 Bank::Bank(const string& name)
     : Entity(name, "Kingdom banking system"), interestRate(0.05), investmentReturnRate(0.03), goldReserves(1000),
-    totalLoans(0), loanLimit(10000), defaultRisk(5), fraudLevel(0), maxLoans(10),
-    numLoans(0), maxInvestments(10), numInvestments(0) {
-
-    // Initialize loans array
-    loans = new Loan * [maxLoans];
-    for (int i = 0; i < maxLoans; i++) {
-        loans[i] = nullptr;
-    }
-
-    // Initialize investments array
-    investments = new Investment * [maxInvestments];
-    for (int i = 0; i < maxInvestments; i++) {
-        investments[i] = nullptr;
-    }
+    totalLoans(0), loanLimit(10000), defaultRisk(5), fraudLevel(0) {
 }
 
 // Destructor
 Bank::~Bank() {
-    // Clean up loans
-    for (int i = 0; i < numLoans; i++) {
-        delete loans[i];
-    }
-    delete[] loans;
+    // Loans and investments are held by value
+}
 
-    // Clean up investments
-    for (int i = 0; i < numInvestments; i++) {
-        delete investments[i];
-    }
-    delete[] investments;
+// Remove all loans
+void Bank::clearLoans() {
+    loans.clear();
+}
+
+// Remove all investments
+void Bank::clearInvestments() {
+    investments.clear();
 }
 
 // Getters and setters
@@ -65,11 +52,11 @@ int Bank::getReserve() const {
 }
 
 int Bank::getNumLoans() const {
-    return numLoans;
+    return loans.size();
 }
 
 int Bank::getNumInvestments() const {
-    return numInvestments;
+    return investments.size();
 }
 
 int Bank::getGoldReserves() const {
@@ -124,40 +111,15 @@ bool Bank::takeLoan(int amount, int duration) {
         return false;
     }
 
-    // Check if we're at the maximum number of loans
-    if (numLoans >= maxLoans) {
-        // Create a new, larger array
-        int newMaxLoans = maxLoans * 2;
-        Loan** newLoans = new Loan * [newMaxLoans];
-
-        // Copy existing loans to the new array
-        for (int i = 0; i < numLoans; i++) {
-            newLoans[i] = loans[i];
-        }
-
-        // Initialize remaining slots to nullptr
-        for (int i = numLoans; i < newMaxLoans; i++) {
-            newLoans[i] = nullptr;
-        }
-
-        // Delete the old array and update pointers
-        delete[] loans;
-        loans = newLoans;
-        maxLoans = newMaxLoans;
-    }
-
     // Create a new loan
-    string loanName = "Loan #" + to_string(numLoans + 1);
-    Loan* newLoan = new Loan(loanName);
+    string loanName = "Loan #" + to_string(loans.size() + 1);
+    Loan* newLoan = &loans.emplace(loanName);
     newLoan->amount = amount;
     newLoan->interestRate = interestRate;
     newLoan->duration = duration;
     newLoan->turnsRemaining = duration;
     newLoan->isActive = true;
 
-    // Add the loan
-    loans[numLoans++] = newLoan;
-
     // Update bank state
     totalLoans += amount;
     goldReserves -= amount;
@@ -167,7 +129,7 @@ bool Bank::takeLoan(int amount, int duration) {
 
 // Repay a loan or part of a loan
 void Bank::repayLoan(int amount) {
-    if (amount <= 0 || numLoans == 0) {
+    if (amount <= 0 || loans.isEmpty()) {
         return;
     }
 
@@ -175,9 +137,9 @@ void Bank::repayLoan(int amount) {
     Loan* oldestLoan = nullptr;
     int oldestIndex = -1;
 
-    for (int i = 0; i < numLoans; i++) {
-        if (loans[i] && loans[i]->isActive) {
-            oldestLoan = loans[i];
+    for (int i = 0; i < loans.size(); i++) {
+        if (loans[i].isActive) {
+            oldestLoan = &loans[i];
             oldestIndex = i;
             break;
         }
@@ -287,15 +249,15 @@ void Bank::audit() {
 
 // Process loan defaults
 void Bank::processDefaults() {
-    for (int i = 0; i < numLoans; i++) {
-        if (loans[i] && loans[i]->isActive) {
+    for (int i = 0; i < loans.size(); i++) {
+        if (loans[i].isActive) {
             // Check for default based on default risk
             int defaultChance = defaultRisk / 10; // 0-10%
 
             if (randomInt(1, 100) <= defaultChance) {
                 // Loan defaults - write off the loan
-                totalLoans -= loans[i]->amount;
-                loans[i]->isActive = false;
+                totalLoans -= loans[i].amount;
+                loans[i].isActive = false;
 
                 // Increase default risk
                 defaultRisk = min(100, defaultRisk + 5);
@@ -309,19 +271,19 @@ void Bank::update() {
     if (!isActive) return;
 
     // Process loan payments and expirations
-    for (int i = 0; i < numLoans; i++) {
-        if (loans[i] && loans[i]->isActive) {
+    for (int i = 0; i < loans.size(); i++) {
+        if (loans[i].isActive) {
             // Decrement turns remaining
-            loans[i]->turnsRemaining--;
+            loans[i].turnsRemaining--;
 
             // Check if loan has expired
-            if (loans[i]->turnsRemaining <= 0) {
+            if (loans[i].turnsRemaining <= 0) {
                 // Attempt to automatically collect payment
-                int interestEarned = (loans[i]->amount * loans[i]->interestRate * loans[i]->duration) / 100;
+                int interestEarned = (loans[i].amount * loans[i].interestRate * loans[i].duration) / 100;
                 goldReserves += interestEarned;
 
                 // Mark loan as inactive
-                loans[i]->isActive = false;
+                loans[i].isActive = false;
             }
         }
     }
@@ -357,18 +319,16 @@ void Bank::save(ofstream& file) const {
     file << fraudLevel << endl;
 
     // Save number of loans
-    file << numLoans << endl;
+    file << loans.size() << endl;
 
     // Save each loan
-    for (int i = 0; i < numLoans; i++) {
-        if (loans[i]) {
-            file << loans[i]->name << endl;
-            file << loans[i]->amount << endl;
-            file << loans[i]->interestRate << endl;
-            file << loans[i]->duration << endl;
-            file << loans[i]->turnsRemaining << endl;
-            file << loans[i]->isActive << endl;
-        }
+    for (int i = 0; i < loans.size(); i++) {
+        file << loans[i].name << endl;
+        file << loans[i].amount << endl;
+        file << loans[i].interestRate << endl;
+        file << loans[i].duration << endl;
+        file << loans[i].turnsRemaining << endl;
+        file << loans[i].isActive << endl;
     }
 }
 
@@ -390,11 +350,7 @@ void Bank::load(ifstream& file) {
     file >> fraudLevel;
 
     // Clean up existing loans
-    for (int i = 0; i < numLoans; i++) {
-        delete loans[i];
-        loans[i] = nullptr;
-    }
-    numLoans = 0;
+    clearLoans();
 
     // Load number of loans
     int loadNumLoans;
@@ -402,34 +358,97 @@ void Bank::load(ifstream& file) {
     file.ignore(); // Skip newline
 
     // Ensure we have enough space for loans
-    if (loadNumLoans > maxLoans) {
-        // Create a new, larger array
-        Loan** newLoans = new Loan * [loadNumLoans];
-
-        // Initialize all slots to nullptr
-        for (int i = 0; i < loadNumLoans; i++) {
-            newLoans[i] = nullptr;
-        }
-
-        // Delete the old array and update pointers
-        delete[] loans;
-        loans = newLoans;
-        maxLoans = loadNumLoans;
-    }
+    loans.reserve(loadNumLoans);
 
     // Load each loan
     for (int i = 0; i < loadNumLoans; i++) {
-        Loan* loan = new Loan("Temp");
+        Loan* loan = &loans.emplace("Temp");
 
-        getline(file, loan->name);
+        string loanName;
+        getline(file, loanName);
+        loan->name = Symbol(loanName);
         file >> loan->amount;
         file >> loan->interestRate;
         file >> loan->duration;
         file >> loan->turnsRemaining;
         file >> loan->isActive;
         file.ignore(); // Skip newline
+    }
+}
 
-        loans[numLoans++] = loan;
+// Save bank data in binary form
+void Bank::saveBinary(SaveWriter& writer) const {
+    Entity::saveBinary(writer);
+    writer.writeDouble(interestRate);
+    writer.writeInt(goldReserves);
+    writer.writeInt(totalLoans);
+    writer.writeInt(loanLimit);
+    writer.writeInt(defaultRisk);
+    writer.writeInt(fraudLevel);
+
+    writer.writeInt(loans.size());
+    for (const Loan& loan : loans) {
+        writer.writeSymbol(loan.name);
+        writer.writeInt(loan.amount);
+        writer.writeDouble(loan.interestRate);
+        writer.writeInt(loan.duration);
+        writer.writeInt(loan.turnsRemaining);
+        writer.writeBool(loan.isActive);
+    }
+}
+
+// Load bank data in binary form
+void Bank::loadBinary(SaveReader& reader) {
+    Entity::loadBinary(reader);
+    interestRate = reader.readDouble();
+    goldReserves = reader.readInt();
+    totalLoans = reader.readInt();
+    loanLimit = reader.readInt();
+    defaultRisk = reader.readInt();
+    fraudLevel = reader.readInt();
+
+    clearLoans();
+    int loadNumLoans = reader.readInt();
+    loans.reserve(loadNumLoans);
+    for (int i = 0; i < loadNumLoans; i++) {
+        Loan& loan = loans.emplace("");
+        loan.name = reader.readSymbol();
+        loan.amount = reader.readInt();
+        loan.interestRate = reader.readDouble();
+        loan.duration = reader.readInt();
+        loan.turnsRemaining = reader.readInt();
+        loan.isActive = reader.readBool();
+    }
+}
+
+// Investments in binary form. Saves leave them out; turn snapshots keep them.
+void Bank::saveInvestmentsBinary(SaveWriter& writer) const {
+    writer.writeDouble(investmentReturnRate);
+    writer.writeInt(investments.size());
+    for (const Investment& investment : investments) {
+        writer.writeSymbol(investment.name);
+        writer.writeInt(investment.amount);
+        writer.writeDouble(investment.returnRate);
+        writer.writeInt(investment.duration);
+        writer.writeInt(investment.turnsRemaining);
+        writer.writeBool(investment.isActive);
+    }
+}
+
+void Bank::loadInvestmentsBinary(SaveReader& reader) {
+    investmentReturnRate = reader.readDouble();
+
+    clearInvestments();
+    int loadNumInvestments = reader.readInt();
+    investments.reserve(loadNumInvestments);
+    for (int i = 0; i < loadNumInvestments; i++) {
+        Investment& investment = investments.emplace("");
+        investment.name = reader.readSymbol();
+        investment.amount = reader.readInt();
+        investment.returnRate = reader.readDouble();
+        investment.duration = reader.readInt();
+        investment.turnsRemaining = reader.readInt();
+        investment.isActive = reader.readBool();
     }
 }
 
@@ -444,40 +463,15 @@ bool Bank::provideLoan(int amount, int duration, Treasury* treasury) {
         return false;
     }
 
-    // Check if we're at the maximum number of loans
-    if (numLoans >= maxLoans) {
-        // Create a new, larger array
-        int newMaxLoans = maxLoans * 2;
-        Loan** newLoans = new Loan * [newMaxLoans];
-
-        // Copy existing loans to the new array
-        for (int i = 0; i < numLoans; i++) {
-            newLoans[i] = loans[i];
-        }
-
-        // Initialize remaining slots to nullptr
-        for (int i = numLoans; i < newMaxLoans; i++) {
-            newLoans[i] = nullptr;
-        }
-
-        // Delete the old array and update pointers
-        delete[] loans;
-        loans = newLoans;
-        maxLoans = newMaxLoans;
-    }
-
     // Create a new loan
-    string loanName = "Treasury Loan #" + to_string(numLoans + 1);
-    Loan* newLoan = new Loan(loanName);
+    string loanName = "Treasury Loan #" + to_string(loans.size() + 1);
+    Loan* newLoan = &loans.emplace(loanName);
     newLoan->amount = amount;
     newLoan->interestRate = interestRate;
     newLoan->duration = duration;
     newLoan->turnsRemaining = duration;
     newLoan->isActive = true;
 
-    // Add the loan
-    loans[numLoans++] = newLoan;
-
     // Update bank state
     goldReserves -= amount;
 
@@ -489,7 +483,7 @@ bool Bank::provideLoan(int amount, int duration, Treasury* treasury) {
 
 // Repay loans from treasury
 int Bank::repayLoans(int amount, Treasury* treasury) {
-    if (!treasury || amount <= 0 || numLoans == 0) {
+    if (!treasury || amount <= 0 || loans.isEmpty()) {
         return 0;
     }
 
@@ -502,14 +496,14 @@ int Bank::repayLoans(int amount, Treasury* treasury) {
     int totalRepaid = 0;
 
     // Find active loans and repay them in order
-    for (int i = 0; i < numLoans && remainingAmount > 0; i++) {
-        if (loans[i] && loans[i]->isActive) {
+    for (int i = 0; i < loans.size() && remainingAmount > 0; i++) {
+        if (loans[i].isActive) {
             // Calculate interest
-            double interestRate = loans[i]->interestRate;
-            int loanDuration = loans[i]->duration;
-            int turnsElapsed = loanDuration - loans[i]->turnsRemaining;
+            double interestRate = loans[i].interestRate;
+            int loanDuration = loans[i].duration;
+            int turnsElapsed = loanDuration - loans[i].turnsRemaining;
 
-            int loanAmount = loans[i]->amount;
+            int loanAmount = loans[i].amount;
             int interest = static_cast<int>(loanAmount * interestRate * turnsElapsed / 10.0);
             int totalOwed = loanAmount + interest;
 
@@ -519,8 +513,8 @@ int Bank::repayLoans(int amount, Treasury* treasury) {
                 totalRepaid += totalOwed;
 
                 // Mark loan as repaid
-                loans[i]->isActive = false;
-                loans[i]->amount = 0;
+                loans[i].isActive = false;
+                loans[i].amount = 0;
                 goldReserves += loanAmount; // Return principal to reserves
             }
             else {
@@ -528,7 +522,7 @@ int Bank::repayLoans(int amount, Treasury* treasury) {
                 double ratio = static_cast<double>(remainingAmount) / totalOwed;
                 int principalRepaid = static_cast<int>(loanAmount * ratio);
 
-                loans[i]->amount -= principalRepaid;
+                loans[i].amount -= principalRepaid;
                 goldReserves += principalRepaid;
 
                 totalRepaid += remainingAmount;
@@ -550,20 +544,20 @@ int Bank::displayLoans() {
     int totalDebt = 0;
     bool hasActiveLoans = false;
 
-    for (int i = 0; i < numLoans; i++) {
-        if (loans[i] && loans[i]->isActive) {
+    for (int i = 0; i < loans.size(); i++) {
+        if (loans[i].isActive) {
             hasActiveLoans = true;
 
-            double interestRate = loans[i]->interestRate;
-            int loanDuration = loans[i]->duration;
-            int turnsRemaining = loans[i]->turnsRemaining;
+            double interestRate = loans[i].interestRate;
+            int loanDuration = loans[i].duration;
+            int turnsRemaining = loans[i].turnsRemaining;
             int turnsElapsed = loanDuration - turnsRemaining;
 
-            int loanAmount = loans[i]->amount;
+            int loanAmount = loans[i].amount;
             int interest = static_cast<int>(loanAmount * interestRate * turnsElapsed / 10.0);
             int totalOwed = loanAmount + interest;
 
-            cout << (i + 1) << ". " << loans[i]->name << endl;
+            cout << (i + 1) << ". " << loans[i].name << endl;
             cout << "   Principal: " << loanAmount << " gold" << endl;
             cout << "   Interest accrued: " << interest << " gold" << endl;
             cout << "   Total owed: " << totalOwed << " gold" << endl;
@@ -585,20 +579,20 @@ int Bank::displayLoans() {
 void Bank::displayInvestments() {
     bool hasActiveInvestments = false;
 
-    for (int i = 0; i < numInvestments; i++) {
-        if (investments[i] && investments[i]->isActive) {
+    for (int i = 0; i < investments.size(); i++) {
+        if (investments[i].isActive) {
             hasActiveInvestments = true;
 
-            double returnRate = investments[i]->returnRate;
-            int investmentDuration = investments[i]->duration;
-            int turnsRemaining = investments[i]->turnsRemaining;
+            double returnRate = investments[i].returnRate;
+            int investmentDuration = investments[i].duration;
+            int turnsRemaining = investments[i].turnsRemaining;
             int turnsElapsed = investmentDuration - turnsRemaining;
 
-            int investmentAmount = investments[i]->amount;
+            int investmentAmount = investments[i].amount;
             int returns = static_cast<int>(investmentAmount * returnRate * investmentDuration / 10.0);
             int totalReturn = investmentAmount + returns;
 
-            cout << (i + 1) << ". " << investments[i]->name << endl;
+            cout << (i + 1) << ". " << investments[i].name << endl;
             cout << "   Principal: " << investmentAmount << " gold" << endl;
             cout << "   Expected returns: " << returns << " gold" << endl;
             cout << "   Total value at maturity: " << totalReturn << " gold" << endl;
@@ -623,40 +617,15 @@ bool Bank::makeInvestment(int amount, int duration, Treasury* treasury) {
         return false;
     }
 
-    // Check if we're at the maximum number of investments
-    if (numInvestments >= maxInvestments) {
-        // Create a new, larger array
-        int newMaxInvestments = maxInvestments * 2;
-        Investment** newInvestments = new Investment * [newMaxInvestments];
-
-        // Copy existing investments to the new array
-        for (int i = 0; i < numInvestments; i++) {
-            newInvestments[i] = investments[i];
-        }
-
-        // Initialize remaining slots to nullptr
-        for (int i = numInvestments; i < newMaxInvestments; i++) {
-            newInvestments[i] = nullptr;
-        }
-
-        // Delete the old array and update pointers
-        delete[] investments;
-        investments = newInvestments;
-        maxInvestments = newMaxInvestments;
-    }
-
     // Create new investment
-    string investmentName = "Investment #" + to_string(numInvestments + 1);
-    Investment* newInvestment = new Investment(investmentName);
+    string investmentName = "Investment #" + to_string(investments.size() + 1);
+    Investment* newInvestment = &investments.emplace(investmentName);
     newInvestment->amount = amount;
     newInvestment->returnRate = investmentReturnRate;
     newInvestment->duration = duration;
     newInvestment->turnsRemaining = duration;
     newInvestment->isActive = true;
 
-    // Add the investment
-    investments[numInvestments++] = newInvestment;
-
     // Remove gold from treasury
     treasury->spend(amount);
 
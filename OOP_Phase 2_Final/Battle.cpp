@@ -0,0 +1,462 @@
+#include "StrongHold.h"
+#include <string>
+#include <cstring>
+#include <cmath>
+
+using namespace std;
+
+// Scales unit attack to a share of the enemy killed per tick
+static const float DAMAGE_PER_ATTACK = 0.05f;
+// Speed that doubles a unit's charge and halves its exposure
+static const float SPEED_SCALE = 20.0f;
+// Units below this morale have routed: they take losses but deal none
+static const float ROUT_MORALE = 25.0f;
+// A side whose fighting troops fall below this share of its start breaks
+static const float BREAK_FRACTION = 0.25f;
+
+// Attack and defense multipliers of each CombatStrategy, and how exposed
+// its units are
+static const float strategyAttack[4] = { 1.2f, 0.85f, 1.0f, 0.9f };
+static const float strategyDefense[4] = { 0.85f, 1.2f, 1.0f, 1.0f };
+static const float strategyExposure[4] = { 1.0f, 1.0f, 1.0f, 0.7f };
+
+// Sum of a column in eight independent lanes, so the loop vectorizes
+// without reordering a single running total
+static float sumColumn(const float* values, int count) {
+    float lanes[8] = {};
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        for (int lane = 0; lane < 8; lane++) {
+            lanes[lane] += values[i + lane];
+        }
+    }
+
+    float total = 0.0f;
+    for (; i < count; i++) {
+        total += values[i];
+    }
+    for (int lane = 0; lane < 8; lane++) {
+        total += lanes[lane];
+    }
+    return total;
+}
+
+// Share of an army's troops left when its losses have cost enough morale to
+// rout it, and never less than the share at which simulate() breaks a side
+static double aggregateBreakShare(const Army& army) {
+    double moraleLossRate = 100.0 / (50 + max(0, army.getDiscipline()));
+    double lossShare = (army.getOverallMorale() - ROUT_MORALE) / (moraleLossRate * 100.0);
+    return min(1.0, max(static_cast<double>(BREAK_FRACTION), 1.0 - lossShare));
+}
+
+// Constructor; the weather is read now and need not outlive the battle
+Battle::Battle(TerrainType terrain, const Weather* weather)
+    : terrain(terrain), speedModifier(1.0f), moraleModifier(0), maxTicks(200), defenderScale(1.0f) {
+
+    for (BattleSide& side : sides) {
+        side.troops = side.morale = side.attack = side.chargeAttack = nullptr;
+        side.defense = side.exposure = side.startTroops = side.startMorale = side.scratch = nullptr;
+        side.numUnits = 0;
+        side.capacity = 0;
+        side.moraleLossRate = 1.0f;
+        side.startTotal = 0.0f;
+    }
+
+    // Mud and snow take away the edge of fast units
+    if (weather) {
+        speedModifier = max(0.2f, 1.0f + weather->getMovementEffect() / 100.0f);
+        moraleModifier = weather->getMoraleEffect();
+    }
+}
+
+// Destructor
+Battle::~Battle() {
+    for (BattleSide& side : sides) {
+        delete[] side.troops;
+        delete[] side.morale;
+        delete[] side.attack;
+        delete[] side.chargeAttack;
+        delete[] side.defense;
+        delete[] side.exposure;
+        delete[] side.startTroops;
+        delete[] side.startMorale;
+        delete[] side.scratch;
+    }
+}
+
+TerrainType Battle::getTerrain() const {
+    return terrain;
+}
+
+int Battle::getMaxTicks() const {
+    return maxTicks;
+}
+
+void Battle::setMaxTicks(int ticks) {
+    if (ticks < 1) {
+        throw invalid_argument("A battle needs at least one tick");
+    }
+    maxTicks = ticks;
+}
+
+float Battle::getDefenderScale() const {
+    return defenderScale;
+}
+
+// Fight later simulations against a defender with this many times its
+// troops, e.g. to sample an enemy whose size is only estimated
+void Battle::setDefenderScale(float scale) {
+    if (scale <= 0.0f) {
+        throw invalid_argument("Defender scale must be positive");
+    }
+    defenderScale = scale;
+}
+
+// Make room for a number of units; the columns' contents are not kept
+void Battle::reserveSide(BattleSide& side, int numUnits) {
+    if (numUnits > side.capacity) {
+        float** columns[] = { &side.troops, &side.morale, &side.attack, &side.chargeAttack, &side.defense,
+            &side.exposure, &side.startTroops, &side.startMorale, &side.scratch };
+        for (float** column : columns) {
+            delete[] *column;
+            *column = new float[numUnits];
+        }
+        side.capacity = numUnits;
+    }
+    side.numUnits = numUnits;
+}
+
+// Copy an army's units into a side, with every modifier folded into the
+// per-soldier numbers
+void Battle::loadSide(BattleSide& side, const Army& army) {
+    int numUnits = army.getNumUnits();
+    reserveSide(side, numUnits);
+
+    CombatStrategy strategy = army.getStrategy();
+    side.moraleLossRate = 100.0f / (50 + max(0, army.getDiscipline()));
+
+    const UnitArchetype* archetypes = UnitCatalog::getArchetypes();
+    for (int i = 0; i < numUnits; i++) {
+        const MilitaryUnit& unit = *army.getUnit(i);
+        const UnitArchetype& archetype = archetypes[unit.archetypeId];
+
+        float veteranBonus = unit.isVeteran ? 1.2f : 1.0f;
+        float training = 0.75f + unit.trainingLevel / 200.0f;
+        float speed = archetype.speed * speedModifier / SPEED_SCALE;
+
+        side.attack[i] = max(0, archetype.attack + unit.attackBonus) * DAMAGE_PER_ATTACK
+            * static_cast<float>(unit.calculateTerrainModifier(terrain))
+            * strategyAttack[strategy] * training * veteranBonus;
+        side.chargeAttack[i] = side.attack[i] * (1.0f + speed);
+        side.defense[i] = max(1.0f, (archetype.defense + unit.defenseBonus) * strategyDefense[strategy] * veteranBonus);
+        side.exposure[i] = strategyExposure[strategy] / (1.0f + speed);
+        side.startTroops[i] = unit.isActive ? static_cast<float>(unit.count) : 0.0f;
+        side.startMorale[i] = static_cast<float>(min(100, max(0, unit.morale + moraleModifier)));
+    }
+    side.startTotal = sumColumn(side.startTroops, numUnits);
+}
+
+// Set up a battle between two armies. The armies are not changed until
+// applyResult, and simulate() starts again from them every time.
+void Battle::setArmies(const Army& attacker, const Army& defender) {
+    loadSide(sides[0], attacker);
+    loadSide(sides[1], defender);
+}
+
+// Take over the armies, terrain and weather another battle was set up
+// with, e.g. to simulate it on another thread. The armies are not read.
+void Battle::copySetup(const Battle& other) {
+    terrain = other.terrain;
+    speedModifier = other.speedModifier;
+    moraleModifier = other.moraleModifier;
+    maxTicks = other.maxTicks;
+    defenderScale = other.defenderScale;
+
+    for (int s = 0; s < 2; s++) {
+        const BattleSide& source = other.sides[s];
+        BattleSide& side = sides[s];
+        reserveSide(side, source.numUnits);
+
+        size_t numBytes = sizeof(float) * source.numUnits;
+        if (numBytes > 0) {
+            memcpy(side.attack, source.attack, numBytes);
+            memcpy(side.chargeAttack, source.chargeAttack, numBytes);
+            memcpy(side.defense, source.defense, numBytes);
+            memcpy(side.exposure, source.exposure, numBytes);
+            memcpy(side.startTroops, source.startTroops, numBytes);
+            memcpy(side.startMorale, source.startMorale, numBytes);
+        }
+        side.moraleLossRate = source.moraleLossRate;
+        side.startTotal = source.startTotal;
+    }
+}
+
+void Battle::resetSides() {
+    for (int s = 0; s < 2; s++) {
+        BattleSide& side = sides[s];
+        float scale = (s == 1) ? defenderScale : 1.0f;
+        for (int i = 0; i < side.numUnits; i++) {
+            side.troops[i] = side.startTroops[i] * scale;
+            side.morale[i] = side.startMorale[i];
+        }
+    }
+}
+
+// Damage a side deals this tick; routed units deal none
+float Battle::dealDamage(const BattleSide& side, bool isFirstTick) {
+    const float* attack = isFirstTick ? side.chargeAttack : side.attack;
+    for (int i = 0; i < side.numUnits; i++) {
+        float fighting = side.morale[i] >= ROUT_MORALE ? 1.0f : 0.0f;
+        side.scratch[i] = side.troops[i] * attack[i] * side.morale[i] * 0.01f * fighting;
+    }
+    return sumColumn(side.scratch, side.numUnits);
+}
+
+// Spread damage over a side's units by their exposure and kill what their
+// defense cannot absorb. Losses cost morale. Returns the troops still
+// fighting.
+float Battle::takeDamage(BattleSide& side, float damage) {
+    for (int i = 0; i < side.numUnits; i++) {
+        side.scratch[i] = side.troops[i] * side.exposure[i];
+    }
+    float totalExposure = sumColumn(side.scratch, side.numUnits);
+
+    if (totalExposure > 0.0f) {
+        float damagePerExposure = damage / totalExposure;
+        for (int i = 0; i < side.numUnits; i++) {
+            float troops = side.troops[i];
+            float lost = min(troops, side.scratch[i] * damagePerExposure / side.defense[i]);
+            float lostPercent = lost * 100.0f / (troops + 1.0f);
+            float morale = max(0.0f, side.morale[i] - lostPercent * side.moraleLossRate);
+            side.troops[i] = troops - lost;
+            side.morale[i] = morale;
+            side.scratch[i] = morale >= ROUT_MORALE ? troops - lost : 0.0f;
+        }
+    }
+    else {
+        for (int i = 0; i < side.numUnits; i++) {
+            side.scratch[i] = side.morale[i] >= ROUT_MORALE ? side.troops[i] : 0.0f;
+        }
+    }
+    return sumColumn(side.scratch, side.numUnits);
+}
+
+float Battle::sumTroops(const BattleSide& side) const {
+    return sumColumn(side.troops, side.numUnits);
+}
+
+// Fight the battle set up by setArmies, tick by tick, until a side breaks
+// or maxTicks pass; a defender still standing then holds the field. Each
+// tick draws two random numbers from the calling thread's generator.
+BattleOutcome Battle::simulate() {
+    resetSides();
+
+    BattleSide& attacker = sides[0];
+    BattleSide& defender = sides[1];
+    float attackerStart = attacker.startTotal;
+    float defenderStart = defender.startTotal * defenderScale;
+    bool isAttackerBroken = attackerStart <= 0.0f;
+    bool isDefenderBroken = defenderStart <= 0.0f;
+
+    int tick = 0;
+    while (tick < maxTicks && !isAttackerBroken && !isDefenderBroken) {
+        // Both sides strike at once
+        float attackerDamage = dealDamage(attacker, tick == 0) * static_cast<float>(randomDouble(0.85, 1.15));
+        float defenderDamage = dealDamage(defender, tick == 0) * static_cast<float>(randomDouble(0.85, 1.15));
+
+        float attackerFighting = takeDamage(attacker, defenderDamage);
+        float defenderFighting = takeDamage(defender, attackerDamage);
+        isAttackerBroken = attackerFighting < attackerStart * BREAK_FRACTION;
+        isDefenderBroken = defenderFighting < defenderStart * BREAK_FRACTION;
+        tick++;
+    }
+
+    float attackerRemaining = sumTroops(attacker);
+    float defenderRemaining = sumTroops(defender);
+
+    BattleOutcome outcome;
+    outcome.numTicks = tick;
+    if (isAttackerBroken && isDefenderBroken) {
+        // Both broke in the same tick; the side that kept more of itself wins
+        outcome.isAttackerVictory = attackerRemaining * defenderStart > defenderRemaining * attackerStart;
+    }
+    else {
+        outcome.isAttackerVictory = isDefenderBroken;
+    }
+    outcome.attackerSurvivors = static_cast<int>(attackerRemaining + 0.5f);
+    outcome.defenderSurvivors = static_cast<int>(defenderRemaining + 0.5f);
+    outcome.attackerCasualties = static_cast<int>(attackerStart + 0.5f) - outcome.attackerSurvivors;
+    outcome.defenderCasualties = static_cast<int>(defenderStart + 0.5f) - outcome.defenderSurvivors;
+    return outcome;
+}
+
+// Write the losses and morale of the last simulate() back to the armies it
+// was set up from. Survivors gain experience.
+void Battle::applyResult(const BattleOutcome& outcome, Army& attacker, Army& defender) const {
+    Army* armies[2] = { &attacker, &defender };
+
+    for (int s = 0; s < 2; s++) {
+        const BattleSide& side = sides[s];
+        Army& army = *armies[s];
+        if (army.getNumUnits() != side.numUnits) {
+            throw logic_error("Army has changed since the battle was set up");
+        }
+
+        for (int i = 0; i < side.numUnits; i++) {
+            MilitaryUnit& unit = army.units[i];
+            if (!unit.isActive) {
+                continue;
+            }
+
+            army.removeFromTotals(unit);
+            unit.count = min(unit.count, static_cast<int>(side.troops[i] + 0.5f));
+            unit.morale = static_cast<unsigned char>(min(100, max(10, static_cast<int>(side.morale[i] - moraleModifier))));
+            if (unit.count > 0) {
+                unit.gainExperience(1 + outcome.numTicks / 10);
+            }
+            army.addToTotals(unit);
+        }
+
+        bool isVictory = (s == 0) == outcome.isAttackerVictory;
+        army.setLastBattleResult(isVictory ? 1 : -1);
+        army.calculateTotalStrength();
+        army.calculateOverallMorale();
+        army.calculateFoodConsumption();
+    }
+}
+
+// Set up, fight and apply a battle in one go. The aggregate fidelity
+// neither sets up the battle nor draws random numbers.
+BattleOutcome Battle::fight(Army& attacker, Army& defender, BattleFidelity fidelity) {
+    if (fidelity == FIDELITY_AGGREGATE) {
+        BattleOutcome outcome = resolveAggregate(attacker, defender);
+        applyAggregateResult(outcome, attacker, true);
+        applyAggregateResult(outcome, defender, false);
+        return outcome;
+    }
+
+    setArmies(attacker, defender);
+    BattleOutcome outcome = simulate();
+    applyResult(outcome, attacker, defender);
+    return outcome;
+}
+
+// Outcome of a battle from Lanchester's equations, in O(unit types). Each
+// side kills the other at a rate set by its attack power per soldier, with
+// the terrain modifiers of its archetypes weighted by strength, against the
+// enemy's defense power per soldier. Massed battles on open ground follow
+// the square law, where numbers count twice; forest, mountain and swamp
+// fighting, or a guerrilla side, break the battle into small fights that
+// follow the linear law. The loser breaks once its losses would rout it.
+// Weather is ignored, as it hurts both sides alike, and
+// numTicks is 0.
+BattleOutcome Battle::resolveAggregate(const Army& attacker, const Army& defender) const {
+    const Army* armies[2] = { &attacker, &defender };
+    const UnitArchetype* archetypes = UnitCatalog::getArchetypes();
+    int numArchetypes = UnitCatalog::getNumArchetypes();
+    int* soldiers = new int[numArchetypes];
+    int* strengths = new int[numArchetypes];
+
+    double troops[2];
+    double attackPerSoldier[2];
+    double defensePerSoldier[2];
+    bool isDispersed = terrain == FOREST || terrain == MOUNTAINS || terrain == SWAMP;
+
+    for (int s = 0; s < 2; s++) {
+        const Army& army = *armies[s];
+        army.calculateArchetypeTotals(soldiers, strengths);
+
+        double count = 0.0;
+        double strength = 0.0;
+        double terrainStrength = 0.0;
+        for (int i = 0; i < numArchetypes; i++) {
+            count += soldiers[i];
+            strength += strengths[i];
+            terrainStrength += strengths[i] * MilitaryUnit::calculateTerrainModifier(archetypes[i].speed, terrain);
+        }
+        double terrainModifier = strength > 0.0 ? terrainStrength / strength : 1.0;
+
+        troops[s] = count;
+        attackPerSoldier[s] = count > 0.0 ? army.calculateAttackPower() * terrainModifier / count : 0.0;
+        defensePerSoldier[s] = count > 0.0 ? army.calculateDefensePower() / count : 1.0;
+        if (army.getStrategy() == GUERRILLA) {
+            isDispersed = true;
+        }
+    }
+    delete[] soldiers;
+    delete[] strengths;
+    troops[1] *= defenderScale;
+
+    // Soldiers each side kills per soldier of its own per unit of time
+    double killRate[2] = {
+        attackPerSoldier[0] / defensePerSoldier[1],
+        attackPerSoldier[1] / defensePerSoldier[0]
+    };
+
+    // Fighting strength; the stronger side wins and a tie holds the field
+    double fightingStrength[2];
+    for (int s = 0; s < 2; s++) {
+        fightingStrength[s] = killRate[s] * (isDispersed ? troops[s] : troops[s] * troops[s]);
+    }
+    bool isAttackerVictory = troops[1] <= 0.0 || (troops[0] > 0.0 && fightingStrength[0] > fightingStrength[1]);
+
+    int winner = isAttackerVictory ? 0 : 1;
+    int loser = 1 - winner;
+    double remaining[2];
+    remaining[loser] = troops[loser] * aggregateBreakShare(*armies[loser]);
+
+    // Both laws keep a quantity constant as the armies shrink; the winner's
+    // survivors follow from the loser's losses
+    if (killRate[winner] <= 0.0) {
+        remaining[winner] = troops[winner];
+    }
+    else if (isDispersed) {
+        double loss = killRate[loser] / killRate[winner] * (troops[loser] - remaining[loser]);
+        remaining[winner] = max(0.0, troops[winner] - loss);
+    }
+    else {
+        double loss = killRate[loser] / killRate[winner]
+            * (troops[loser] * troops[loser] - remaining[loser] * remaining[loser]);
+        remaining[winner] = sqrt(max(0.0, troops[winner] * troops[winner] - loss));
+    }
+
+    BattleOutcome outcome;
+    outcome.isAttackerVictory = isAttackerVictory;
+    outcome.numTicks = 0;
+    outcome.attackerSurvivors = static_cast<int>(remaining[0] + 0.5);
+    outcome.defenderSurvivors = static_cast<int>(remaining[1] + 0.5);
+    outcome.attackerCasualties = static_cast<int>(troops[0] + 0.5) - outcome.attackerSurvivors;
+    outcome.defenderCasualties = static_cast<int>(troops[1] + 0.5) - outcome.defenderSurvivors;
+    return outcome;
+}
+
+// Spread an aggregate outcome's losses over an army's active units in
+// proportion to their size
+void Battle::applyAggregateResult(const BattleOutcome& outcome, Army& army, bool isAttacker) {
+    int casualties = isAttacker ? outcome.attackerCasualties : outcome.defenderCasualties;
+    int survivors = isAttacker ? outcome.attackerSurvivors : outcome.defenderSurvivors;
+    int total = casualties + survivors;
+
+    if (total > 0) {
+        double keepShare = static_cast<double>(survivors) / total;
+        for (int i = 0; i < army.getNumUnits(); i++) {
+            MilitaryUnit& unit = army.units[i];
+            if (!unit.isActive) {
+                continue;
+            }
+            army.removeFromTotals(unit);
+            unit.count = min(unit.count, static_cast<int>(unit.count * keepShare + 0.5));
+            if (unit.count > 0) {
+                unit.gainExperience(1);
+            }
+            army.addToTotals(unit);
+        }
+    }
+
+    bool isVictory = isAttacker == outcome.isAttackerVictory;
+    army.setLastBattleResult(isVictory ? 1 : -1);
+    army.adjustMorale(isVictory ? 10 : -15);
+    army.calculateTotalStrength();
+    army.calculateOverallMorale();
+    army.calculateFoodConsumption();
+}
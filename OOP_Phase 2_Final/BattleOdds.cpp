@@ -0,0 +1,253 @@
+#include "StrongHold.h"
+#include <string>
+#include <chrono>
+#include <cmath>
+
+using namespace std;
+
+// z for a two-sided 95% confidence interval
+static const double CONFIDENCE_Z = 1.96;
+
+// Running sums of one thread's simulations
+struct OddsTally
+{
+    long long numSimulations;
+    long long numWins;
+    double attackerCasualties;
+    double attackerCasualtiesSquared;
+    double defenderCasualties;
+    double defenderCasualtiesSquared;
+};
+
+// Fold a value into an FNV-1a hash
+static unsigned long long hashValue(unsigned long long hash, long long value) {
+    for (int i = 0; i < 8; i++) {
+        hash ^= static_cast<unsigned long long>(value >> (i * 8)) & 0xff;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+// Keep the top six bits of a count and its scale, so counts within about
+// 3% of each other share a key
+static long long quantizeCount(int count) {
+    int scale = 0;
+    while (count >= 64) {
+        count >>= 1;
+        scale++;
+    }
+    return (static_cast<long long>(scale) << 8) | count;
+}
+
+// Half-width of the confidence interval of a mean
+static double meanMargin(double sum, double sumOfSquares, long long count) {
+    if (count < 2) {
+        return 0.0;
+    }
+    double mean = sum / count;
+    double variance = max(0.0, (sumOfSquares - sum * mean) / (count - 1));
+    return CONFIDENCE_Z * sqrt(variance / count);
+}
+
+// Half-width of the Wilson interval of a proportion, which unlike the
+// normal approximation does not shrink to nothing at 0% or 100%
+static double proportionMargin(double proportion, long long count) {
+    double zSquared = CONFIDENCE_Z * CONFIDENCE_Z;
+    double spread = proportion * (1.0 - proportion) / count + zSquared / (4.0 * count * count);
+    return CONFIDENCE_Z * sqrt(spread) / (1.0 + zSquared / count);
+}
+
+// Constructor
+BattleOdds::BattleOdds(int numThreads)
+    : numThreads(max(1, numThreads)), threadPool(nullptr), workerBattles(nullptr),
+    timeBudgetMilliseconds(50.0), maxSimulations(5000),
+    cacheKeys(nullptr), cachedEstimates(nullptr), numCached(0), maxCached(0) {
+
+    if (this->numThreads > 1) {
+        threadPool = new ThreadPool(this->numThreads);
+    }
+    workerBattles = new Battle*[this->numThreads];
+    for (int i = 0; i < this->numThreads; i++) {
+        workerBattles[i] = new Battle();
+    }
+}
+
+// Destructor
+BattleOdds::~BattleOdds() {
+    for (int i = 0; i < numThreads; i++) {
+        delete workerBattles[i];
+    }
+    delete[] workerBattles;
+    delete threadPool;
+    delete[] cacheKeys;
+    delete[] cachedEstimates;
+}
+
+int BattleOdds::getNumThreads() const {
+    return numThreads;
+}
+
+double BattleOdds::getTimeBudget() const {
+    return timeBudgetMilliseconds;
+}
+
+void BattleOdds::setTimeBudget(double milliseconds) {
+    if (milliseconds <= 0.0) {
+        throw invalid_argument("Time budget must be positive");
+    }
+    timeBudgetMilliseconds = milliseconds;
+}
+
+int BattleOdds::getMaxSimulations() const {
+    return maxSimulations;
+}
+
+void BattleOdds::setMaxSimulations(int count) {
+    if (count < 1) {
+        throw invalid_argument("At least one simulation is needed");
+    }
+    maxSimulations = count;
+}
+
+int BattleOdds::getNumCached() const {
+    return numCached;
+}
+
+// Forget every estimate, e.g. when a new turn starts
+void BattleOdds::clearCache() {
+    numCached = 0;
+}
+
+// Fold everything about an army that a battle reads into a hash
+unsigned long long BattleOdds::hashArmy(unsigned long long hash, const Army& army) {
+    hash = hashValue(hash, army.getStrategy());
+    hash = hashValue(hash, army.getDiscipline() / 5);
+    hash = hashValue(hash, army.getNumUnits());
+
+    for (int i = 0; i < army.getNumUnits(); i++) {
+        const MilitaryUnit& unit = *army.getUnit(i);
+        hash = hashValue(hash, unit.getArchetypeId());
+        hash = hashValue(hash, unit.getIsActive() ? quantizeCount(unit.getCount()) : -1);
+        hash = hashValue(hash, unit.getAttack());
+        hash = hashValue(hash, unit.getDefense());
+        hash = hashValue(hash, unit.getMorale() / 5);
+        hash = hashValue(hash, unit.getTrainingLevel() / 10);
+        hash = hashValue(hash, unit.getIsVeteran());
+    }
+    return hash;
+}
+
+// Key under which the odds of a battle are cached
+unsigned long long BattleOdds::makeKey(const Army& attacker, const Army& defender, TerrainType terrain,
+    const Weather* weather, double defenderSizeError) {
+    unsigned long long hash = 14695981039346656037ULL;
+    hash = hashArmy(hash, attacker);
+    hash = hashArmy(hash, defender);
+    hash = hashValue(hash, terrain);
+    hash = hashValue(hash, weather ? weather->getMovementEffect() : 0);
+    hash = hashValue(hash, weather ? weather->getMoraleEffect() : 0);
+    hash = hashValue(hash, static_cast<long long>(defenderSizeError * 1000.0 + 0.5));
+    return hash;
+}
+
+// Odds of the attacker beating the defender. With a size error e, each
+// simulation fights a defender scaled by a random factor in [1-e, 1+e].
+// Each thread simulates its share of maxSimulations on its own copy of the
+// battle, stopping early when the time budget runs out. One seed is drawn
+// from the calling thread's generator, so the game's random state moves on
+// the same way however many simulations were run.
+BattleOddsEstimate BattleOdds::estimate(const Army& attacker, const Army& defender, TerrainType terrain,
+    const Weather* weather, double defenderSizeError) {
+    if (defenderSizeError < 0.0 || defenderSizeError >= 1.0) {
+        throw invalid_argument("Defender size error must be in [0, 1)");
+    }
+
+    unsigned long long key = makeKey(attacker, defender, terrain, weather, defenderSizeError);
+    for (int i = 0; i < numCached; i++) {
+        if (cacheKeys[i] == key) {
+            BattleOddsEstimate cachedEstimate = cachedEstimates[i];
+            cachedEstimate.isCached = true;
+            return cachedEstimate;
+        }
+    }
+
+    auto start = chrono::steady_clock::now();
+    auto deadline = start + chrono::duration_cast<chrono::steady_clock::duration>(
+        chrono::duration<double, milli>(timeBudgetMilliseconds));
+    unsigned long long seed = randomSeed();
+
+    // Read the armies once; the threads copy the columns
+    Battle battle(terrain, weather);
+    battle.setArmies(attacker, defender);
+
+    OddsTally* tallies = new OddsTally[numThreads]();
+    auto simulateShare = [&](int worker) {
+        RandomGenerator workerGenerator(seed, worker);
+        RandomStreamScope randomScope(&workerGenerator);
+
+        Battle& workerBattle = *workerBattles[worker];
+        workerBattle.copySetup(battle);
+
+        OddsTally& tally = tallies[worker];
+        int share = maxSimulations / numThreads + (worker < maxSimulations % numThreads ? 1 : 0);
+        while (tally.numSimulations < share) {
+            // Every thread runs at least one simulation
+            if (tally.numSimulations > 0 && chrono::steady_clock::now() >= deadline) {
+                break;
+            }
+
+            if (defenderSizeError > 0.0) {
+                workerBattle.setDefenderScale(static_cast<float>(randomDouble(1.0 - defenderSizeError, 1.0 + defenderSizeError)));
+            }
+            BattleOutcome outcome = workerBattle.simulate();
+            tally.numSimulations++;
+            tally.numWins += outcome.isAttackerVictory ? 1 : 0;
+            tally.attackerCasualties += outcome.attackerCasualties;
+            tally.attackerCasualtiesSquared += static_cast<double>(outcome.attackerCasualties) * outcome.attackerCasualties;
+            tally.defenderCasualties += outcome.defenderCasualties;
+            tally.defenderCasualtiesSquared += static_cast<double>(outcome.defenderCasualties) * outcome.defenderCasualties;
+        }
+    };
+
+    if (threadPool) {
+        threadPool->parallelFor(numThreads, simulateShare);
+    }
+    else {
+        simulateShare(0);
+    }
+
+    // Combine the threads' tallies in thread order
+    OddsTally total = {};
+    for (int i = 0; i < numThreads; i++) {
+        total.numSimulations += tallies[i].numSimulations;
+        total.numWins += tallies[i].numWins;
+        total.attackerCasualties += tallies[i].attackerCasualties;
+        total.attackerCasualtiesSquared += tallies[i].attackerCasualtiesSquared;
+        total.defenderCasualties += tallies[i].defenderCasualties;
+        total.defenderCasualtiesSquared += tallies[i].defenderCasualtiesSquared;
+    }
+    delete[] tallies;
+
+    long long count = total.numSimulations;
+    BattleOddsEstimate result;
+    result.numSimulations = static_cast<int>(count);
+    result.winProbability = static_cast<double>(total.numWins) / count;
+    result.winProbabilityMargin = proportionMargin(result.winProbability, count);
+    result.expectedAttackerCasualties = total.attackerCasualties / count;
+    result.attackerCasualtiesMargin = meanMargin(total.attackerCasualties, total.attackerCasualtiesSquared, count);
+    result.expectedDefenderCasualties = total.defenderCasualties / count;
+    result.defenderCasualtiesMargin = meanMargin(total.defenderCasualties, total.defenderCasualtiesSquared, count);
+    result.elapsedMilliseconds = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+
+    if (numCached >= maxCached) {
+        int newMaxCached = max(16, maxCached * 2);
+        growArray(cacheKeys, numCached, newMaxCached);
+        growArray(cachedEstimates, numCached, newMaxCached);
+        maxCached = newMaxCached;
+    }
+    cacheKeys[numCached] = key;
+    cachedEstimates[numCached] = result;
+    numCached++;
+
+    return result;
+}
@@ -0,0 +1,334 @@
+#include "StrongHold.h"
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <string>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+using namespace std;
+
+// Every heap allocation made by the program is counted here
+static unsigned long long allocationCount = 0;
+
+void* operator new(size_t size) {
+    allocationCount++;
+    void* memory = malloc(size ? size : 1);
+    if (!memory) {
+        throw bad_alloc();
+    }
+    return memory;
+}
+
+void* operator new[](size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void* memory) noexcept {
+    free(memory);
+}
+
+void operator delete[](void* memory) noexcept {
+    free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept {
+    free(memory);
+}
+
+void operator delete[](void* memory, size_t) noexcept {
+    free(memory);
+}
+
+// Minimum measured time per benchmark
+const double BENCHMARK_SECONDS = 0.25;
+
+// Keeps benchmarked results alive so the optimizer cannot drop them
+static volatile long long benchmarkSink = 0;
+
+// Two armies and the battle they fight, for the aggregate resolver
+struct BattleArmies
+{
+    Battle battle;
+    Army attacker;
+    Army defender;
+
+    BattleArmies() : battle(FOREST), attacker("Attacking Army"), defender("Defending Army") {
+    }
+};
+
+// Function prototypes
+template <class Fixture>
+void runBenchmark(const string& name, const string& filter, int opsPerFixture,
+    const function<Fixture* ()>& create, const function<void(Fixture*)>& operation);
+Population* createPopulation(int numClasses);
+Economy* createEconomy();
+Army* createArmy();
+Army* createLargeArmy();
+Bank* createBank();
+Battle* createLargeBattle();
+BattleArmies* createLargeBattleArmies();
+Kingdom* createKingdom();
+void writeWorldSave(const char* filename);
+
+int main(int argc, char* argv[]) {
+    string filter = (argc > 1) ? argv[1] : "";
+
+    if (filter == "--help" || filter == "-h") {
+        cout << "Usage: " << argv[0] << " [FILTER]" << endl;
+        cout << "Runs the simulation core benchmarks whose name contains FILTER" << endl;
+        cout << "and reports nanoseconds and heap allocations per operation." << endl;
+        return 0;
+    }
+
+    // Benchmarks measure the simulation, not its messages
+    SimulationLog::setLevel(LOG_NONE);
+    setMasterSeed(12345);
+
+    // Random draws come from a bound generator, as they do during a turn
+    RandomGenerator benchmarkGenerator(12345, 0);
+    RandomStreamScope randomScope(&benchmarkGenerator);
+
+    cout << left << setw(46) << "Benchmark" << right << setw(14) << "ns/op"
+        << setw(14) << "allocs/op" << setw(14) << "ops" << endl;
+
+    runBenchmark<RandomGenerator>("randomInt", filter, 1000000,
+        [] { return new RandomGenerator(1, 0); },
+        [](RandomGenerator*) { benchmarkSink += randomInt(1, 100); });
+
+    runBenchmark<Population>("Population::update (64 classes)", filter, 100,
+        [] { return createPopulation(64); },
+        [](Population* population) { population->update(1000000); });
+
+    runBenchmark<Population>("Population::update (4096 classes)", filter, 100,
+        [] { return createPopulation(4096); },
+        [](Population* population) { population->update(1000000); });
+
+    runBenchmark<Economy>("Economy::update (32 resources, 32 routes)", filter, 100,
+        createEconomy,
+        [](Economy* economy) { economy->update(); });
+
+    runBenchmark<Army>("Army::calculateTotalStrength (10000 units)", filter, 10000,
+        createArmy,
+        [](Army* army) { army->calculateTotalStrength(); benchmarkSink += army->getTotalStrength(); });
+
+    runBenchmark<Army>("Army::calculateTotalStrength (1000000 units)", filter, 10000000,
+        createLargeArmy,
+        [](Army* army) { army->calculateTotalStrength(); benchmarkSink += army->getTotalStrength(); });
+
+    runBenchmark<Army>("Army::update (1000000 units)", filter, 10,
+        createLargeArmy,
+        [](Army* army) { army->update(); });
+
+    runBenchmark<Army>("Army::calculateAttackPower (10000 units)", filter, 10000000,
+        createArmy,
+        [](Army* army) { benchmarkSink += army->calculateAttackPower(); });
+
+    runBenchmark<Battle>("Battle::simulate (2 x 50000 units)", filter, 10,
+        createLargeBattle,
+        [](Battle* battle) { benchmarkSink += battle->simulate().defenderCasualties; });
+
+    runBenchmark<BattleArmies>("Battle::resolveAggregate (2 x 50000 units)", filter, 100,
+        createLargeBattleArmies,
+        [](BattleArmies* armies) {
+            benchmarkSink += armies->battle.resolveAggregate(armies->attacker, armies->defender).defenderCasualties;
+        });
+
+    runBenchmark<Bank>("Bank::update (1000 loans)", filter, 100,
+        createBank,
+        [](Bank* bank) { bank->update(); });
+
+    runBenchmark<Arena>("Event::generateRandomEvent (arena)", filter, 10000,
+        [] { return new Arena(); },
+        [](Arena* arena) { Event* event = Event::generateRandomEvent(arena); benchmarkSink += event->getDuration(); destroyIn(arena, event); });
+
+    runBenchmark<Kingdom>("Kingdom::save/load round trip", filter, 100,
+        createKingdom,
+        [](Kingdom* kingdom) {
+            const char* filename = "stronghold_bench_kingdom.txt";
+            {
+                ofstream saveFile(filename);
+                kingdom->save(saveFile);
+            }
+            {
+                ifstream loadFile(filename);
+                Kingdom loadedKingdom("", false);
+                loadedKingdom.load(loadFile);
+                benchmarkSink += loadedKingdom.getTurn();
+            }
+        });
+    remove("stronghold_bench_kingdom.txt");
+
+    runBenchmark<Kingdom>("Kingdom binary save/load round trip", filter, 100,
+        createKingdom,
+        [](Kingdom* kingdom) {
+            const char* filename = "stronghold_bench_kingdom.shb";
+            {
+                SaveWriter writer;
+                writer.beginSection(SECTION_KINGDOM);
+                kingdom->saveBinary(writer);
+                writer.endSection();
+                writer.writeToFile(filename);
+            }
+            {
+                SaveReader reader(filename);
+                Kingdom loadedKingdom("", false);
+                reader.openSection(0);
+                loadedKingdom.loadBinary(reader);
+                benchmarkSink += loadedKingdom.getTurn();
+            }
+        });
+    remove("stronghold_bench_kingdom.shb");
+
+    // Time until a saved world of many kingdoms can be played
+    const char* worldFilename = "stronghold_bench_world.shb";
+    writeWorldSave(worldFilename);
+    runBenchmark<GameEngine>("GameEngine binary load (2000 kingdoms)", filter, 1,
+        []() { return new GameEngine(); },
+        [worldFilename](GameEngine* engine) {
+            engine->loadGameBinary(worldFilename);
+            benchmarkSink += engine->getPlayerKingdom()->getTurn();
+        });
+    runBenchmark<GameEngine>("GameEngine lazy binary load (2000 kingdoms)", filter, 1,
+        []() {
+            GameEngine* engine = new GameEngine();
+            engine->setLazyLoading(true);
+            return engine;
+        },
+        [worldFilename](GameEngine* engine) {
+            engine->loadGameBinary(worldFilename);
+            benchmarkSink += engine->getPlayerKingdom()->getTurn();
+        });
+    remove(worldFilename);
+
+    return 0;
+}
+
+// Run the operation on fresh fixtures until the time budget is used up.
+// Fixture setup and teardown are not measured.
+template <class Fixture>
+void runBenchmark(const string& name, const string& filter, int opsPerFixture,
+    const function<Fixture* ()>& create, const function<void(Fixture*)>& operation) {
+    if (!filter.empty() && name.find(filter) == string::npos) {
+        return;
+    }
+
+    double measuredSeconds = 0.0;
+    unsigned long long measuredAllocations = 0;
+    long long totalOps = 0;
+
+    while (measuredSeconds < BENCHMARK_SECONDS) {
+        Fixture* fixture = create();
+
+        unsigned long long allocationsBefore = allocationCount;
+        auto start = chrono::steady_clock::now();
+        for (int i = 0; i < opsPerFixture; i++) {
+            operation(fixture);
+        }
+        auto end = chrono::steady_clock::now();
+        measuredAllocations += allocationCount - allocationsBefore;
+
+        measuredSeconds += chrono::duration<double>(end - start).count();
+        totalOps += opsPerFixture;
+
+        delete fixture;
+    }
+
+    cout << left << setw(46) << name << right << fixed
+        << setprecision(1) << setw(14) << measuredSeconds * 1e9 / totalOps
+        << setprecision(2) << setw(14) << static_cast<double>(measuredAllocations) / totalOps
+        << setw(14) << totalOps << endl;
+}
+
+// Population split over many social classes
+Population* createPopulation(int numClasses) {
+    Population* population = new Population(0);
+    for (int i = 0; i < numClasses; i++) {
+        population->addSocialClass(new SocialClass("Class " + to_string(i + 1), 1000, 0.1));
+    }
+    population->recalculateTotalPopulation();
+    return population;
+}
+
+// Economy with many resources and foreign trade routes
+Economy* createEconomy() {
+    Economy* economy = new Economy("Benchmark Economy", new Treasury("Benchmark Treasury"));
+    for (int i = 0; i < 32; i++) {
+        ResourceType type = static_cast<ResourceType>(i % 5);
+        economy->addResource(new Resource("Resource " + to_string(i + 1), type, 100000, 10, 5));
+        economy->addTradeRoute("Foreign Kingdom " + to_string(i + 1), type, 10, static_cast<ResourceType>((i + 1) % 5), 10);
+    }
+    return economy;
+}
+
+// Army with a large number of units
+Army* createArmy() {
+    Army* army = new Army("Benchmark Army");
+    for (int i = 0; i < 10000; i++) {
+        army->addUnit(MilitaryUnit("Unit " + to_string(i + 1), 100, 10 + i % 7, 5 + i % 5, 5, 1));
+    }
+    return army;
+}
+
+// Army of a million units spread over the recruitable archetypes
+Army* createLargeArmy() {
+    Army* army = new Army("Benchmark Army");
+    army->reserveUnits(1000003);
+    for (int archetypeId = RECRUIT_INFANTRY; archetypeId <= RECRUIT_ROYAL_GUARDS; archetypeId++) {
+        const UnitArchetype& archetype = UnitCatalog::getArchetype(archetypeId);
+        army->addUnits(MilitaryUnit(archetype.name.view(), archetypeId, 10), 250000);
+    }
+    return army;
+}
+
+// Battle between two armies of 50000 units over the recruitable
+// archetypes, the defender a fifth larger
+Battle* createLargeBattle() {
+    Army attacker("Attacking Army");
+    Army defender("Defending Army");
+    for (int archetypeId = RECRUIT_INFANTRY; archetypeId <= RECRUIT_ROYAL_GUARDS; archetypeId++) {
+        const UnitArchetype& archetype = UnitCatalog::getArchetype(archetypeId);
+        attacker.addUnits(MilitaryUnit(archetype.name.view(), archetypeId, 10), 12500);
+        defender.addUnits(MilitaryUnit(archetype.name.view(), archetypeId, 12), 12500);
+    }
+
+    Battle* battle = new Battle(FOREST);
+    battle->setArmies(attacker, defender);
+    return battle;
+}
+
+// The armies of createLargeBattle, kept for battles that read them
+BattleArmies* createLargeBattleArmies() {
+    BattleArmies* armies = new BattleArmies();
+    for (int archetypeId = RECRUIT_INFANTRY; archetypeId <= RECRUIT_ROYAL_GUARDS; archetypeId++) {
+        const UnitArchetype& archetype = UnitCatalog::getArchetype(archetypeId);
+        armies->attacker.addUnits(MilitaryUnit(archetype.name.view(), archetypeId, 10), 12500);
+        armies->defender.addUnits(MilitaryUnit(archetype.name.view(), archetypeId, 12), 12500);
+    }
+    return armies;
+}
+
+// Bank holding many long-running loans
+Bank* createBank() {
+    Bank* bank = new Bank("Benchmark Bank");
+    bank->setGoldReserves(100000000);
+    bank->setLoanLimit(100000000);
+    for (int i = 0; i < 1000; i++) {
+        bank->takeLoan(100, 1000000);
+    }
+    return bank;
+}
+
+// Kingdom as set up for a new game
+Kingdom* createKingdom() {
+    return new Kingdom("Benchmark Kingdom", false);
+}
+
+// Binary save of a headless world of 2000 kingdoms
+void writeWorldSave(const char* filename) {
+    GameEngine engine;
+    engine.setupHeadlessGame(2000);
+    engine.saveGameBinary(filename);
+}
@@ -1,4 +1,4 @@
-#include "Stronghold.h"
+#include "StrongHold.h"
 #include <iostream>
 #include <fstream>
 #include <string>
@@ -157,4 +157,20 @@ void CombatUnit::load(ifstream& file) {
     file >> speed;
 
     file.ignore(); // Skip newline
+}
+
+// Save combat unit data in binary form
+void CombatUnit::saveBinary(SaveWriter& writer) const {
+    Entity::saveBinary(writer);
+    writer.writeInt(attack);
+    writer.writeInt(defense);
+    writer.writeInt(speed);
+}
+
+// Load combat unit data in binary form
+void CombatUnit::loadBinary(SaveReader& reader) {
+    Entity::loadBinary(reader);
+    attack = reader.readInt();
+    defense = reader.readInt();
+    speed = reader.readInt();
 }
\ No newline at end of file
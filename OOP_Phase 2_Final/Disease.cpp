@@ -1,4 +1,4 @@
-#include "Stronghold.h"
+#include "StrongHold.h"
 #include <iostream>
 #include <fstream>
 #include <string>
@@ -60,7 +60,7 @@ void Disease::outbreak(int initialInfected) {
     currentInfected = initialInfected;
     turnsActive = 0;
 
-    cout << "A " << name << " outbreak has begun with " << initialInfected << " initial cases!" << endl;
+    LogLine() << "A " << name << " outbreak has begun with " << initialInfected << " initial cases!";
 }
 
 // Spread the disease through the population
@@ -92,8 +92,8 @@ void Disease::spread(Population* population, Weather* currentWeather) {
         currentInfected = totalPop;
     }
 
-    cout << "The " << name << " has spread to " << newInfections << " new people. ";
-    cout << "Total infected: " << currentInfected << " (" << (currentInfected * 100 / totalPop) << "% of population)" << endl;
+    LogLine() << "The " << name << " has spread to " << newInfections << " new people. "
+        << "Total infected: " << currentInfected << " (" << (currentInfected * 100 / totalPop) << "% of population)";
 }
 
 // Calculate deaths from the disease
@@ -147,8 +147,8 @@ void Disease::applyEffects(Kingdom* kingdom) {
 
         int newPopulation = population->getTotalPopulation();
 
-        cout << "The " << name << " has claimed approximately " << (oldPopulation - newPopulation)
-            << " lives in the kingdom." << endl;
+        LogLine() << "The " << name << " has claimed approximately " << (oldPopulation - newPopulation)
+            << " lives in the kingdom.";
     }
 
     // Disease also affects economy (reduced productivity)
@@ -167,7 +167,7 @@ void Disease::applyEffects(Kingdom* kingdom) {
     // Check if disease has run its course
     if (turnsActive >= duration || currentInfected == 0) {
         setIsActive(false);
-        cout << "The " << name << " outbreak has ended." << endl;
+        LogLine() << "The " << name << " outbreak has ended.";
     }
 }
 
@@ -214,3 +214,21 @@ void Disease::load(ifstream& file) {
     file >> currentInfected;
     file.ignore(); // Skip newline
 }
+
+// Save disease data in binary form
+void Disease::saveBinary(SaveWriter& writer) const {
+    EnvironmentalEffect::saveBinary(writer);
+    writer.writeInt(static_cast<int>(type));
+    writer.writeInt(infectivity);
+    writer.writeInt(mortalityRate);
+    writer.writeInt(currentInfected);
+}
+
+// Load disease data in binary form
+void Disease::loadBinary(SaveReader& reader) {
+    EnvironmentalEffect::loadBinary(reader);
+    type = static_cast<DiseaseType>(reader.readInt());
+    infectivity = reader.readInt();
+    mortalityRate = reader.readInt();
+    currentInfected = reader.readInt();
+}
@@ -1,4 +1,4 @@
-#include "Stronghold.h"
+#include "StrongHold.h"
 #include <iostream>
 #include <fstream>
 #include <string>
@@ -8,21 +8,12 @@ using namespace std;
 // Constructor
 Economy::Economy(const string& name, Treasury* treasury)
     : Entity(name, "Kingdom economy system"), treasury(treasury), productionLevel(50), tradeLevel(50),
-    taxRate(10.0), tariffRate(5.0), marketStability(50), inflation(0.0), employmentRate(80),
-    corruptionLevel(0), maxResources(10), numResources(0), bank(nullptr),
-    tradeRoutes(nullptr), numTradeRoutes(0), maxTradeRoutes(5) {
+    taxRate(10.0), tariffRate(0.05), marketStability(50), inflation(0.0), employmentRate(80),
+    corruptionLevel(0), maxResources(0), resourcesByType(nullptr), resourceTableSize(0), bank(nullptr),
+    resourceAmounts(nullptr), resourceGatherRates(nullptr), resourceConsumptionRates(nullptr) {
 
-    // Initialize resources array
-    resources = new Resource * [maxResources];
-    for (int i = 0; i < maxResources; i++) {
-        resources[i] = nullptr;
-    }
-
-    // Initialize trade routes array
-    tradeRoutes = new TradeRoute * [maxTradeRoutes];
-    for (int i = 0; i < maxTradeRoutes; i++) {
-        tradeRoutes[i] = nullptr;
-    }
+    // Initialize resources arrays
+    reserveResources(10);
 
     // Create default resources
     addResource(new Resource("Food", FOOD, 1000, 100, 80));
@@ -41,16 +32,13 @@ Economy::Economy(const string& name, Treasury* treasury)
 // Destructor
 Economy::~Economy() {
     // Clean up resources
-    for (int i = 0; i < numResources; i++) {
+    for (int i = 0; i < resources.size(); i++) {
         delete resources[i];
     }
-    delete[] resources;
-
-    // Clean up trade routes
-    for (int i = 0; i < numTradeRoutes; i++) {
-        delete tradeRoutes[i];
-    }
-    delete[] tradeRoutes;
+    delete[] resourcesByType;
+    delete[] resourceAmounts;
+    delete[] resourceGatherRates;
+    delete[] resourceConsumptionRates;
 
     // treasury is not owned by Economy, so don't delete it here
 }
@@ -148,73 +136,116 @@ void Economy::setTariffRate(double rate) {
     tariffRate = rate;
 }
 
+// Grow the resource array and the per-resource columns together
+void Economy::reserveResources(int newMaxResources) {
+    if (newMaxResources <= maxResources) {
+        return;
+    }
+
+    resources.reserve(newMaxResources);
+    growArray(resourceAmounts, resources.size(), newMaxResources);
+    growArray(resourceGatherRates, resources.size(), newMaxResources);
+    growArray(resourceConsumptionRates, resources.size(), newMaxResources);
+
+    maxResources = newMaxResources;
+}
+
+// Point the table entry of a type at the first resource of that type
+void Economy::indexResourceType(ResourceType type) {
+    resourcesByType[type] = nullptr;
+
+    for (int i = 0; i < resources.size(); i++) {
+        if (resources[i]->getType() == type) {
+            resourcesByType[type] = resources[i];
+            return;
+        }
+    }
+}
+
 // Resource management
 void Economy::addResource(Resource* resource) {
     if (!resource) {
         throw invalid_argument("Cannot add null resource");
     }
+    if (resource->getType() < 0) {
+        throw invalid_argument("Resource type cannot be negative");
+    }
 
-    // Check if we need to resize the array
-    if (numResources >= maxResources) {
-        // Create a new, larger array
-        int newMaxResources = maxResources * 2;
-        Resource** newResources = new Resource * [newMaxResources];
+    // Check if we need to resize the arrays
+    if (resources.size() >= maxResources) {
+        reserveResources(maxResources * 2);
+    }
 
-        // Copy existing resources to the new array
-        for (int i = 0; i < numResources; i++) {
-            newResources[i] = resources[i];
-        }
+    // Add the new resource; its amount and rates move into the columns
+    resource->bindToEconomy(this, resources.size());
+    resources.add(resource);
 
-        // Initialize remaining slots to nullptr
-        for (int i = numResources; i < newMaxResources; i++) {
-            newResources[i] = nullptr;
+    // Make room in the type table for types beyond the built-in ones
+    int type = resource->getType();
+    if (type >= resourceTableSize) {
+        int newTableSize = max(type + 1, resourceTableSize * 2);
+        growArray(resourcesByType, resourceTableSize, newTableSize);
+        for (int i = resourceTableSize; i < newTableSize; i++) {
+            resourcesByType[i] = nullptr;
         }
-
-        // Delete the old array and update pointers
-        delete[] resources;
-        resources = newResources;
-        maxResources = newMaxResources;
+        resourceTableSize = newTableSize;
     }
 
-    // Add the new resource
-    resources[numResources++] = resource;
+    // Lookups by type find the first resource of that type
+    if (!resourcesByType[type]) {
+        resourcesByType[type] = resource;
+    }
 }
 
 void Economy::removeResource(int index) {
-    if (index < 0 || index >= numResources) {
+    if (index < 0 || index >= resources.size()) {
         throw out_of_range("Resource index out of range");
     }
 
-    // Delete the resource object
+    ResourceType type = resources[index]->getType();
+    bool isIndexed = (resourcesByType[type] == resources[index]);
+
+    // Delete the resource object and close the gap
     delete resources[index];
+    resources.removeAt(index);
 
-    // Shift remaining elements
-    for (int i = index; i < numResources - 1; i++) {
-        resources[i] = resources[i + 1];
+    // The later resources move their column slots along
+    for (int i = index; i < resources.size(); i++) {
+        resources[i]->bindToEconomy(this, i);
     }
 
-    // Set the last position to nullptr and decrement count
-    resources[--numResources] = nullptr;
+    // Another resource of the same type may now be the first one
+    if (isIndexed) {
+        indexResourceType(type);
+    }
 }
 
 Resource* Economy::getResource(int index) const {
-    if (index < 0 || index >= numResources) {
+    if (index < 0 || index >= resources.size()) {
         throw out_of_range("Resource index out of range");
     }
     return resources[index];
 }
 
 Resource* Economy::getResourceByType(ResourceType type) const {
-    for (int i = 0; i < numResources; i++) {
-        if (resources[i] && resources[i]->getType() == type) {
-            return resources[i];
-        }
+    if (type < 0 || type >= resourceTableSize) {
+        return nullptr;
     }
-    return nullptr;
+    return resourcesByType[type];
 }
 
 int Economy::getNumResources() const {
-    return numResources;
+    return resources.size();
+}
+
+// Gather and then consume every resource, as Resource::update does, in one
+// pass over the columns. Consumption only happens when there is enough stock.
+void Economy::gatherResources() {
+    for (int i = 0; i < resources.size(); i++) {
+        int amount = resourceAmounts[i] + resourceGatherRates[i];
+        int consumption = resourceConsumptionRates[i];
+        resourceAmounts[i] = (consumption > 0 && amount >= consumption) ? amount - consumption : amount;
+    }
 }
 
 // Trade system
@@ -274,11 +305,9 @@ void Economy::calculateInflation() {
     int totalConsumption = 0;
     int totalProduction = 0;
 
-    for (int i = 0; i < numResources; i++) {
-        if (resources[i]) {
-            totalConsumption += resources[i]->getConsumptionRate();
-            totalProduction += resources[i]->getGatherRate();
-        }
+    for (int i = 0; i < resources.size(); i++) {
+        totalConsumption += resourceConsumptionRates[i];
+        totalProduction += resourceGatherRates[i];
     }
 
     if (totalProduction > 0) {
@@ -302,16 +331,24 @@ void Economy::calculateInflation() {
     setInflation(newInflation);
 }
 
+// Keep the market figures, and the treasury's gold, in a world store slot
+// (store == nullptr moves them back here)
+void Economy::bindToStore(WorldStore* store, int slot) {
+    marketStability.bind(store ? &store->marketStabilities : nullptr, slot);
+    inflation.bind(store ? &store->inflations : nullptr, slot);
+    employmentRate.bind(store ? &store->employmentRates : nullptr, slot);
+
+    if (treasury) {
+        treasury->bindToStore(store, slot);
+    }
+}
+
 // Update method required by Entity base class
 void Economy::update() {
     if (!getIsActive()) return;
 
     // Update resources
-    for (int i = 0; i < numResources; i++) {
-        if (resources[i]) {
-            resources[i]->update();
-        }
-    }
+    gatherResources();
 
     // Update market stability based on random fluctuations
     int stabilityChange = randomInt(-5, 5);
@@ -360,15 +397,15 @@ void Economy::save(ofstream& file) const {
     file << corruptionLevel << endl;
 
     // Save number of resources
-    file << numResources << endl;
+    file << resources.size() << endl;
 
     // Save each resource
-    for (int i = 0; i < numResources; i++) {
+    for (int i = 0; i < resources.size(); i++) {
         resources[i]->save(file);
     }
 
     // Save number of trade routes
-    file << numTradeRoutes << endl;
+    file << tradeRoutes.size() << endl;
 
     // Trade routes are recreated dynamically, so we don't save them
 
@@ -396,11 +433,14 @@ void Economy::load(ifstream& file) {
     file >> corruptionLevel;
 
     // Clean up existing resources
-    for (int i = 0; i < numResources; i++) {
+    for (int i = 0; i < resources.size(); i++) {
         delete resources[i];
-        resources[i] = nullptr;
     }
-    numResources = 0;
+    resources.clear();
+
+    for (int i = 0; i < resourceTableSize; i++) {
+        resourcesByType[i] = nullptr;
+    }
 
     // Load number of resources
     int loadNumResources;
@@ -415,51 +455,84 @@ void Economy::load(ifstream& file) {
     }
 
     // Clean up existing trade routes
-    for (int i = 0; i < numTradeRoutes; i++) {
-        delete tradeRoutes[i];
-        tradeRoutes[i] = nullptr;
-    }
+    clearTradeRoutes();
 
     // Load number of trade routes
     int loadNumTradeRoutes;
     file >> loadNumTradeRoutes;
-    numTradeRoutes = 0; // Trade routes will be recreated dynamically during gameplay
+    file.ignore(); // Skip newline
+    // Trade routes will be recreated dynamically during gameplay
 
     // Load treasury
     treasury->load(file);
 }
 
-// Trade route management
-void Economy::addTradeRoute(Kingdom* targetKingdom, ResourceType exportResource,
-    int exportAmount, ResourceType importResource, int importAmount) {
-    if (!targetKingdom) {
-        throw invalid_argument("Cannot create trade route with null kingdom");
+// Save economy data in binary form
+void Economy::saveBinary(SaveWriter& writer) const {
+    Entity::saveBinary(writer);
+    writer.writeInt(productionLevel);
+    writer.writeInt(tradeLevel);
+    writer.writeDouble(taxRate);
+    writer.writeDouble(tariffRate);
+    writer.writeInt(marketStability);
+    writer.writeDouble(inflation);
+    writer.writeInt(employmentRate);
+    writer.writeInt(corruptionLevel);
+
+    writer.writeInt(resources.size());
+    for (int i = 0; i < resources.size(); i++) {
+        resources[i]->saveBinary(writer);
     }
 
-    // Check if we need to resize the array
-    if (numTradeRoutes >= maxTradeRoutes) {
-        // Create a new, larger array
-        int newMaxTradeRoutes = maxTradeRoutes * 2;
-        TradeRoute** newTradeRoutes = new TradeRoute * [newMaxTradeRoutes];
+    // Trade routes are recreated dynamically; only their number is kept
+    writer.writeInt(tradeRoutes.size());
 
-        // Copy existing trade routes to the new array
-        for (int i = 0; i < numTradeRoutes; i++) {
-            newTradeRoutes[i] = tradeRoutes[i];
-        }
+    treasury->saveBinary(writer);
+}
 
-        // Initialize remaining slots to nullptr
-        for (int i = numTradeRoutes; i < newMaxTradeRoutes; i++) {
-            newTradeRoutes[i] = nullptr;
-        }
+// Load economy data in binary form
+void Economy::loadBinary(SaveReader& reader) {
+    Entity::loadBinary(reader);
+    productionLevel = reader.readInt();
+    tradeLevel = reader.readInt();
+    taxRate = reader.readDouble();
+    tariffRate = reader.readDouble();
+    marketStability = reader.readInt();
+    inflation = reader.readDouble();
+    employmentRate = reader.readInt();
+    corruptionLevel = reader.readInt();
+
+    for (int i = 0; i < resources.size(); i++) {
+        delete resources[i];
+    }
+    resources.clear();
 
-        // Delete the old array and update pointers
-        delete[] tradeRoutes;
-        tradeRoutes = newTradeRoutes;
-        maxTradeRoutes = newMaxTradeRoutes;
+    for (int i = 0; i < resourceTableSize; i++) {
+        resourcesByType[i] = nullptr;
+    }
+
+    int loadNumResources = reader.readInt();
+    for (int i = 0; i < loadNumResources; i++) {
+        Resource* resource = new Resource("Temp", FOOD);
+        resource->loadBinary(reader);
+        addResource(resource);
+    }
+
+    clearTradeRoutes();
+    reader.readInt();
+
+    treasury->loadBinary(reader);
+}
+
+// Trade route management
+void Economy::addTradeRoute(Kingdom* targetKingdom, ResourceType exportResource,
+    int exportAmount, ResourceType importResource, int importAmount) {
+    if (!targetKingdom) {
+        throw invalid_argument("Cannot create trade route with null kingdom");
     }
 
     // Create and add the new trade route
-    TradeRoute* newRoute = new TradeRoute();
+    TradeRoute* newRoute = &tradeRoutes.emplace();
     newRoute->targetKingdom = targetKingdom;
     newRoute->exportResource = exportResource;
     newRoute->exportAmount = exportAmount;
@@ -468,7 +541,6 @@ void Economy::addTradeRoute(Kingdom* targetKingdom, ResourceType exportResource,
     newRoute->profitMargin = 1.0 + (tradeLevel / 100.0); // Higher trade level = better profit margin
     newRoute->isActive = true;
 
-    tradeRoutes[numTradeRoutes++] = newRoute;
 
     // Trade routes improve trade level over time
     if (tradeLevel < 100) {
@@ -479,30 +551,8 @@ void Economy::addTradeRoute(Kingdom* targetKingdom, ResourceType exportResource,
 // Overloaded version that takes a kingdom name instead of pointer
 void Economy::addTradeRoute(const string& targetKingdomName, ResourceType exportResource,
     int exportAmount, ResourceType importResource, int importAmount) {
-    // Check if we need to resize the array
-    if (numTradeRoutes >= maxTradeRoutes) {
-        // Create a new, larger array
-        int newMaxTradeRoutes = maxTradeRoutes * 2;
-        TradeRoute** newTradeRoutes = new TradeRoute * [newMaxTradeRoutes];
-
-        // Copy existing trade routes to the new array
-        for (int i = 0; i < numTradeRoutes; i++) {
-            newTradeRoutes[i] = tradeRoutes[i];
-        }
-
-        // Initialize remaining slots to nullptr
-        for (int i = numTradeRoutes; i < newMaxTradeRoutes; i++) {
-            newTradeRoutes[i] = nullptr;
-        }
-
-        // Delete the old array and update pointers
-        delete[] tradeRoutes;
-        tradeRoutes = newTradeRoutes;
-        maxTradeRoutes = newMaxTradeRoutes;
-    }
-
     // Create and add the new trade route
-    TradeRoute* newRoute = new TradeRoute();
+    TradeRoute* newRoute = &tradeRoutes.emplace();
     newRoute->targetKingdom = nullptr; // No actual kingdom pointer, just using the name
     newRoute->targetKingdomName = targetKingdomName; // Store the kingdom name
     newRoute->exportResource = exportResource;
@@ -512,7 +562,6 @@ void Economy::addTradeRoute(const string& targetKingdomName, ResourceType export
     newRoute->profitMargin = 1.0 + (tradeLevel / 100.0); // Higher trade level = better profit margin
     newRoute->isActive = true;
 
-    tradeRoutes[numTradeRoutes++] = newRoute;
 
     // Trade routes improve trade level over time
     if (tradeLevel < 100) {
@@ -521,20 +570,12 @@ void Economy::addTradeRoute(const string& targetKingdomName, ResourceType export
 }
 
 void Economy::removeTradeRoute(int index) {
-    if (index < 0 || index >= numTradeRoutes) {
+    if (index < 0 || index >= tradeRoutes.size()) {
         throw out_of_range("Trade route index out of range");
     }
 
-    // Delete the trade route object
-    delete tradeRoutes[index];
-
-    // Shift remaining elements
-    for (int i = index; i < numTradeRoutes - 1; i++) {
-        tradeRoutes[i] = tradeRoutes[i + 1];
-    }
-
-    // Set the last position to nullptr and decrement count
-    tradeRoutes[--numTradeRoutes] = nullptr;
+    // Remove the trade route, keeping the order of the others
+    tradeRoutes.removeAt(index);
 
     // Removing trade routes can slightly decrease trade level
     if (tradeLevel > 0) {
@@ -542,8 +583,13 @@ void Economy::removeTradeRoute(int index) {
     }
 }
 
+// Remove all trade routes without touching the trade level
+void Economy::clearTradeRoutes() {
+    tradeRoutes.clear();
+}
+
 int Economy::getNumTradeRoutes() const {
-    return numTradeRoutes;
+    return tradeRoutes.size();
 }
 
 int Economy::getMaxTradeRoutes() const {
@@ -557,104 +603,120 @@ int Economy::getMaxTradeRoutes() const {
 void Economy::displayTradeRoutes() const {
     cout << "=== ACTIVE TRADE ROUTES ===\n" << endl;
 
-    if (numTradeRoutes == 0) {
+    if (tradeRoutes.isEmpty()) {
         cout << "No active trade routes." << endl;
         return;
     }
 
-    for (int i = 0; i < numTradeRoutes; i++) {
-        TradeRoute* route = tradeRoutes[i];
-        if (route) {
-            // Display trade partner
-            cout << (i + 1) << ". Trade with: ";
-            if (route->targetKingdom) {
-                cout << route->targetKingdom->getName();
-            }
-            else if (!route->targetKingdomName.empty()) {
-                cout << route->targetKingdomName;
-            }
-            else {
-                cout << "Foreign Kingdom"; // Generic name when both Kingdom* and name are null/empty
-            }
-            cout << endl;
-
-            // Display export details
-            cout << "   Export: " << route->exportAmount << " ";
-            switch (route->exportResource) {
-            case FOOD: cout << "Food"; break;
-            case WOOD: cout << "Wood"; break;
-            case STONE: cout << "Stone"; break;
-            case GOLD: cout << "Gold"; break;
-            case IRON: cout << "Iron"; break;
-            default: cout << "Unknown Resource"; break;
-            }
-            cout << endl;
-
-            // Display import details
-            cout << "   Import: " << route->importAmount << " ";
-            switch (route->importResource) {
-            case FOOD: cout << "Food"; break;
-            case WOOD: cout << "Wood"; break;
-            case STONE: cout << "Stone"; break;
-            case GOLD: cout << "Gold"; break;
-            case IRON: cout << "Iron"; break;
-            default: cout << "Unknown Resource"; break;
-            }
-            cout << endl;
-
-            // Display profit margin
-            cout << "   Profit Margin: " << (int)((route->profitMargin - 1.0) * 100) << "%" << endl;
-            cout << "   Status: " << (route->isActive ? "Active" : "Inactive") << endl;
-            cout << endl;
+    for (int i = 0; i < tradeRoutes.size(); i++) {
+        const TradeRoute* route = &tradeRoutes[i];
+        // Display trade partner
+        cout << (i + 1) << ". Trade with: ";
+        if (route->targetKingdom) {
+            cout << route->targetKingdom->getName();
+        }
+        else if (!route->targetKingdomName.empty()) {
+            cout << route->targetKingdomName;
+        }
+        else {
+            cout << "Foreign Kingdom"; // Generic name when both Kingdom* and name are null/empty
         }
+        cout << endl;
+
+        // Display export details
+        cout << "   Export: " << route->exportAmount << " ";
+        switch (route->exportResource) {
+        case FOOD: cout << "Food"; break;
+        case WOOD: cout << "Wood"; break;
+        case STONE: cout << "Stone"; break;
+        case GOLD: cout << "Gold"; break;
+        case IRON: cout << "Iron"; break;
+        default: cout << "Unknown Resource"; break;
+        }
+        cout << endl;
+
+        // Display import details
+        cout << "   Import: " << route->importAmount << " ";
+        switch (route->importResource) {
+        case FOOD: cout << "Food"; break;
+        case WOOD: cout << "Wood"; break;
+        case STONE: cout << "Stone"; break;
+        case GOLD: cout << "Gold"; break;
+        case IRON: cout << "Iron"; break;
+        default: cout << "Unknown Resource"; break;
+        }
+        cout << endl;
+
+        // Display profit margin
+        cout << "   Profit Margin: " << (int)((route->profitMargin - 1.0) * 100) << "%" << endl;
+        cout << "   Status: " << (route->isActive ? "Active" : "Inactive") << endl;
+        cout << endl;
     }
 }
 
+// Process trade routes that do not involve another Kingdom object
 void Economy::processTradeRoutes() {
-    for (int i = 0; i < numTradeRoutes; i++) {
-        TradeRoute* route = tradeRoutes[i];
-        if (route && route->isActive) {
-            // Find our export resource
-            Resource* exportRes = getResourceByType(route->exportResource);
-            if (!exportRes || exportRes->getAmount() < route->exportAmount) {
-                // Not enough of export resource, skip this trade route this turn
-                continue;
-            }
-
-            // Reduce our export resource
-            exportRes->setAmount(exportRes->getAmount() - route->exportAmount);
-
-            // Find our import resource
-            Resource* importRes = getResourceByType(route->importResource);
-            if (!importRes) {
-                // We don't have this resource type, skip this trade route
-                continue;
-            }
-
-            // Apply tariff to determine actual import amount
-            int actualImportAmount = route->importAmount;
-            if (tariffRate > 0) {
-                int tariffCost = (int)(actualImportAmount * tariffRate);
-                actualImportAmount -= tariffCost;
-
-                // Add tariff income to treasury
-                if (treasury) {
-                    treasury->earn(tariffCost * 2); // Convert resource units to gold value
-                }
-            }
-
-            // Apply trade level bonus
-            actualImportAmount = (int)(actualImportAmount * route->profitMargin);
-
-            // Increase our import resource
-            importRes->setAmount(importRes->getAmount() + actualImportAmount);
-
-            // Trade success improves trade level
-            if (randomInt(1, 100) <= 10) {
-                if (tradeLevel < 100) {
-                    tradeLevel += 1;
-                }
-            }
+    for (int i = 0; i < tradeRoutes.size(); i++) {
+        TradeRoute* route = &tradeRoutes[i];
+        // Routes to a live kingdom are settled in processKingdomTradeRoutes
+        if (route->isActive && !route->targetKingdom) {
+            settleTradeRoute(route);
+        }
+    }
+}
+
+// Process trade routes linked to another Kingdom. These may touch state outside
+// this kingdom, so the game engine calls this serially after the per-kingdom phase.
+void Economy::processKingdomTradeRoutes() {
+    for (int i = 0; i < tradeRoutes.size(); i++) {
+        TradeRoute* route = &tradeRoutes[i];
+        if (route->isActive && route->targetKingdom) {
+            settleTradeRoute(route);
+        }
+    }
+}
+
+// Exchange one turn's worth of goods along a trade route
+void Economy::settleTradeRoute(TradeRoute* route) {
+    // Find our export resource
+    Resource* exportRes = getResourceByType(route->exportResource);
+    if (!exportRes || exportRes->getAmount() < route->exportAmount) {
+        // Not enough of export resource, skip this trade route this turn
+        return;
+    }
+
+    // Reduce our export resource
+    exportRes->setAmount(exportRes->getAmount() - route->exportAmount);
+
+    // Find our import resource
+    Resource* importRes = getResourceByType(route->importResource);
+    if (!importRes) {
+        // We don't have this resource type, skip this trade route
+        return;
+    }
+
+    // Apply tariff to determine actual import amount
+    int actualImportAmount = route->importAmount;
+    if (tariffRate > 0) {
+        int tariffCost = (int)(actualImportAmount * tariffRate);
+        actualImportAmount -= tariffCost;
+
+        // Add tariff income to treasury
+        if (treasury) {
+            treasury->earn(tariffCost * 2); // Convert resource units to gold value
         }
     }
-}
\ No newline at end of file
+
+    // Apply trade level bonus
+    actualImportAmount = (int)(actualImportAmount * route->profitMargin);
+
+    // Increase our import resource
+    importRes->setAmount(importRes->getAmount() + actualImportAmount);
+
+    // Trade success improves trade level
+    if (randomInt(1, 100) <= 10) {
+        if (tradeLevel < 100) {
+            tradeLevel += 1;
+        }
+    }
+}
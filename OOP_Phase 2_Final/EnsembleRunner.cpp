@@ -0,0 +1,162 @@
+#include "StrongHold.h"
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <chrono>
+#include <algorithm>
+
+using namespace std;
+
+// Number of bars in each histogram
+const int HISTOGRAM_BINS = 10;
+// Width of the longest histogram bar
+const int HISTOGRAM_WIDTH = 40;
+
+// Constructor
+EnsembleRunner::EnsembleRunner(int numGames, int numKingdoms, int numTurns, unsigned long long baseSeed, int numThreads)
+    : numGames(numGames), numKingdoms(numKingdoms), numTurns(numTurns), numThreads(numThreads),
+    baseSeed(baseSeed), results(nullptr), elapsedSeconds(0.0) {
+
+    if (numGames < 1 || numKingdoms < 1 || numTurns < 1) {
+        throw invalid_argument("Ensemble requires at least one game, kingdom and turn");
+    }
+    if (this->numThreads < 1) {
+        this->numThreads = 1;
+    }
+
+    results = new GameResult[numGames];
+}
+
+// Destructor
+EnsembleRunner::~EnsembleRunner() {
+    delete[] results;
+}
+
+int EnsembleRunner::getNumGames() const {
+    return numGames;
+}
+
+const GameResult& EnsembleRunner::getResult(int index) const {
+    if (index < 0 || index >= numGames) {
+        throw out_of_range("Game index out of range");
+    }
+    return results[index];
+}
+
+double EnsembleRunner::getElapsedSeconds() const {
+    return elapsedSeconds;
+}
+
+double EnsembleRunner::getGamesPerSecond() const {
+    return (elapsedSeconds > 0.0) ? numGames / elapsedSeconds : 0.0;
+}
+
+// Play one game to its end. The game draws from its own generator, seeded the
+// same way setMasterSeed does, so any game can be replayed alone with its seed.
+GameResult EnsembleRunner::runGame(unsigned long long seed) const {
+    RandomGenerator gameGenerator(seed, 0);
+    RandomStreamScope randomScope(&gameGenerator);
+
+    GameEngine gameEngine;
+    gameEngine.setupHeadlessGame(numKingdoms);
+
+    GameResult result;
+    result.seed = seed;
+    result.turnsSurvived = gameEngine.runHeadless(numTurns);
+    result.finalScore = gameEngine.calculateFinalScore();
+
+    Kingdom* kingdom = gameEngine.getPlayerKingdom();
+    if (kingdom) {
+        result.finalStability = kingdom->getStabilityLevel();
+        if (kingdom->getEconomy() && kingdom->getEconomy()->getTreasury()) {
+            result.finalTreasury = kingdom->getEconomy()->getTreasury()->getGold();
+        }
+    }
+
+    return result;
+}
+
+// Run every game, spread over the worker threads
+void EnsembleRunner::run() {
+    ThreadPool threadPool(numThreads);
+
+    auto start = chrono::steady_clock::now();
+    threadPool.parallelFor(numGames, [this](int i) {
+        results[i] = runGame(baseSeed + i);
+    });
+    auto end = chrono::steady_clock::now();
+
+    elapsedSeconds = chrono::duration<double>(end - start).count();
+}
+
+// Write summary statistics and a histogram for one metric
+void EnsembleRunner::writeDistribution(ostream& out, const string& label, double* values) const {
+    sort(values, values + numGames);
+
+    double sum = 0.0;
+    for (int i = 0; i < numGames; i++) {
+        sum += values[i];
+    }
+
+    // Percentile read from the sorted values
+    auto percentile = [&](double p) {
+        int rank = static_cast<int>(p / 100.0 * (numGames - 1) + 0.5);
+        return values[rank];
+    };
+
+    double minValue = values[0];
+    double maxValue = values[numGames - 1];
+
+    out << "\n" << label << endl;
+    out << fixed << setprecision(1);
+    out << "  mean " << sum / numGames << "  min " << minValue << "  max " << maxValue << endl;
+    out << "  p1 " << percentile(1) << "  p10 " << percentile(10) << "  p50 " << percentile(50)
+        << "  p90 " << percentile(90) << "  p99 " << percentile(99) << endl;
+
+    // Histogram over equal-width bins
+    int counts[HISTOGRAM_BINS] = {};
+    double binWidth = (maxValue - minValue) / HISTOGRAM_BINS;
+    for (int i = 0; i < numGames; i++) {
+        int bin = (binWidth > 0.0) ? static_cast<int>((values[i] - minValue) / binWidth) : 0;
+        counts[min(bin, HISTOGRAM_BINS - 1)]++;
+    }
+
+    int largestCount = *max_element(counts, counts + HISTOGRAM_BINS);
+    for (int b = 0; b < HISTOGRAM_BINS; b++) {
+        int barLength = (largestCount > 0) ? counts[b] * HISTOGRAM_WIDTH / largestCount : 0;
+        out << "  " << setw(10) << minValue + b * binWidth << " | " << string(barLength, '#')
+            << " " << counts[b] << endl;
+
+        // All values are equal, one bin says it all
+        if (binWidth <= 0.0) {
+            break;
+        }
+    }
+}
+
+// Write the ensemble report
+void EnsembleRunner::writeReport(ostream& out) const {
+    out << "=== ENSEMBLE REPORT ===" << endl;
+    out << "Games per second: " << fixed << setprecision(1) << getGamesPerSecond() << endl;
+    out << "Games: " << numGames << " (seeds " << baseSeed << " to " << baseSeed + numGames - 1 << ")" << endl;
+    out << "Kingdoms per game: " << numKingdoms << endl;
+    out << "Turn limit: " << numTurns << endl;
+    out << "Worker threads: " << numThreads << endl;
+    out << "Elapsed time: " << fixed << setprecision(3) << elapsedSeconds << " s" << endl;
+
+    double* values = new double[numGames];
+
+    for (int i = 0; i < numGames; i++) values[i] = results[i].finalScore;
+    writeDistribution(out, "Final score", values);
+
+    for (int i = 0; i < numGames; i++) values[i] = results[i].turnsSurvived;
+    writeDistribution(out, "Turns survived", values);
+
+    for (int i = 0; i < numGames; i++) values[i] = results[i].finalStability;
+    writeDistribution(out, "Final stability", values);
+
+    for (int i = 0; i < numGames; i++) values[i] = results[i].finalTreasury;
+    writeDistribution(out, "Final treasury", values);
+
+    delete[] values;
+}
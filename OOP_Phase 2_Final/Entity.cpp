@@ -1,12 +1,17 @@
-#include "Stronghold.h"
+#include "StrongHold.h"
 #include <iostream>
 #include <fstream>
 #include <string>
 
 using namespace std;
 
-// Constructor
-Entity::Entity(const string& name, const string& description)
+// Constructor; the text is interned
+Entity::Entity(string_view name, string_view description)
+    : name(name), description(description), isActive(true) {
+}
+
+// Constructor for text that is already interned
+Entity::Entity(Symbol name, Symbol description)
     : name(name), description(description), isActive(true) {
 }
 
@@ -16,20 +21,28 @@ Entity::~Entity() {
 }
 
 // Getters and setters
-string Entity::getName() const {
+string_view Entity::getName() const {
+    return name.view();
+}
+
+Symbol Entity::getNameSymbol() const {
     return name;
 }
 
-void Entity::setName(const string& newName) {
-    name = newName;
+void Entity::setName(string_view newName) {
+    name = Symbol(newName);
 }
 
-string Entity::getDescription() const {
+string_view Entity::getDescription() const {
+    return description.view();
+}
+
+Symbol Entity::getDescriptionSymbol() const {
     return description;
 }
 
-void Entity::setDescription(const string& newDescription) {
-    description = newDescription;
+void Entity::setDescription(string_view newDescription) {
+    description = Symbol(newDescription);
 }
 
 bool Entity::getIsActive() const {
@@ -57,8 +70,25 @@ void Entity::load(ifstream& file) {
         throw runtime_error("Failed to load Entity: File not open");
     }
 
-    getline(file, name);
-    getline(file, description);
+    string text;
+    getline(file, text);
+    name = Symbol(text);
+    getline(file, text);
+    description = Symbol(text);
     file >> isActive;
     file.ignore(); // Skip newline
+}
+
+// Save entity data in binary form
+void Entity::saveBinary(SaveWriter& writer) const {
+    writer.writeSymbol(name);
+    writer.writeSymbol(description);
+    writer.writeBool(isActive);
+}
+
+// Load entity data in binary form
+void Entity::loadBinary(SaveReader& reader) {
+    name = reader.readSymbol();
+    description = reader.readSymbol();
+    isActive = reader.readBool();
 }
\ No newline at end of file
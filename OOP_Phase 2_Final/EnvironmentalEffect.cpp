@@ -1,4 +1,4 @@
-#include "Stronghold.h"
+#include "StrongHold.h"
 #include <iostream>
 #include <fstream>
 #include <string>
@@ -80,3 +80,19 @@ void EnvironmentalEffect::load(ifstream& file) {
     file >> turnsActive;
     file.ignore(); // Skip newline
 }
+
+// Save environmental effect data in binary form
+void EnvironmentalEffect::saveBinary(SaveWriter& writer) const {
+    Entity::saveBinary(writer);
+    writer.writeInt(severity);
+    writer.writeInt(duration);
+    writer.writeInt(turnsActive);
+}
+
+// Load environmental effect data in binary form
+void EnvironmentalEffect::loadBinary(SaveReader& reader) {
+    Entity::loadBinary(reader);
+    severity = reader.readInt();
+    duration = reader.readInt();
+    turnsActive = reader.readInt();
+}
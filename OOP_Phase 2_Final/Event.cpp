@@ -1,14 +1,22 @@
-#include "Stronghold.h"
+#include "StrongHold.h"
 #include <iostream>
 #include <fstream>
 #include <string>
 
 using namespace std;
 
-// Constructor
+// Constructor; the text is interned in the EventCatalog
 Event::Event(const string& name, const string& description, EventType type)
-    : Entity(name, description), type(type), populationEffect(0), economyEffect(0),
-    militaryEffect(0), resourceEffect(0), duration(1), turnsRemaining(1),
+    : Entity(name, description), kindId(EventCatalog::intern(this->name, this->description, EVENT_UNCATEGORIZED, type)), type(type),
+    populationEffect(0), economyEffect(0), militaryEffect(0), resourceEffect(0), duration(1),
+    turnsRemaining(1), affectedResourceType(FOOD) {
+}
+
+// Constructor for an event of a catalog kind
+Event::Event(int kindId)
+    : Entity(EventCatalog::getKind(kindId).name, EventCatalog::getKind(kindId).description), kindId(kindId),
+    type(EventCatalog::getKind(kindId).type), populationEffect(0),
+    economyEffect(0), militaryEffect(0), resourceEffect(0), duration(1), turnsRemaining(1),
     affectedResourceType(FOOD) {
 }
 
@@ -18,6 +26,14 @@ Event::~Event() {
 }
 
 // Getters and setters
+int Event::getKindId() const {
+    return kindId;
+}
+
+const EventKind& Event::getKind() const {
+    return EventCatalog::getKind(kindId);
+}
+
 EventType Event::getType() const {
     return type;
 }
@@ -89,46 +105,26 @@ void Event::setAffectedResourceType(ResourceType type) {
 }
 
 // Generate a random event
-Event* Event::generateRandomEvent() {
-    // List of potential event names and descriptions
-    string eventNames[][3] = {
-        {"Bountiful Harvest", "Drought", "Average Harvest"},
-        {"Trade Boom", "Economic Crisis", "Market Fluctuations"},
-        {"Military Parade", "Military Desertion", "New Recruits"},
-        {"Gold Mine Discovery", "Resource Shortage", "Resource Discovery"},
-        {"Population Growth", "Plague Outbreak", "Migration"}
-    };
-
-    string eventDescs[][3] = {
-        {"A bountiful harvest has increased food supplies.", "A severe drought has damaged crops.", "The harvest is neither good nor bad this year."},
-        {"Trade is booming in your kingdom.", "An economic crisis has hit your kingdom.", "Market prices are fluctuating."},
-        {"A successful military parade has boosted morale.", "Soldiers are deserting in large numbers.", "New recruits have joined the army."},
-        {"A new gold mine has been discovered.", "Resources are becoming scarce.", "A new resource deposit has been found."},
-        {"The population is growing rapidly.", "A plague has broken out in your kingdom.", "People are migrating to and from your kingdom."}
-    };
-
+Event* Event::generateRandomEvent(Arena* arena) {
     // Choose random event type
-    int eventCategory = randomInt(0, 4); // 5 categories of events
+    int eventCategory = randomInt(0, NUM_EVENT_CATEGORIES - 1);
     EventType eventType;
-    int typeIndex;
 
     // Determine if positive, negative, or neutral event (weighted)
     int random = randomInt(1, 10);
     if (random <= 4) { // 40% positive
         eventType = EVENT_POSITIVE;
-        typeIndex = 0;
     }
     else if (random <= 8) { // 40% negative
         eventType = EVENT_NEGATIVE;
-        typeIndex = 1;
     }
     else { // 20% neutral
         eventType = EVENT_NEUTRAL;
-        typeIndex = 2;
     }
 
     // Create the event
-    Event* event = new Event(eventNames[eventCategory][typeIndex], eventDescs[eventCategory][typeIndex], eventType);
+    int kindId = EventCatalog::chooseKind(static_cast<EventCategory>(eventCategory), eventType);
+    Event* event = createIn<Event>(arena, kindId);
 
     // Set duration (1-5 turns)
     event->setDuration(randomInt(1, 5));
@@ -171,7 +167,7 @@ void Event::applyEffects(Kingdom* kingdom) {
         throw invalid_argument("Cannot apply event effects: Kingdom is null");
     }
 
-    cout << "Event: " << name << " - " << description << endl;
+    LogLine() << "Event: " << name << " - " << description;
 
     // Population effects
     if (populationEffect != 0) {
@@ -179,7 +175,7 @@ void Event::applyEffects(Kingdom* kingdom) {
         if (population) {
             population->handleEvent(*this);
 
-            cout << "Population impact: " << (populationEffect > 0 ? "+" : "") << populationEffect << "%" << endl;
+            LogLine() << "Population impact: " << (populationEffect > 0 ? "+" : "") << populationEffect << "%";
         }
     }
 
@@ -195,7 +191,7 @@ void Event::applyEffects(Kingdom* kingdom) {
                 if (treasury) {
                     int bonus = economyEffect * 10;
                     treasury->earn(bonus);
-                    cout << "Treasury gained " << bonus << " gold." << endl;
+                    LogLine() << "Treasury gained " << bonus << " gold.";
                 }
             }
             else {
@@ -206,11 +202,11 @@ void Event::applyEffects(Kingdom* kingdom) {
                 if (treasury) {
                     int loss = -economyEffect * 10;
                     treasury->spend(loss);
-                    cout << "Treasury lost " << loss << " gold." << endl;
+                    LogLine() << "Treasury lost " << loss << " gold.";
                 }
             }
 
-            cout << "Economy impact: " << (economyEffect > 0 ? "+" : "") << economyEffect << "%" << endl;
+            LogLine() << "Economy impact: " << (economyEffect > 0 ? "+" : "") << economyEffect << "%";
         }
     }
 
@@ -223,29 +219,23 @@ void Event::applyEffects(Kingdom* kingdom) {
 
                 // Boost morale
                 for (int i = 0; i < army->getNumUnits(); i++) {
-                    MilitaryUnit* unit = army->getUnit(i);
-                    if (unit) {
-                        unit->adjustMorale(militaryEffect / 2);
-                    }
+                    army->adjustUnitMorale(i, militaryEffect / 2);
                 }
 
-                cout << "Army morale and training improved." << endl;
+                LogLine() << "Army morale and training improved.";
             }
             else {
                 army->setTrainingLevel(max(10, army->getTrainingLevel() + militaryEffect / 3));
 
                 // Reduce morale
                 for (int i = 0; i < army->getNumUnits(); i++) {
-                    MilitaryUnit* unit = army->getUnit(i);
-                    if (unit) {
-                        unit->adjustMorale(militaryEffect / 2);
-                    }
+                    army->adjustUnitMorale(i, militaryEffect / 2);
                 }
 
-                cout << "Army morale and training declined." << endl;
+                LogLine() << "Army morale and training declined.";
             }
 
-            cout << "Military impact: " << (militaryEffect > 0 ? "+" : "") << militaryEffect << "%" << endl;
+            LogLine() << "Military impact: " << (militaryEffect > 0 ? "+" : "") << militaryEffect << "%";
         }
     }
 
@@ -260,25 +250,24 @@ void Event::applyEffects(Kingdom* kingdom) {
 
                 if (change > 0) {
                     affectedResource->setAmount(currentAmount + change);
-                    cout << affectedResource->getName() << " increased by " << change << "." << endl;
+                    LogLine() << affectedResource->getName() << " increased by " << change << ".";
                 }
                 else {
                     affectedResource->setAmount(max(0, currentAmount + change));
-                    cout << affectedResource->getName() << " decreased by " << -change << "." << endl;
+                    LogLine() << affectedResource->getName() << " decreased by " << -change << ".";
                 }
             }
 
-            cout << "Resource impact: " << (resourceEffect > 0 ? "+" : "") << resourceEffect << "% on ";
+            LogLine impactLine;
+            impactLine << "Resource impact: " << (resourceEffect > 0 ? "+" : "") << resourceEffect << "% on ";
 
             switch (affectedResourceType) {
-            case FOOD: cout << "Food"; break;
-            case WOOD: cout << "Wood"; break;
-            case STONE: cout << "Stone"; break;
-            case GOLD: cout << "Gold"; break;
-            case IRON: cout << "Iron"; break;
+            case FOOD: impactLine << "Food"; break;
+            case WOOD: impactLine << "Wood"; break;
+            case STONE: impactLine << "Stone"; break;
+            case GOLD: impactLine << "Gold"; break;
+            case IRON: impactLine << "Iron"; break;
             }
-
-            cout << endl;
         }
     }
 }
@@ -327,6 +316,7 @@ void Event::load(ifstream& file) {
     int typeInt;
     file >> typeInt;
     type = static_cast<EventType>(typeInt);
+    kindId = EventCatalog::intern(name, description, EVENT_UNCATEGORIZED, type);
 
     file >> populationEffect;
     file >> economyEffect;
@@ -340,4 +330,31 @@ void Event::load(ifstream& file) {
     affectedResourceType = static_cast<ResourceType>(resourceTypeInt);
 
     file.ignore(); // Skip newline
+}
+
+// Save event data in binary form
+void Event::saveBinary(SaveWriter& writer) const {
+    Entity::saveBinary(writer);
+    writer.writeInt(static_cast<int>(type));
+    writer.writeInt(populationEffect);
+    writer.writeInt(economyEffect);
+    writer.writeInt(militaryEffect);
+    writer.writeInt(resourceEffect);
+    writer.writeInt(duration);
+    writer.writeInt(turnsRemaining);
+    writer.writeInt(static_cast<int>(affectedResourceType));
+}
+
+// Load event data in binary form
+void Event::loadBinary(SaveReader& reader) {
+    Entity::loadBinary(reader);
+    type = static_cast<EventType>(reader.readInt());
+    kindId = EventCatalog::intern(name, description, EVENT_UNCATEGORIZED, type);
+    populationEffect = reader.readInt();
+    economyEffect = reader.readInt();
+    militaryEffect = reader.readInt();
+    resourceEffect = reader.readInt();
+    duration = reader.readInt();
+    turnsRemaining = reader.readInt();
+    affectedResourceType = static_cast<ResourceType>(reader.readInt());
 }
\ No newline at end of file
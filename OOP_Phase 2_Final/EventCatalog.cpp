@@ -0,0 +1,184 @@
+#include "StrongHold.h"
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <mutex>
+
+using namespace std;
+
+EventKind* EventCatalog::kinds = nullptr;
+int EventCatalog::numKinds = 0;
+int EventCatalog::maxKinds = 0;
+int* EventCatalog::drawTable[NUM_EVENT_CATEGORIES][3] = {};
+int EventCatalog::drawTableSizes[NUM_EVENT_CATEGORIES][3] = {};
+mutex EventCatalog::catalogMutex;
+
+// The built-in kinds are in place before main() runs
+static const bool builtInKindsAdded = EventCatalog::addBuiltInKinds();
+
+// Names used in event data files, in enum order
+static const char* categoryNames[NUM_EVENT_CATEGORIES] = { "harvest", "economic", "military", "resource", "population" };
+static const char* typeNames[3] = { "positive", "negative", "neutral" };
+
+// Built-in kinds, indexed by category and type
+static const char* builtInNames[NUM_EVENT_CATEGORIES][3] = {
+    {"Bountiful Harvest", "Drought", "Average Harvest"},
+    {"Trade Boom", "Economic Crisis", "Market Fluctuations"},
+    {"Military Parade", "Military Desertion", "New Recruits"},
+    {"Gold Mine Discovery", "Resource Shortage", "Resource Discovery"},
+    {"Population Growth", "Plague Outbreak", "Migration"}
+};
+
+static const char* builtInDescriptions[NUM_EVENT_CATEGORIES][3] = {
+    {"A bountiful harvest has increased food supplies.", "A severe drought has damaged crops.", "The harvest is neither good nor bad this year."},
+    {"Trade is booming in your kingdom.", "An economic crisis has hit your kingdom.", "Market prices are fluctuating."},
+    {"A successful military parade has boosted morale.", "Soldiers are deserting in large numbers.", "New recruits have joined the army."},
+    {"A new gold mine has been discovered.", "Resources are becoming scarce.", "A new resource deposit has been found."},
+    {"The population is growing rapidly.", "A plague has broken out in your kingdom.", "People are migrating to and from your kingdom."}
+};
+
+bool EventCatalog::addBuiltInKinds() {
+    for (int category = 0; category < NUM_EVENT_CATEGORIES; category++) {
+        for (int type = 0; type < 3; type++) {
+            intern(Symbol(builtInNames[category][type]), Symbol(builtInDescriptions[category][type]),
+                static_cast<EventCategory>(category), static_cast<EventType>(type));
+        }
+    }
+    return true;
+}
+
+// Id of the kind with this text, or -1
+int EventCatalog::findKind(Symbol name, Symbol description) {
+    for (int i = 0; i < numKinds; i++) {
+        if (kinds[i].name == name && kinds[i].description == description) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+int EventCatalog::addKind(Symbol name, Symbol description, EventCategory category, EventType type) {
+    if (numKinds >= maxKinds) {
+        int newMaxKinds = max(16, maxKinds * 2);
+        growArray(kinds, numKinds, newMaxKinds);
+        maxKinds = newMaxKinds;
+    }
+
+    EventKind& kind = kinds[numKinds];
+    kind.name = name;
+    kind.description = description;
+    kind.category = category;
+    kind.type = type;
+
+    // Drawable kinds also go into the table used by chooseKind
+    if (category != EVENT_UNCATEGORIZED) {
+        int& tableSize = drawTableSizes[category][type];
+        growArray(drawTable[category][type], tableSize, tableSize + 1);
+        drawTable[category][type][tableSize++] = numKinds;
+    }
+
+    return numKinds++;
+}
+
+// Id of the kind with this text, added if it is new. A kind first seen
+// uncategorized (e.g. in a save) becomes drawable once its category is known.
+int EventCatalog::intern(Symbol name, Symbol description, EventCategory category, EventType type) {
+    if (category < EVENT_UNCATEGORIZED || category >= NUM_EVENT_CATEGORIES) {
+        throw invalid_argument("Invalid event category");
+    }
+    if (type < EVENT_POSITIVE || type > EVENT_NEUTRAL) {
+        throw invalid_argument("Invalid event type");
+    }
+
+    lock_guard<mutex> lock(catalogMutex);
+
+    int id = findKind(name, description);
+    if (id < 0) {
+        return addKind(name, description, category, type);
+    }
+
+    if (kinds[id].category == EVENT_UNCATEGORIZED && category != EVENT_UNCATEGORIZED) {
+        kinds[id].category = category;
+        kinds[id].type = type;
+
+        int& tableSize = drawTableSizes[category][type];
+        growArray(drawTable[category][type], tableSize, tableSize + 1);
+        drawTable[category][type][tableSize++] = id;
+    }
+    return id;
+}
+
+// Add the kinds of a data file. Each line reads
+//   category|type|name|description
+// with a category of harvest, economic, military, resource or population
+// and a type of positive, negative or neutral. Blank lines and lines
+// starting with # are skipped. Returns the number of lines read.
+int EventCatalog::loadFromFile(const string& filename) {
+    ifstream file(filename);
+    if (!file.is_open()) {
+        throw runtime_error("Failed to open event catalog: " + filename);
+    }
+
+    int numLines = 0;
+    int lineNumber = 0;
+    string line;
+    while (getline(file, line)) {
+        lineNumber++;
+        trimString(line);
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+
+        string fields[4];
+        istringstream lineStream(line);
+        int numFields = 0;
+        while (numFields < 4 && getline(lineStream, fields[numFields], numFields < 3 ? '|' : '\n')) {
+            trimString(fields[numFields]);
+            numFields++;
+        }
+        if (numFields < 4 || fields[2].empty()) {
+            throw invalid_argument("Malformed event on line " + to_string(lineNumber) + " of " + filename);
+        }
+
+        int category = 0;
+        while (category < NUM_EVENT_CATEGORIES && fields[0] != categoryNames[category]) {
+            category++;
+        }
+        int type = 0;
+        while (type < 3 && fields[1] != typeNames[type]) {
+            type++;
+        }
+        if (category == NUM_EVENT_CATEGORIES || type == 3) {
+            throw invalid_argument("Unknown event category or type on line " + to_string(lineNumber) + " of " + filename);
+        }
+
+        intern(Symbol(fields[2]), Symbol(fields[3]), static_cast<EventCategory>(category), static_cast<EventType>(type));
+        numLines++;
+    }
+
+    return numLines;
+}
+
+const EventKind& EventCatalog::getKind(int id) {
+    if (id < 0 || id >= numKinds) {
+        throw out_of_range("Event kind id out of range");
+    }
+    return kinds[id];
+}
+
+int EventCatalog::getNumKinds() {
+    return numKinds;
+}
+
+// Pick a kind to draw. With a single kind for the category and type no
+// random number is used, so the built-in catalog draws as before.
+int EventCatalog::chooseKind(EventCategory category, EventType type) {
+    int tableSize = drawTableSizes[category][type];
+    if (tableSize == 0) {
+        throw logic_error("No event kinds for this category and type");
+    }
+    if (tableSize == 1) {
+        return drawTable[category][type][0];
+    }
+    return drawTable[category][type][randomInt(0, tableSize - 1)];
+}
@@ -1,4 +1,4 @@
-#include "Stronghold.h"
+#include "StrongHold.h"
 #include <iostream>
 #include <fstream>
 #include <string>
@@ -8,16 +8,12 @@ using namespace std;
 // Constructor
 GameEngine::GameEngine()
     : isGameRunning(false), isGamePaused(false), gameSpeed(1),
-    difficulty(NORMAL), currentTurn(0), maxKingdoms(5),
-    isMultiplayerMode(false), numHumanPlayers(1), chatbotEnabled(false) {
-
-    // Initialize kingdoms array
-    kingdoms = new Kingdom * [maxKingdoms];
-    numKingdoms = 0;
-
-    for (int i = 0; i < maxKingdoms; i++) {
-        kingdoms[i] = nullptr;
-    }
+    difficulty(NORMAL), currentTurn(0),
+    isMultiplayerMode(false), numHumanPlayers(1), chatbotEnabled(false),
+    isHeadlessMode(false), turnLimit(100), numWorkerThreads(1), threadPool(nullptr),
+    numDeltasSinceSnapshot(0), compactionInterval(10), isSnapshotNeeded(true), autosaveInterval(0), autosaveJob(nullptr),
+    isLazyLoading(false), lazyReader(nullptr), lazySections(nullptr), numLazySections(0), numPendingKingdoms(0), lazySeed(0),
+    turnHistory(nullptr), battleOdds(nullptr) {
 
     // No player kingdom initially
     playerKingdom = nullptr;
@@ -25,13 +21,18 @@ GameEngine::GameEngine()
 
 // Destructor
 GameEngine::~GameEngine() {
+    // An autosave may still be reading the kingdoms
+    waitForAutosave();
+
     // Clean up all kingdoms
-    for (int i = 0; i < numKingdoms; i++) {
+    for (int i = 0; i < kingdoms.size(); i++) {
         delete kingdoms[i];
     }
+    releaseLazyReader();
+    delete turnHistory;
+    delete battleOdds;
 
-    // Delete the array itself
-    delete[] kingdoms;
+    delete threadPool;
 }
 
 // Getters and setters
@@ -87,71 +88,51 @@ void GameEngine::addKingdom(Kingdom* kingdom) {
         throw invalid_argument("Cannot add null kingdom");
     }
 
-    // Check if we need to resize the array
-    if (numKingdoms >= maxKingdoms) {
-        // Create a new, larger array
-        int newMaxKingdoms = maxKingdoms * 2;
-        Kingdom** newKingdoms = new Kingdom * [newMaxKingdoms];
-
-        // Copy existing kingdoms to the new array
-        for (int i = 0; i < numKingdoms; i++) {
-            newKingdoms[i] = kingdoms[i];
-        }
+    waitForAutosave();
 
-        // Initialize remaining slots to nullptr
-        for (int i = numKingdoms; i < newMaxKingdoms; i++) {
-            newKingdoms[i] = nullptr;
-        }
-
-        // Delete the old array and update pointers
-        delete[] kingdoms;
-        kingdoms = newKingdoms;
-        maxKingdoms = newMaxKingdoms;
-    }
-
-    // Add the new kingdom
-    kingdoms[numKingdoms++] = kingdom;
+    kingdoms.add(kingdom);
+    kingdom->attachToStore(&worldStore);
+    isSnapshotNeeded = true;
+    clearTurnHistory();
 }
 
 // Remove a kingdom at a specific index
 void GameEngine::removeKingdom(int index) {
-    if (index < 0 || index >= numKingdoms) {
+    if (index < 0 || index >= kingdoms.size()) {
         throw out_of_range("Kingdom index out of range");
     }
 
+    waitForAutosave();
+    materializeAllKingdoms();
+
     // If this is the player kingdom, update the pointer
     if (kingdoms[index] == playerKingdom) {
         playerKingdom = nullptr;
     }
 
-    // Delete the kingdom object
+    // Delete the kingdom object and close the gap
     delete kingdoms[index];
-
-    // Shift remaining elements
-    for (int i = index; i < numKingdoms - 1; i++) {
-        kingdoms[i] = kingdoms[i + 1];
-    }
-
-    // Set the last position to nullptr and decrement count
-    kingdoms[--numKingdoms] = nullptr;
+    kingdoms.removeAt(index);
+    isSnapshotNeeded = true;
+    clearTurnHistory();
 }
 
-// Get a kingdom at a specific index
-Kingdom* GameEngine::getKingdom(int index) const {
-    if (index < 0 || index >= numKingdoms) {
+// Get a kingdom at a specific index, loading it if it is still pending
+Kingdom* GameEngine::getKingdom(int index) {
+    if (index < 0 || index >= kingdoms.size()) {
         throw out_of_range("Kingdom index out of range");
     }
-    return kingdoms[index];
+    return materializeKingdom(index);
 }
 
 // Get number of kingdoms
 int GameEngine::getNumKingdoms() const {
-    return numKingdoms;
+    return kingdoms.size();
 }
 
 // Start the game
 void GameEngine::startGame() {
-    if (numKingdoms == 0) {
+    if (kingdoms.isEmpty()) {
         cout << "Cannot start game: No kingdoms present" << endl;
         return;
     }
@@ -182,26 +163,59 @@ void GameEngine::processTurn() {
         return;
     }
 
-    cout << "\n=== TURN " << currentTurn << " ===\n" << endl;
+    // Let go of an autosave that has finished
+    if (autosaveJob && autosaveJob->getIsFinished()) {
+        waitForAutosave();
+    }
+
+    // Every kingdom takes its turn, so the pending ones are needed now
+    materializeAllKingdoms();
+
+    // Keep the world as it was before this turn, to rewind to
+    takeTurnSnapshot();
+
+    // Armies change during a turn, so battle odds are only reused within one
+    if (battleOdds) {
+        battleOdds->clearCache();
+    }
+
+    LogLine() << "\n=== TURN " << currentTurn << " ===\n";
+
+    // Process each kingdom's own turn (concurrently when worker threads are enabled)
+    forEachKingdom([](Kingdom* kingdom) {
+        kingdom->processTurn();
+    });
 
-    // Process each kingdom's turn
-    for (int i = 0; i < numKingdoms; i++) {
+    // Effects that cross kingdom boundaries run serially, in kingdom order
+    for (int i = 0; i < kingdoms.size(); i++) {
         if (kingdoms[i]) {
-            kingdoms[i]->processTurn();
+            kingdoms[i]->processCrossKingdomEffects();
         }
     }
 
     // Handle AI decisions for non-player kingdoms
     handleAIDecisions();
 
+    // Write out the turn's messages in kingdom order
+    for (int i = 0; i < kingdoms.size(); i++) {
+        if (kingdoms[i]) {
+            SimulationLog::flush(kingdoms[i]->getLogBuffer());
+        }
+    }
+
     // Check for game ending conditions
     checkGameEndingConditions();
 
     // Increment turn counter
     currentTurn++;
 
+    // Autosave the world as it stands between turns
+    if (autosaveInterval > 0 && (currentTurn - 1) % autosaveInterval == 0) {
+        startAutosave();
+    }
+
     // Pause for player input between turns if it's the player's kingdom
-    if (isGameRunning && playerKingdom) {
+    if (isGameRunning && playerKingdom && !isHeadlessMode) {
         userInterface();
     }
 }
@@ -272,7 +286,7 @@ void GameEngine::displayGameState() const {
 
     // Display information about other kingdoms
     cout << "\nOther Kingdoms:" << endl;
-    for (int i = 0; i < numKingdoms; i++) {
+    for (int i = 0; i < kingdoms.size(); i++) {
         if (kingdoms[i] && kingdoms[i] != playerKingdom) {
             cout << "- " << kingdoms[i]->getName();
 
@@ -299,6 +313,9 @@ void GameEngine::userInterface() {
     cout << "6. Save Game" << endl;
     cout << "7. End Turn" << endl;
     cout << "8. Quit Game" << endl;
+    if (turnHistory && turnHistory->getNumSnapshots() > 0) {
+        cout << "9. Rewind to an Earlier Turn" << endl;
+    }
 
     int choice;
     cout << "Enter your choice: ";
@@ -347,6 +364,15 @@ void GameEngine::userInterface() {
             userInterface(); // Return to menu
         }
         break;
+    case 9:
+        if (turnHistory && turnHistory->getNumSnapshots() > 0) {
+            rewindInterface();
+            userInterface(); // Return to menu
+            break;
+        }
+        cout << "Invalid choice. Please try again." << endl;
+        userInterface(); // Return to menu
+        break;
     default:
         cout << "Invalid choice. Please try again." << endl;
         userInterface(); // Return to menu
@@ -467,7 +493,7 @@ void GameEngine::displayDetailedKingdomInfo() const {
 
         cout << "Military Units:" << endl;
         for (int i = 0; i < army->getNumUnits(); i++) {
-            MilitaryUnit* unit = army->getUnit(i);
+            const MilitaryUnit* unit = army->getUnit(i);
             if (unit) {
                 cout << "- " << unit->getName() << ": " << unit->getCount() << " soldiers"
                     << " (Power: " << unit->calculatePower()
@@ -541,6 +567,9 @@ void GameEngine::economyInterface() {
         return;
     }
 
+    // Tax rates are set per social class
+    playerKingdom->markDirty(COMPONENT_ECONOMY | COMPONENT_POPULATION);
+
     cout << "\n=== ECONOMY MANAGEMENT ===\n" << endl;
     cout << "1. Adjust Tax Rates" << endl;
     cout << "2. Manage Resources" << endl;
@@ -883,6 +912,8 @@ void GameEngine::bankingInterface() {
         return;
     }
 
+    playerKingdom->markDirty(COMPONENT_ECONOMY | COMPONENT_BANK);
+
     bool exitMenu = false;
 
     while (!exitMenu) {
@@ -1493,6 +1524,9 @@ void GameEngine::militaryInterface() {
         return;
     }
 
+    // Recruiting and battles are paid from the treasury
+    playerKingdom->markDirty(COMPONENT_ARMY | COMPONENT_ECONOMY);
+
     bool exitMenu = false;
 
     while (!exitMenu) {
@@ -1537,40 +1571,12 @@ void GameEngine::militaryInterface() {
                 break;
             }
 
-            int cost = 0;
-            string unitName;
-            int attack = 0, defense = 0, speed = 0;
-
-            switch (unitType) {
-            case 1: // Infantry
-                unitName = "Infantry";
-                cost = 50;
-                attack = 10;
-                defense = 15;
-                speed = 5;
-                break;
-            case 2: // Archers
-                unitName = "Archers";
-                cost = 75;
-                attack = 15;
-                defense = 5;
-                speed = 8;
-                break;
-            case 3: // Cavalry
-                unitName = "Cavalry";
-                cost = 100;
-                attack = 20;
-                defense = 10;
-                speed = 15;
-                break;
-            case 4: // Special Forces
-                unitName = "Royal Guards";
-                cost = 150;
-                attack = 25;
-                defense = 20;
-                speed = 10;
-                break;
-            }
+            // Stats come from the recruitable archetypes, in menu order
+            int archetypeId = RECRUIT_INFANTRY + (unitType - 1);
+            const UnitArchetype& archetype = UnitCatalog::getArchetype(archetypeId);
+            int cost = archetype.cost;
+            string unitName(archetype.name.view());
+            int attack = archetype.attack, defense = archetype.defense, speed = archetype.speed;
 
             int quantity;
             cout << "How many " << unitName << " units do you want to recruit? ";
@@ -1608,8 +1614,7 @@ void GameEngine::militaryInterface() {
                     string unitId = unitName + " #" + to_string(army->getNumUnits() + 1);
                     string unitFullName = "Standard " + unitName;
                     int soldierCount = 10; // Default count of soldiers in this unit
-                    MilitaryUnit* unit = new MilitaryUnit(unitId, soldierCount, attack, defense, speed);
-                    army->addUnit(unit);
+                    army->addUnit(MilitaryUnit(unitId, archetypeId, soldierCount));
                 }
 
                 cout << quantity << " " << unitName << " units recruited successfully!" << endl;
@@ -1699,19 +1704,16 @@ void GameEngine::militaryInterface() {
 
                 // Improve individual units
                 for (int i = 0; i < army->getNumUnits(); i++) {
-                    MilitaryUnit* unit = army->getUnit(i);
-                    if (unit) {
-                        int currentAttack = unit->getAttack();
-                        int currentDefense = unit->getDefense();
-
-                        // Increase stats based on strength bonus
-                        int attackIncrease = max(1, currentAttack * strengthBonus / 100);
-                        int defenseIncrease = max(1, currentDefense * strengthBonus / 100);
-
-                        unit->setAttack(currentAttack + attackIncrease);
-                        unit->setDefense(currentDefense + defenseIncrease);
-                        unit->train();
-                    }
+                    const MilitaryUnit* unit = army->getUnit(i);
+                    int currentAttack = unit->getAttack();
+                    int currentDefense = unit->getDefense();
+
+                    // Increase stats based on strength bonus
+                    int attackIncrease = max(1, currentAttack * strengthBonus / 100);
+                    int defenseIncrease = max(1, currentDefense * strengthBonus / 100);
+
+                    army->setUnitStats(i, currentAttack + attackIncrease, currentDefense + defenseIncrease);
+                    army->trainUnit(i);
                 }
 
                 cout << "Army training completed successfully!" << endl;
@@ -1732,7 +1734,7 @@ void GameEngine::militaryInterface() {
 
             cout << "Current units:" << endl;
             for (int i = 0; i < army->getNumUnits(); i++) {
-                MilitaryUnit* unit = army->getUnit(i);
+                const MilitaryUnit* unit = army->getUnit(i);
                 if (unit) {
                     cout << (i + 1) << ". " << unit->getName()
                         << " - Attack: " << unit->getAttack()
@@ -1751,7 +1753,7 @@ void GameEngine::militaryInterface() {
                 break;
             }
 
-            MilitaryUnit* selectedUnit = army->getUnit(unitIndex - 1);
+            const MilitaryUnit* selectedUnit = army->getUnit(unitIndex - 1);
             if (!selectedUnit) {
                 cout << "Invalid unit selection." << endl;
                 break;
@@ -1764,7 +1766,7 @@ void GameEngine::militaryInterface() {
             cin.ignore(1000, '\n');
 
             if (confirm == 1) {
-                string unitName = selectedUnit->getName();
+                string unitName(selectedUnit->getName());
                 army->removeUnit(unitIndex - 1);
                 cout << unitName << " has been disbanded." << endl;
 
@@ -1788,7 +1790,7 @@ void GameEngine::militaryInterface() {
 
             cout << "Current units:" << endl;
             for (int i = 0; i < army->getNumUnits(); i++) {
-                MilitaryUnit* unit = army->getUnit(i);
+                const MilitaryUnit* unit = army->getUnit(i);
                 if (unit) {
                     cout << (i + 1) << ". " << unit->getName() << endl;
                     cout << "   Type: " << unit->getDescription() << endl;
@@ -1803,6 +1805,9 @@ void GameEngine::militaryInterface() {
             break;
         }
         case 5: {
+            // Battles draw from the kingdom's military stream
+            RandomStreamScope battleScope(playerKingdom->getRandomStream(STREAM_MILITARY));
+
             cout << "\n=== PLAN BATTLE ===\n" << endl;
             cout << "Select battle type:" << endl;
             cout << "1. Raid Neighboring Village" << endl;
@@ -1823,38 +1828,42 @@ void GameEngine::militaryInterface() {
             int enemyStrength;
             int goldReward;
             int resourceReward;
-            int casualtyRisk;
 
             switch (battleType) {
             case 1: // Raid
                 battleName = "Raid on Neighboring Village";
                 enemyStrength = army->getTotalStrength() * 0.6;
-                goldReward = 200 + rand() % 300;
-                resourceReward = 50 + rand() % 100;
-                casualtyRisk = 20; // 20% chance of unit loss
+                goldReward = randomInt(200, 499);
+                resourceReward = randomInt(50, 149);
                 break;
             case 2: // Skirmish
                 battleName = "Border Skirmish";
                 enemyStrength = army->getTotalStrength() * 0.9;
-                goldReward = 500 + rand() % 500;
-                resourceReward = 100 + rand() % 200;
-                casualtyRisk = 40; // 40% chance of unit loss
+                goldReward = randomInt(500, 999);
+                resourceReward = randomInt(100, 299);
                 break;
             case 3: // Major Battle
                 battleName = "Major Battle";
                 enemyStrength = army->getTotalStrength() * 1.2;
-                goldReward = 1000 + rand() % 1000;
-                resourceReward = 300 + rand() % 300;
-                casualtyRisk = 60; // 60% chance of unit loss
+                goldReward = randomInt(1000, 1999);
+                resourceReward = randomInt(300, 599);
                 break;
             }
 
+            // Where the battle is fought and the weather it is fought in
+            static const char* terrainNames[] = { "Plains", "Forest", "Mountains", "Desert", "Swamp" };
+            TerrainType terrain = static_cast<TerrainType>(randomInt(PLAINS, SWAMP));
+            Weather* weather = playerKingdom->getCurrentWeather();
+
             cout << "\nBattle plan:" << endl;
             cout << "Type: " << battleName << endl;
+            cout << "Terrain: " << terrainNames[terrain] << endl;
+            if (weather) {
+                cout << "Weather: " << weather->getName() << endl;
+            }
             cout << "Your army strength: " << army->getTotalStrength() << endl;
             cout << "Estimated enemy strength: " << enemyStrength << endl;
             cout << "Potential reward: " << goldReward << " gold, " << resourceReward << " resources" << endl;
-            cout << "Casualty risk: " << casualtyRisk << "%" << endl;
 
             cout << "\nSelect battle strategy:" << endl;
             cout << "1. Aggressive (higher casualties, higher rewards)" << endl;
@@ -1871,39 +1880,52 @@ void GameEngine::militaryInterface() {
                 break;
             }
 
-            // Apply strategy modifiers
-            float strengthMod = 1.0f;
+            // The strategy changes how the army fights; rewards follow it
             float rewardMod = 1.0f;
-            float casualtyMod = 1.0f;
 
             switch (strategy) {
             case 1: // Aggressive
-                strengthMod = 1.2f;
+                army->setStrategy(AGGRESSIVE);
                 rewardMod = 1.3f;
-                casualtyMod = 1.5f;
                 break;
             case 2: // Balanced
-                strengthMod = 1.0f;
+                army->setStrategy(BALANCED);
                 rewardMod = 1.0f;
-                casualtyMod = 1.0f;
                 break;
             case 3: // Defensive
-                strengthMod = 0.8f;
+                army->setStrategy(DEFENSIVE);
                 rewardMod = 0.7f;
-                casualtyMod = 0.6f;
                 break;
             }
 
-            int modifiedStrength = army->getTotalStrength() * strengthMod;
             int modifiedGoldReward = goldReward * rewardMod;
             int modifiedResourceReward = resourceReward * rewardMod;
-            int modifiedCasualtyRisk = casualtyRisk * casualtyMod;
+
+            // The enemy fields a garrison-style army of the estimated strength
+            Army enemy("Enemy Forces");
+            double enemyScale = static_cast<double>(enemyStrength) / max(1, enemy.getTotalStrength());
+            for (int i = 0; i < enemy.getNumUnits(); i++) {
+                enemy.setUnitCount(i, static_cast<int>(enemy.getUnit(i)->getCount() * enemyScale));
+            }
+            enemy.calculateTotalStrength();
+
+            // Odds from many simulated battles, against enemies up to 30%
+            // off the estimate either way
+            if (!battleOdds) {
+                battleOdds = new BattleOdds(max(1, static_cast<int>(thread::hardware_concurrency())));
+            }
+            BattleOddsEstimate odds = battleOdds->estimate(*army, enemy, terrain, weather, 0.3);
 
             cout << "\nFinal battle plan:" << endl;
-            cout << "Effective army strength: " << modifiedStrength << endl;
             cout << "Potential reward: " << modifiedGoldReward << " gold, "
                 << modifiedResourceReward << " resources" << endl;
-            cout << "Casualty risk: " << modifiedCasualtyRisk << "%" << endl;
+            cout << "Chance of victory: " << static_cast<int>(odds.winProbability * 100.0 + 0.5) << "% (+/- "
+                << static_cast<int>(odds.winProbabilityMargin * 100.0 + 0.5) << ")" << endl;
+            cout << "Expected losses: " << static_cast<int>(odds.expectedAttackerCasualties + 0.5) << " (+/- "
+                << static_cast<int>(odds.attackerCasualtiesMargin + 0.5) << ") of your soldiers, "
+                << static_cast<int>(odds.expectedDefenderCasualties + 0.5) << " (+/- "
+                << static_cast<int>(odds.defenderCasualtiesMargin + 0.5) << ") of theirs, from "
+                << odds.numSimulations << " simulated battles" << endl;
 
             cout << "\nCommence battle? (1 for yes, 0 for no): ";
             int confirm;
@@ -1911,12 +1933,37 @@ void GameEngine::militaryInterface() {
             cin.ignore(1000, '\n');
 
             if (confirm == 1) {
+                // The enemy's true size is within 30% of the estimate
+                double sizeError = randomDouble(0.7, 1.3);
+                for (int i = 0; i < enemy.getNumUnits(); i++) {
+                    enemy.setUnitCount(i, static_cast<int>(enemy.getUnit(i)->getCount() * sizeError));
+                }
+                enemy.calculateTotalStrength();
+
                 cout << "\n=== BATTLE COMMENCING ===\n" << endl;
-                cout << "Your forces " << (modifiedStrength > enemyStrength ? "OUTNUMBER" : "are OUTNUMBERED by")
+                cout << "Your forces " << (army->getTotalStrength() > enemy.getTotalStrength() ? "OUTNUMBER" : "are OUTNUMBERED by")
                     << " the enemy." << endl;
 
-                // Determine battle outcome
-                bool victory = modifiedStrength > enemyStrength * (0.7 + static_cast<float>(rand()) / static_cast<float>(RAND_MAX) * 0.6);
+                // Fight it out unit by unit
+                Battle battle(terrain, weather);
+                // The player watches this one, so it is fought unit by unit
+                BattleOutcome outcome = battle.fight(*army, enemy, FIDELITY_DETAILED);
+                bool victory = outcome.isAttackerVictory;
+
+                cout << "The battle lasted " << outcome.numTicks << " rounds. You lost "
+                    << outcome.attackerCasualties << " soldiers; the enemy lost "
+                    << outcome.defenderCasualties << "." << endl;
+
+                // Units with no soldiers left are gone
+                for (int i = 0; i < army->getNumUnits(); i++) {
+                    const MilitaryUnit* unit = army->getUnit(i);
+                    if (unit->getCount() == 0) {
+                        string unitName(unit->getName());
+                        army->removeUnit(i);
+                        cout << "Your unit " << unitName << " was lost in battle." << endl;
+                        i--; // Adjust index after removal
+                    }
+                }
 
                 if (victory) {
                     cout << "\nVICTORY! Your forces have prevailed in " << battleName << "!" << endl;
@@ -1926,7 +1973,7 @@ void GameEngine::militaryInterface() {
 
                     // Add resources
                     if (economy->getNumResources() > 0) {
-                        int resourceIndex = rand() % economy->getNumResources();
+                        int resourceIndex = randomInt(0, economy->getNumResources() - 1);
                         Resource* resource = economy->getResource(resourceIndex);
                         if (resource) {
                             resource->setAmount(resource->getAmount() + modifiedResourceReward);
@@ -1937,17 +1984,6 @@ void GameEngine::militaryInterface() {
 
                     // Boost morale
                     army->setMorale(min(100, army->getMorale() + 10));
-
-                    // Still potentially lose units
-                    for (int i = 0; i < army->getNumUnits(); i++) {
-                        if (rand() % 100 < modifiedCasualtyRisk / 2) { // Half casualty risk for victory
-                            MilitaryUnit* unit = army->getUnit(i);
-                            string unitName = unit->getName();
-                            army->removeUnit(i);
-                            cout << "Your unit " << unitName << " was lost in battle." << endl;
-                            i--; // Adjust index after removal
-                        }
-                    }
                 }
                 else {
                     cout << "\nDEFEAT! Your forces have been defeated in " << battleName << "." << endl;
@@ -1955,26 +1991,12 @@ void GameEngine::militaryInterface() {
                     // Reduce morale
                     army->setMorale(max(10, army->getMorale() - 20));
 
-                    // Higher casualties
-                    for (int i = 0; i < army->getNumUnits(); i++) {
-                        if (rand() % 100 < modifiedCasualtyRisk) {
-                            MilitaryUnit* unit = army->getUnit(i);
-                            string unitName = unit->getName();
-                            army->removeUnit(i);
-                            cout << "Your unit " << unitName << " was lost in battle." << endl;
-                            i--; // Adjust index after removal
-                        }
-                    }
-
                     cout << "You have suffered heavy losses and returned empty-handed." << endl;
                 }
 
                 // Train remaining units regardless of outcome
                 for (int i = 0; i < army->getNumUnits(); i++) {
-                    MilitaryUnit* unit = army->getUnit(i);
-                    if (unit) {
-                        unit->train();
-                    }
+                    army->trainUnit(i);
                 }
 
                 cout << "\nThe battle is over. Your remaining forces have returned to the kingdom." << endl;
@@ -2013,72 +2035,103 @@ void GameEngine::diplomacyInterface() {
     cin.get();
 }
 
+// Rewind interface
+void GameEngine::rewindInterface() {
+    cout << "\nTurns that can be rewound to: " << turnHistory->getOldestTurn()
+        << " to " << turnHistory->getNewestTurn() << endl;
+    cout << "Enter turn: ";
+
+    int turn;
+    cin >> turn;
+    cin.clear();
+    cin.ignore(1000, '\n');
+
+    try {
+        rewindToTurn(turn);
+    }
+    catch (const exception& e) {
+        cout << "Error: " << e.what() << endl;
+        return;
+    }
+    cout << "Rewound to the start of turn " << turn << endl;
+}
+
 // Handle AI decisions for non-player kingdoms
 void GameEngine::handleAIDecisions() {
-    for (int i = 0; i < numKingdoms; i++) {
-        if (kingdoms[i] && kingdoms[i] != playerKingdom) {
-            // AI kingdom logic
-            Kingdom* aiKingdom = kingdoms[i];
-
-            // Random economy decisions
-            Economy* economy = aiKingdom->getEconomy();
-            if (economy) {
-                // Adjust production based on resources
-                int productionChange = randomInt(-5, 10);
-                economy->setProductionLevel(max(10, economy->getProductionLevel() + productionChange));
-
-                // Adjust trade based on market conditions
-                int tradeChange = randomInt(-5, 10);
-                economy->setTradeLevel(max(10, economy->getTradeLevel() + tradeChange));
-
-                // Random resource management
-                for (int r = 0; r < economy->getNumResources(); r++) {
-                    Resource* resource = economy->getResource(r);
-                    if (resource) {
-                        // AI might adjust gather rates based on needs
-                        int gatherAdjustment = randomInt(-2, 5);
-                        resource->adjustGatherRate(gatherAdjustment);
-                    }
-                }
-            }
+    forEachKingdom([this](Kingdom* kingdom) {
+        // In headless mode the tracked kingdom is AI-driven as well
+        if (kingdom != playerKingdom || isHeadlessMode) {
+            handleAIDecisions(kingdom);
+        }
+    });
+}
 
-            // Military decisions
-            Army* army = aiKingdom->getArmy();
-            if (army) {
-                // Randomly adjust military strategy
-                int strategyChoice = randomInt(0, 3);
-                army->setStrategy(static_cast<CombatStrategy>(strategyChoice));
+// Make one turn of decisions for a single AI kingdom
+void GameEngine::handleAIDecisions(Kingdom* aiKingdom) {
+    if (!aiKingdom) return;
 
-                // Random training adjustments
-                int trainingChange = randomInt(-3, 7);
-                army->setTrainingLevel(max(10, army->getTrainingLevel() + trainingChange));
-            }
+    // Decisions draw from the kingdom's AI stream
+    RandomStreamScope randomScope(aiKingdom->getRandomStream(STREAM_AI));
+    LogBufferScope logScope(aiKingdom->getLogBuffer());
+    aiKingdom->markDirty(COMPONENT_ECONOMY | COMPONENT_ARMY | COMPONENT_LEADERSHIP | COMPONENT_POPULATION);
 
-            // Leadership decisions
-            Leader* leader = aiKingdom->getCurrentLeader();
-            if (leader) {
-                // Leaders gain experience over time
-                leader->incrementExperience();
-                leader->calculateLeadershipScore();
-            }
+    // Random economy decisions
+    Economy* economy = aiKingdom->getEconomy();
+    if (economy) {
+        // Adjust production based on resources
+        int productionChange = randomInt(-5, 10);
+        economy->setProductionLevel(max(10, economy->getProductionLevel() + productionChange));
 
-            // Population decisions
-            Population* population = aiKingdom->getPopulation();
-            if (population) {
-                // Adjust growth rate based on resources
-                int growthChange = randomInt(-1, 2);
-                population->setGrowthRate(max(0, population->getGrowthRate() + growthChange));
-            }
+        // Adjust trade based on market conditions
+        int tradeChange = randomInt(-5, 10);
+        economy->setTradeLevel(max(10, economy->getTradeLevel() + tradeChange));
 
-            // Decision to attack player?
-            if (randomInt(1, 100) <= 10) { // 10% chance to attack player
-                if (army && army->getTotalStrength() > 100) {
-                    cout << aiKingdom->getName() << " is preparing for potential military action!" << endl;
-                    // Actual attack would be implemented in processTurn
-                }
+        // Random resource management
+        for (int r = 0; r < economy->getNumResources(); r++) {
+            Resource* resource = economy->getResource(r);
+            if (resource) {
+                // AI might adjust gather rates based on needs
+                int gatherAdjustment = randomInt(-2, 5);
+                resource->adjustGatherRate(gatherAdjustment);
             }
         }
     }
+
+    // Military decisions
+    Army* army = aiKingdom->getArmy();
+    if (army) {
+        // Randomly adjust military strategy
+        int strategyChoice = randomInt(0, 3);
+        army->setStrategy(static_cast<CombatStrategy>(strategyChoice));
+
+        // Random training adjustments
+        int trainingChange = randomInt(-3, 7);
+        army->setTrainingLevel(max(10, army->getTrainingLevel() + trainingChange));
+    }
+
+    // Leadership decisions
+    Leader* leader = aiKingdom->getCurrentLeader();
+    if (leader) {
+        // Leaders gain experience over time
+        leader->incrementExperience();
+        leader->calculateLeadershipScore();
+    }
+
+    // Population decisions
+    Population* population = aiKingdom->getPopulation();
+    if (population) {
+        // Adjust growth rate based on resources
+        int growthChange = randomInt(-1, 2);
+        population->setGrowthRate(max(0, population->getGrowthRate() + growthChange));
+    }
+
+    // Decision to attack player?
+    if (randomInt(1, 100) <= 10) { // 10% chance to attack player
+        if (army && army->getTotalStrength() > 100) {
+            LogLine() << aiKingdom->getName() << " is preparing for potential military action!";
+            // Actual attack would be implemented in processTurn
+        }
+    }
 }
 
 // Generate AI response to player input (chatbot functionality)
@@ -2157,36 +2210,37 @@ void GameEngine::processChatMessage(const string& message, int fromPlayerId, int
 // Check for game ending conditions
 void GameEngine::checkGameEndingConditions() {
     if (!playerKingdom) {
-        cout << "Game over: Player kingdom has been destroyed!" << endl;
+        LogLine(LOG_WARNING) << "Game over: Player kingdom has been destroyed!";
         isGameRunning = false;
         return;
     }
 
     // Check for victory conditions (example: all other kingdoms conquered)
+    materializeAllKingdoms();
     bool allOthersDefeated = true;
-    for (int i = 0; i < numKingdoms; i++) {
+    for (int i = 0; i < kingdoms.size(); i++) {
         if (kingdoms[i] && kingdoms[i] != playerKingdom) {
             allOthersDefeated = false;
             break;
         }
     }
 
-    if (allOthersDefeated && numKingdoms > 1) {
-        cout << "Victory! You have conquered all other kingdoms!" << endl;
+    if (allOthersDefeated && kingdoms.size() > 1) {
+        LogLine() << "Victory! You have conquered all other kingdoms!";
         isGameRunning = false;
         return;
     }
 
     // Check for defeat conditions (example: stability too low)
     if (playerKingdom->getStabilityLevel() <= 10) {
-        cout << "Your kingdom is on the brink of collapse due to low stability!" << endl;
+        LogLine(LOG_WARNING) << "Your kingdom is on the brink of collapse due to low stability!";
         // This is just a warning, not game over yet
     }
 
     // Optional turn limit
-    if (currentTurn >= 100) {
-        cout << "You have reached the maximum number of turns (100)!" << endl;
-        cout << "Final Score: " << calculateFinalScore() << endl;
+    if (currentTurn >= turnLimit) {
+        LogLine() << "You have reached the maximum number of turns (" << turnLimit << ")!";
+        LogLine() << "Final Score: " << calculateFinalScore();
         isGameRunning = false;
         return;
     }
@@ -2255,12 +2309,27 @@ void GameEngine::saveGame(const string& filename) {
         }
     }
 
+    // Files named *.shb are written in the binary format
+    if (saveFilename.size() > 4 && saveFilename.compare(saveFilename.size() - 4, 4, ".shb") == 0) {
+        try {
+            saveGameBinary(saveFilename);
+        }
+        catch (const exception& e) {
+            cout << "Error: " << e.what() << endl;
+            return;
+        }
+        cout << "Game saved successfully to " << saveFilename << endl;
+        return;
+    }
+
     ofstream saveFile(saveFilename);
     if (!saveFile.is_open()) {
         cout << "Error: Could not open file for saving: " << saveFilename << endl;
         return;
     }
 
+    materializeAllKingdoms();
+
     // Save game engine state
     saveFile << isGameRunning << endl;
     saveFile << isGamePaused << endl;
@@ -2269,11 +2338,11 @@ void GameEngine::saveGame(const string& filename) {
     saveFile << currentTurn << endl;
 
     // Save kingdoms
-    saveFile << numKingdoms << endl;
+    saveFile << kingdoms.size() << endl;
 
     // Save player kingdom index
     int playerKingdomIndex = -1;
-    for (int i = 0; i < numKingdoms; i++) {
+    for (int i = 0; i < kingdoms.size(); i++) {
         if (kingdoms[i] == playerKingdom) {
             playerKingdomIndex = i;
             break;
@@ -2282,7 +2351,7 @@ void GameEngine::saveGame(const string& filename) {
     saveFile << playerKingdomIndex << endl;
 
     // Save each kingdom
-    for (int i = 0; i < numKingdoms; i++) {
+    for (int i = 0; i < kingdoms.size(); i++) {
         kingdoms[i]->save(saveFile);
     }
 
@@ -2295,6 +2364,239 @@ void GameEngine::saveGame() {
     saveGame("");
 }
 
+// Save the game in the binary format: one section for the engine state,
+// then one per kingdom
+void GameEngine::saveGameBinary(const string& filename) {
+    materializeAllKingdoms();
+
+    SaveWriter writer;
+    writeGameSection(writer);
+
+    for (int i = 0; i < kingdoms.size(); i++) {
+        writer.beginSection(SECTION_KINGDOM);
+        kingdoms[i]->saveBinary(writer);
+        writer.endSection();
+    }
+
+    writer.writeToFile(filename);
+
+    // A full save replaces the deltas that built on the old file
+    remove((filename + ".delta").c_str());
+}
+
+// The engine state that starts every binary save
+void GameEngine::writeGameSection(SaveWriter& writer) const {
+    int playerKingdomIndex = -1;
+    for (int i = 0; i < kingdoms.size(); i++) {
+        if (kingdoms[i] == playerKingdom) {
+            playerKingdomIndex = i;
+            break;
+        }
+    }
+
+    writer.beginSection(SECTION_GAME);
+    writer.writeBool(isGameRunning);
+    writer.writeBool(isGamePaused);
+    writer.writeInt(gameSpeed);
+    writer.writeInt(static_cast<int>(difficulty));
+    writer.writeInt(currentTurn);
+    writer.writeInt(kingdoms.size());
+    writer.writeInt(playerKingdomIndex);
+    writer.endSection();
+}
+
+// Save a checkpoint. The first one, and every compactionInterval-th after
+// it, is a full snapshot in filename; the others append just the kingdom
+// components changed since the previous checkpoint to filename.delta.
+void GameEngine::saveCheckpoint(const string& filename) {
+    if (filename != checkpointFilename || isSnapshotNeeded || numDeltasSinceSnapshot >= compactionInterval) {
+        saveGameBinary(filename);
+        checkpointFilename = filename;
+        numDeltasSinceSnapshot = 0;
+        isSnapshotNeeded = false;
+    }
+    else {
+        SaveWriter writer;
+        writeGameSection(writer);
+
+        // Kingdoms still pending are as the snapshot has them
+        for (int i = 0; i < kingdoms.size(); i++) {
+            unsigned int components = kingdoms[i] ? kingdoms[i]->getDirtyComponents() : 0;
+            if (components == 0) {
+                continue;
+            }
+            writer.beginSection(SECTION_KINGDOM_DELTA);
+            writer.writeInt(i);
+            writer.writeInt(static_cast<int>(components));
+            kingdoms[i]->saveComponentsBinary(writer, components);
+            writer.endSection();
+        }
+
+        writer.appendToFile(filename + ".delta");
+        numDeltasSinceSnapshot++;
+    }
+
+    for (int i = 0; i < kingdoms.size(); i++) {
+        if (kingdoms[i]) {
+            kingdoms[i]->clearDirtyComponents();
+        }
+    }
+}
+
+int GameEngine::getCompactionInterval() const {
+    return compactionInterval;
+}
+
+void GameEngine::setCompactionInterval(int numDeltas) {
+    if (numDeltas < 0) {
+        throw invalid_argument("Compaction interval cannot be negative");
+    }
+    compactionInterval = numDeltas;
+}
+
+// Autosave to a binary save file every interval turns; 0 turns it off
+void GameEngine::setAutosave(const string& filename, int interval) {
+    if (interval < 0) {
+        throw invalid_argument("Autosave interval cannot be negative");
+    }
+    if (interval > 0 && filename.empty()) {
+        throw invalid_argument("Autosave needs a file name");
+    }
+    autosaveFilename = filename;
+    autosaveInterval = interval;
+}
+
+int GameEngine::getAutosaveInterval() const {
+    return autosaveInterval;
+}
+
+// Start an autosave of the world as it stands. The kingdoms are written
+// out on a background thread while the next turn runs.
+void GameEngine::startAutosave() {
+    waitForAutosave();
+    materializeAllKingdoms();
+
+    autosaveJob = new AutosaveJob(autosaveFilename, *this);
+
+    // Players change their kingdoms from the menus, outside any turn
+    if (!isHeadlessMode) {
+        for (int i = 0; i < kingdoms.size(); i++) {
+            if (kingdoms[i] == playerKingdom || kingdoms[i]->getIsPlayerControlled()) {
+                autosaveJob->claim(i);
+            }
+        }
+    }
+
+    autosaveJob->start();
+}
+
+int GameEngine::getTurnHistoryDepth() const {
+    return turnHistory ? turnHistory->getCapacity() : 0;
+}
+
+// Keep snapshots of the last numTurns turns in memory; 0 turns it off
+void GameEngine::setTurnHistoryDepth(int numTurns) {
+    if (numTurns < 0) {
+        throw invalid_argument("Turn history depth cannot be negative");
+    }
+    if (numTurns == getTurnHistoryDepth()) {
+        return;
+    }
+
+    delete turnHistory;
+    turnHistory = (numTurns > 0) ? new TurnHistory(numTurns) : nullptr;
+}
+
+const TurnHistory* GameEngine::getTurnHistory() const {
+    return turnHistory;
+}
+
+// Snapshot the world at the start of a turn: the engine state, then every
+// kingdom with what saves leave out
+void GameEngine::takeTurnSnapshot() {
+    if (!turnHistory) {
+        return;
+    }
+
+    SaveWriter& writer = turnHistory->beginSnapshot(currentTurn);
+    writeGameSection(writer);
+    for (int i = 0; i < kingdoms.size(); i++) {
+        writer.beginSection(SECTION_KINGDOM);
+        kingdoms[i]->saveSnapshot(writer);
+        writer.endSection();
+    }
+}
+
+// Snapshots stop matching once kingdoms come or go
+void GameEngine::clearTurnHistory() {
+    if (turnHistory) {
+        turnHistory->clear();
+    }
+}
+
+// Put the world back as it was at the start of a turn that is still in the
+// history. Later snapshots are dropped; the turn's own is kept, so the game
+// can be rewound to it again.
+void GameEngine::rewindToTurn(int turn) {
+    const SaveWriter* snapshot = turnHistory ? turnHistory->findSnapshot(turn) : nullptr;
+    if (!snapshot) {
+        throw out_of_range("No snapshot of turn " + to_string(turn));
+    }
+
+    waitForAutosave();
+
+    SaveReader reader(*snapshot);
+    reader.openSection(0);
+    bool snapshotIsGameRunning = reader.readBool();
+    bool snapshotIsGamePaused = reader.readBool();
+    int snapshotGameSpeed = reader.readInt();
+    int difficultyInt = reader.readInt();
+    int snapshotCurrentTurn = reader.readInt();
+    int snapshotNumKingdoms = reader.readInt();
+    int playerKingdomIndex = reader.readInt();
+    if (snapshotNumKingdoms != kingdoms.size() || reader.getNumSections() != snapshotNumKingdoms + 1) {
+        throw logic_error("Turn snapshot does not match the kingdoms");
+    }
+
+    for (int i = 0; i < kingdoms.size(); i++) {
+        reader.openSection(i + 1);
+        kingdoms[i]->restoreSnapshot(reader);
+    }
+
+    isGameRunning = snapshotIsGameRunning;
+    isGamePaused = snapshotIsGamePaused;
+    gameSpeed = snapshotGameSpeed;
+    difficulty = static_cast<GameDifficulty>(difficultyInt);
+    currentTurn = snapshotCurrentTurn;
+    playerKingdom = (playerKingdomIndex >= 0) ? kingdoms[playerKingdomIndex] : nullptr;
+
+    turnHistory->dropNewerThan(turn);
+    isSnapshotNeeded = true;
+}
+
+// Block until the latest autosave has been written
+void GameEngine::waitForAutosave() {
+    if (autosaveJob) {
+        autosaveJob->wait();
+        delete autosaveJob;
+        autosaveJob = nullptr;
+    }
+}
+
+bool GameEngine::getIsLazyLoading() const {
+    return isLazyLoading;
+}
+
+// Have later binary loads read kingdoms on first use instead of all at once
+void GameEngine::setLazyLoading(bool lazy) {
+    isLazyLoading = lazy;
+}
+
+// Kingdoms of a lazy load that have not been read yet
+int GameEngine::getNumPendingKingdoms() const {
+    return numPendingKingdoms;
+}
+
 // New GameEngine getters and setters for multiplayer
 bool GameEngine::getIsMultiplayerMode() const {
     return isMultiplayerMode;
@@ -2322,6 +2624,68 @@ void GameEngine::setChatbotEnabled(bool enabled) {
     chatbotEnabled = enabled;
 }
 
+bool GameEngine::getIsHeadlessMode() const {
+    return isHeadlessMode;
+}
+
+void GameEngine::setIsHeadlessMode(bool headless) {
+    isHeadlessMode = headless;
+}
+
+int GameEngine::getNumWorkerThreads() const {
+    return numWorkerThreads;
+}
+
+// Use more than one thread to process kingdom turns. Each kingdom draws from
+// its own random state, so the outcome is the same for any thread count.
+void GameEngine::setNumWorkerThreads(int threads) {
+    if (threads < 1) threads = 1;
+    if (threads == numWorkerThreads) return;
+
+    delete threadPool;
+    threadPool = nullptr;
+
+    numWorkerThreads = threads;
+    if (numWorkerThreads > 1) {
+        threadPool = new ThreadPool(numWorkerThreads);
+    }
+}
+
+// Apply an action to every kingdom, spread over the worker threads if enabled
+// The action may change the kingdom, so a running autosave gets its copy
+// of the kingdom first
+void GameEngine::forEachKingdom(const function<void(Kingdom*)>& action) {
+    if (!threadPool) {
+        for (int i = 0; i < kingdoms.size(); i++) {
+            if (kingdoms[i]) {
+                if (autosaveJob) {
+                    autosaveJob->claim(i);
+                }
+                action(kingdoms[i]);
+            }
+        }
+        return;
+    }
+
+    threadPool->parallelFor(kingdoms.size(), [this, &action](int index) {
+        if (kingdoms[index]) {
+            if (autosaveJob) {
+                autosaveJob->claim(index);
+            }
+            action(kingdoms[index]);
+        }
+    });
+}
+
+int GameEngine::getTurnLimit() const {
+    return turnLimit;
+}
+
+void GameEngine::setTurnLimit(int limit) {
+    if (limit < 1) limit = 1;
+    turnLimit = limit;
+}
+
 // Multiplayer setup
 void GameEngine::setupMultiplayerGame(int numPlayers) {
     if (numPlayers < 2) {
@@ -2336,11 +2700,12 @@ void GameEngine::setupMultiplayerGame(int numPlayers) {
     cout << "Number of human players: " << numHumanPlayers << endl;
 
     // Clean up existing kingdoms
-    for (int i = 0; i < numKingdoms; i++) {
+    waitForAutosave();
+    for (int i = 0; i < kingdoms.size(); i++) {
         delete kingdoms[i];
-        kingdoms[i] = nullptr;
     }
-    numKingdoms = 0;
+    kingdoms.clear();
+    releaseLazyReader();
     playerKingdom = nullptr;
 
     // Create kingdoms for each player
@@ -2426,7 +2791,7 @@ void GameEngine::setupMultiplayerGame(int numPlayers) {
     // Enable chatbot
     setChatbotEnabled(true);
 
-    cout << "\nMultiplayer game setup complete! " << numKingdoms << " kingdoms created." << endl;
+    cout << "\nMultiplayer game setup complete! " << kingdoms.size() << " kingdoms created." << endl;
     cout << "\nPress Enter to begin the game...";
     cin.get();
 
@@ -2435,11 +2800,11 @@ void GameEngine::setupMultiplayerGame(int numPlayers) {
 
 // Handle player turn in multiplayer
 void GameEngine::processPlayerTurn(int playerId) {
-    if (playerId < 0 || playerId >= numKingdoms) {
+    if (playerId < 0 || playerId >= kingdoms.size()) {
         return;
     }
 
-    Kingdom* currentPlayerKingdom = kingdoms[playerId];
+    Kingdom* currentPlayerKingdom = materializeKingdom(playerId);
     if (!currentPlayerKingdom) {
         return;
     }
@@ -2482,9 +2847,10 @@ void GameEngine::handlePlayerChat() {
 
     if (isMultiplayerMode) {
         cout << "Available players:" << endl;
-        for (int i = 0; i < numKingdoms; i++) {
-            if (kingdoms[i]) {
-                cout << i << ". " << kingdoms[i]->getName() << endl;
+        for (int i = 0; i < kingdoms.size(); i++) {
+            Kingdom* kingdom = materializeKingdom(i);
+            if (kingdom) {
+                cout << i << ". " << kingdom->getName() << endl;
             }
         }
         cout << "-1. Royal Advisor (AI)" << endl;
@@ -2520,20 +2886,110 @@ string GameEngine::getChatbotResponse(const string& message) {
     return response;
 }
 
-// Load the game from a file
+// Set up a game made only of AI-controlled kingdoms (no console input)
+void GameEngine::setupHeadlessGame(int numAIKingdoms) {
+    if (numAIKingdoms < 1) {
+        throw invalid_argument("Headless game requires at least one kingdom");
+    }
+
+    // Clean up existing kingdoms
+    waitForAutosave();
+    for (int i = 0; i < kingdoms.size(); i++) {
+        delete kingdoms[i];
+    }
+    kingdoms.clear();
+    releaseLazyReader();
+    playerKingdom = nullptr;
+
+    setIsHeadlessMode(true);
+    worldStore.reserve(numAIKingdoms);
+
+    for (int i = 0; i < numAIKingdoms; i++) {
+        // Create an AI-controlled kingdom
+        Kingdom* aiKingdom = new Kingdom("AI Kingdom " + to_string(i + 1), false);
+        Leader* aiLeader = new Leader("AI Ruler " + to_string(i + 1), "King");
+        aiLeader->setIntelligence(randomInt(60, 90));
+        aiLeader->setMilitarySkill(randomInt(60, 90));
+        aiLeader->setEconomicSkill(randomInt(60, 90));
+        aiKingdom->setCurrentLeader(aiLeader);
+
+        addKingdom(aiKingdom);
+    }
+
+    // The first kingdom is tracked for scoring and ending conditions
+    setPlayerKingdom(kingdoms[0]);
+}
+
+// Run up to numTurns turns without any user interaction
+int GameEngine::runHeadless(int numTurns) {
+    if (kingdoms.isEmpty() || !playerKingdom) {
+        throw runtime_error("Cannot run headless game: No kingdoms present");
+    }
+
+    setIsHeadlessMode(true);
+
+    isGameRunning = true;
+    isGamePaused = false;
+    if (currentTurn < 1) {
+        currentTurn = 1;
+    }
+
+    // Let the requested number of turns run before the turn limit ends the game
+    setTurnLimit(currentTurn + numTurns);
+
+    int turnsRun = 0;
+    while (isGameRunning && turnsRun < numTurns) {
+        processTurn();
+        turnsRun++;
+    }
+
+    return turnsRun;
+}
+
+// Write the turn phase timings of all kingdoms combined
+void GameEngine::writeProfileReport(ostream& out) const {
+    TurnProfile combinedProfile;
+    for (int i = 0; i < kingdoms.size(); i++) {
+        if (kingdoms[i] && kingdoms[i]->getTurnProfile()) {
+            combinedProfile.merge(*kingdoms[i]->getTurnProfile());
+        }
+    }
+
+    combinedProfile.writeReport(out);
+}
+
+// Totals and averages over the scalar state of all kingdoms
+WorldSummary GameEngine::summarizeWorld() {
+    materializeAllKingdoms();
+    return worldStore.summarize();
+}
+
+// Load the game from a file in either format
 void GameEngine::loadGame(const string& filename) {
+    // An autosave may still be reading the kingdoms being replaced
+    waitForAutosave();
+
+    if (SaveReader::isBinarySave(filename)) {
+        loadGameBinary(filename);
+        applyDeltaLog(filename);
+        cout << "Game loaded successfully from " << filename << endl;
+        return;
+    }
+
     ifstream loadFile(filename);
     if (!loadFile.is_open()) {
         throw runtime_error("Could not open file for loading: " + filename);
     }
 
     // Clean up existing kingdoms
-    for (int i = 0; i < numKingdoms; i++) {
+    for (int i = 0; i < kingdoms.size(); i++) {
         delete kingdoms[i];
-        kingdoms[i] = nullptr;
     }
-    numKingdoms = 0;
+    kingdoms.clear();
+    releaseLazyReader();
     playerKingdom = nullptr;
+    isSnapshotNeeded = true;
+    clearTurnHistory();
 
     // Load game engine state
     loadFile >> isGameRunning;
@@ -2556,22 +3012,15 @@ void GameEngine::loadGame(const string& filename) {
     loadFile.ignore(); // Skip newline
 
     // Ensure we have enough space for kingdoms
-    if (loadedNumKingdoms > maxKingdoms) {
-        delete[] kingdoms;
-        maxKingdoms = loadedNumKingdoms;
-        kingdoms = new Kingdom * [maxKingdoms];
-
-        for (int i = 0; i < maxKingdoms; i++) {
-            kingdoms[i] = nullptr;
-        }
-    }
+    kingdoms.reserve(loadedNumKingdoms);
 
     // Load each kingdom
     for (int i = 0; i < loadedNumKingdoms; i++) {
         // Create a new kingdom
-        kingdoms[i] = new Kingdom("", false);
-        kingdoms[i]->load(loadFile);
-        numKingdoms++;
+        Kingdom* kingdom = new Kingdom("", false);
+        kingdoms.add(kingdom);
+        kingdom->attachToStore(&worldStore);
+        kingdom->load(loadFile);
 
         // Set player kingdom if this is the player kingdom
         if (i == playerKingdomIndex) {
@@ -2581,4 +3030,208 @@ void GameEngine::loadGame(const string& filename) {
 
     loadFile.close();
     cout << "Game loaded successfully from " << filename << endl;
-}
\ No newline at end of file
+}
+
+// Load a game saved in the binary format. With lazy loading on, only the
+// player's kingdom is read now and the rest stay in the mapped file until
+// getKingdom or the next turn needs them.
+void GameEngine::loadGameBinary(const string& filename) {
+    waitForAutosave();
+
+    // Checks the header and tables before the current game is touched.
+    // The section table is the index of where each kingdom starts.
+    SaveReader* reader = new SaveReader(filename);
+    int* kingdomSections = new int[max(reader->getNumSections(), 1)];
+    int numKingdomSections = 0;
+    int gameSection = -1;
+    bool loadedIsGameRunning;
+    bool loadedIsGamePaused;
+    int loadedGameSpeed;
+    int difficultyInt;
+    int loadedCurrentTurn;
+    int playerKingdomIndex;
+    try {
+        for (int i = 0; i < reader->getNumSections(); i++) {
+            if (reader->getSectionType(i) == SECTION_GAME && gameSection < 0) {
+                gameSection = i;
+            }
+            else if (reader->getSectionType(i) == SECTION_KINGDOM) {
+                kingdomSections[numKingdomSections++] = i;
+            }
+        }
+        if (gameSection < 0) {
+            throw runtime_error("Missing game section in " + filename);
+        }
+
+        reader->openSection(gameSection);
+        loadedIsGameRunning = reader->readBool();
+        loadedIsGamePaused = reader->readBool();
+        loadedGameSpeed = reader->readInt();
+        difficultyInt = reader->readInt();
+        loadedCurrentTurn = reader->readInt();
+        int loadedNumKingdoms = reader->readInt();
+        playerKingdomIndex = reader->readInt();
+        if (loadedNumKingdoms != numKingdomSections) {
+            throw runtime_error("Kingdom count does not match the sections in " + filename);
+        }
+    }
+    catch (...) {
+        delete[] kingdomSections;
+        delete reader;
+        throw;
+    }
+
+    // Clean up existing kingdoms
+    for (int i = 0; i < kingdoms.size(); i++) {
+        delete kingdoms[i];
+    }
+    kingdoms.clear();
+    releaseLazyReader();
+    playerKingdom = nullptr;
+    isSnapshotNeeded = true;
+    clearTurnHistory();
+
+    isGameRunning = loadedIsGameRunning;
+    isGamePaused = loadedIsGamePaused;
+    gameSpeed = loadedGameSpeed;
+    difficulty = static_cast<GameDifficulty>(difficultyInt);
+    currentTurn = loadedCurrentTurn;
+
+    kingdoms.reserve(numKingdomSections);
+
+    if (isLazyLoading && numKingdomSections > 0) {
+        for (int i = 0; i < numKingdomSections; i++) {
+            kingdoms.add(nullptr);
+        }
+        lazyReader = reader;
+        lazySections = kingdomSections;
+        numLazySections = numKingdomSections;
+        numPendingKingdoms = numKingdomSections;
+        lazySeed = randomSeed();
+
+        if (playerKingdomIndex >= 0 && playerKingdomIndex < numKingdomSections) {
+            playerKingdom = materializeKingdom(playerKingdomIndex);
+        }
+        return;
+    }
+
+    // Load each kingdom from its own section
+    for (int i = 0; i < numKingdomSections; i++) {
+        Kingdom* kingdom = new Kingdom("", false);
+        kingdoms.add(kingdom);
+        kingdom->attachToStore(&worldStore);
+        reader->openSection(kingdomSections[i]);
+        kingdom->loadBinary(*reader);
+
+        if (i == playerKingdomIndex) {
+            playerKingdom = kingdom;
+        }
+    }
+
+    delete[] kingdomSections;
+    delete reader;
+}
+
+// The kingdom at index, read from the save first if it is still pending.
+// Each pending kingdom loads with a random state of its own, so the order
+// in which kingdoms are first used does not change the game.
+Kingdom* GameEngine::materializeKingdom(int index) {
+    if (index >= numLazySections || lazySections[index] < 0) {
+        return kingdoms[index];
+    }
+
+    RandomGenerator loadGenerator(lazySeed, index);
+    RandomStreamScope loadScope(&loadGenerator);
+
+    Kingdom* kingdom = new Kingdom("", false);
+    kingdoms[index] = kingdom;
+    kingdom->attachToStore(&worldStore);
+    lazyReader->openSection(lazySections[index]);
+    lazySections[index] = -1;
+    kingdom->loadBinary(*lazyReader);
+
+    // The file can go once nothing is left to read from it
+    if (--numPendingKingdoms == 0) {
+        releaseLazyReader();
+    }
+    return kingdom;
+}
+
+// Load every pending kingdom, in index order
+void GameEngine::materializeAllKingdoms() {
+    for (int i = 0; i < numLazySections && numPendingKingdoms > 0; i++) {
+        materializeKingdom(i);
+    }
+}
+
+void GameEngine::releaseLazyReader() {
+    delete lazyReader;
+    lazyReader = nullptr;
+    delete[] lazySections;
+    lazySections = nullptr;
+    numLazySections = 0;
+    numPendingKingdoms = 0;
+}
+
+// Replay the delta checkpoints appended to a binary save, oldest first
+void GameEngine::applyDeltaLog(const string& filename) {
+    waitForAutosave();
+
+    string deltaFilename = filename + ".delta";
+    if (!ifstream(deltaFilename).is_open()) {
+        return;
+    }
+
+    MappedFile deltaFile(deltaFilename);
+    size_t offset = 0;
+    while (offset < deltaFile.getSize()) {
+        size_t available = deltaFile.getSize() - offset;
+        size_t imageSize = SaveReader::findImageSize(deltaFile.getData() + offset, available);
+
+        // A checkpoint cut short while it was being written is dropped
+        if (imageSize == 0 || imageSize > available) {
+            cout << "Warning: Ignoring an incomplete checkpoint at the end of " << deltaFilename << endl;
+            break;
+        }
+
+        SaveReader reader(deltaFile, offset);
+        offset += imageSize;
+
+        if (reader.getNumSections() == 0 || reader.getSectionType(0) != SECTION_GAME) {
+            throw runtime_error("Missing game section in " + deltaFilename);
+        }
+
+        reader.openSection(0);
+        bool loadedIsGameRunning = reader.readBool();
+        bool loadedIsGamePaused = reader.readBool();
+        int loadedGameSpeed = reader.readInt();
+        int difficultyInt = reader.readInt();
+        int loadedCurrentTurn = reader.readInt();
+        int loadedNumKingdoms = reader.readInt();
+        int playerKingdomIndex = reader.readInt();
+        if (loadedNumKingdoms != kingdoms.size()) {
+            throw runtime_error("Checkpoint does not match the kingdoms of " + filename);
+        }
+
+        for (int i = 1; i < reader.getNumSections(); i++) {
+            if (reader.getSectionType(i) != SECTION_KINGDOM_DELTA) {
+                continue;
+            }
+
+            reader.openSection(i);
+            int index = reader.readInt();
+            unsigned int components = static_cast<unsigned int>(reader.readInt());
+            if (index < 0 || index >= kingdoms.size() || (components & ~ALL_KINGDOM_COMPONENTS) != 0) {
+                throw runtime_error("Corrupt kingdom checkpoint in " + deltaFilename);
+            }
+            materializeKingdom(index)->loadComponentsBinary(reader, components);
+        }
+
+        isGameRunning = loadedIsGameRunning;
+        isGamePaused = loadedIsGamePaused;
+        gameSpeed = loadedGameSpeed;
+        difficulty = static_cast<GameDifficulty>(difficultyInt);
+        currentTurn = loadedCurrentTurn;
+        playerKingdom = (playerKingdomIndex >= 0 && playerKingdomIndex < kingdoms.size()) ? materializeKingdom(playerKingdomIndex) : nullptr;
+    }
+}
@@ -1,4 +1,4 @@
-#include "Stronghold.h"
+#include "StrongHold.h"
 #include <iostream>
 #include <string>
 #include <ctime>
@@ -6,6 +6,83 @@
 
 using namespace std;
 
+// Master generator used when no kingdom stream is bound (main thread only)
+static unsigned long long masterSeed = 0;
+static RandomGenerator masterGenerator;
+
+// Generator bound to the current thread, or nullptr to use the master generator
+static thread_local RandomGenerator* activeGenerator = nullptr;
+
+// Constructor
+RandomGenerator::RandomGenerator(unsigned long long seed, unsigned long long stream)
+    : state(0), increment(1) {
+    this->seed(seed, stream);
+}
+
+void RandomGenerator::seed(unsigned long long seed, unsigned long long stream) {
+    state = 0;
+    increment = (stream << 1u) | 1u;
+    next();
+    state += seed;
+    next();
+}
+
+// Next 32 random bits
+unsigned int RandomGenerator::next() {
+    unsigned long long oldState = state;
+    state = oldState * 6364136223846793005ULL + increment;
+
+    unsigned int xorShifted = static_cast<unsigned int>(((oldState >> 18u) ^ oldState) >> 27u);
+    unsigned int rotation = static_cast<unsigned int>(oldState >> 59u);
+    return (xorShifted >> rotation) | (xorShifted << ((0u - rotation) & 31u));
+}
+
+// Unbiased value in [0, bound) using multiply and reject
+unsigned int RandomGenerator::nextBelow(unsigned int bound) {
+    unsigned long long product = static_cast<unsigned long long>(next()) * bound;
+    unsigned int low = static_cast<unsigned int>(product);
+
+    if (low < bound) {
+        unsigned int threshold = (0u - bound) % bound;
+        while (low < threshold) {
+            product = static_cast<unsigned long long>(next()) * bound;
+            low = static_cast<unsigned int>(product);
+        }
+    }
+
+    return static_cast<unsigned int>(product >> 32);
+}
+
+// Value in [0, 1]
+double RandomGenerator::nextDouble() {
+    return next() / 4294967295.0;
+}
+
+// The generator's position, so that it can carry on from the same point
+void RandomGenerator::saveBinary(SaveWriter& writer) const {
+    writer.writeInt64(static_cast<long long>(state));
+    writer.writeInt64(static_cast<long long>(increment));
+}
+
+void RandomGenerator::loadBinary(SaveReader& reader) {
+    state = static_cast<unsigned long long>(reader.readInt64());
+    increment = static_cast<unsigned long long>(reader.readInt64());
+}
+
+RandomStreamScope::RandomStreamScope(RandomGenerator* generator)
+    : previousGenerator(activeGenerator) {
+    activeGenerator = generator;
+}
+
+RandomStreamScope::~RandomStreamScope() {
+    activeGenerator = previousGenerator;
+}
+
+// Generator that the global random functions draw from
+static RandomGenerator& currentGenerator() {
+    return activeGenerator ? *activeGenerator : masterGenerator;
+}
+
 // Random number generator for integers in range [min, max]
 int randomInt(int min, int max) {
     // Ensure max is greater than min
@@ -15,8 +92,11 @@ int randomInt(int min, int max) {
         max = temp;
     }
 
-    // Generate random number
-    return min + (rand() % (max - min + 1));
+    // Span of the range, zero when it covers every int
+    unsigned int range = static_cast<unsigned int>(max) - static_cast<unsigned int>(min) + 1u;
+    unsigned int offset = (range == 0) ? currentGenerator().next() : currentGenerator().nextBelow(range);
+
+    return static_cast<int>(static_cast<unsigned int>(min) + offset);
 }
 
 // Random number generator for doubles in range [min, max]
@@ -29,10 +109,27 @@ double randomDouble(double min, double max) {
     }
 
     // Generate random double
-    double factor = (double)rand() / RAND_MAX;
+    double factor = currentGenerator().nextDouble();
     return min + factor * (max - min);
 }
 
+// 64 random bits, used to seed new streams
+unsigned long long randomSeed() {
+    RandomGenerator& generator = currentGenerator();
+    unsigned long long high = generator.next();
+    return (high << 32) | generator.next();
+}
+
+// Reseed the master generator; kingdoms created afterwards derive their streams from it
+void setMasterSeed(unsigned long long seed) {
+    masterSeed = seed;
+    masterGenerator.seed(seed, 0);
+}
+
+unsigned long long getMasterSeed() {
+    return masterSeed;
+}
+
 // Format current date and time as a string
 string currentDateTime() {
     time_t now = time(0);
@@ -0,0 +1,263 @@
+#include "StrongHold.h"
+#include <iostream>
+#include <string>
+#include <chrono>
+#include <sstream>
+#include <thread>
+#include <ctime>
+#include <cstdlib>
+
+using namespace std;
+
+// Stream buffer that discards everything written to it
+class NullStreamBuffer : public streambuf
+{
+protected:
+    virtual int overflow(int c) override {
+        return traits_type::not_eof(c);
+    }
+
+    virtual streamsize xsputn(const char* s, streamsize count) override {
+        return count;
+    }
+};
+
+// Function prototypes
+void displayUsage(const char* program);
+int runEnsemble(int numGames, int numKingdoms, int numTurns, unsigned int seed, int numThreads,
+    const string& reportFilename, streambuf* consoleBuffer);
+
+int main(int argc, char* argv[]) {
+    int numKingdoms = 8;
+    int numTurns = 100;
+    unsigned int seed = static_cast<unsigned int>(time(nullptr));
+    int numThreads = max(1, static_cast<int>(thread::hardware_concurrency()));
+    string saveFilename;
+    string autosaveFilename;
+    int autosaveInterval = 10;
+    int historyDepth = 0;
+    int numGames = 0;
+    string reportFilename;
+    string eventsFilename;
+    LogLevel logLevel = LOG_NONE;
+    bool isProfiling = false;
+
+    // Parse command line options
+    for (int i = 1; i < argc; i++) {
+        string option = argv[i];
+
+        if (option == "--help" || option == "-h") {
+            displayUsage(argv[0]);
+            return 0;
+        }
+
+        if (option == "--profile") {
+            isProfiling = true;
+            continue;
+        }
+
+        if (i + 1 >= argc) {
+            cerr << "Missing value for option " << option << endl;
+            displayUsage(argv[0]);
+            return 1;
+        }
+
+        string value = argv[++i];
+
+        if (option == "--kingdoms") {
+            numKingdoms = atoi(value.c_str());
+        }
+        else if (option == "--turns") {
+            numTurns = atoi(value.c_str());
+        }
+        else if (option == "--seed") {
+            seed = static_cast<unsigned int>(strtoul(value.c_str(), nullptr, 10));
+        }
+        else if (option == "--threads") {
+            numThreads = atoi(value.c_str());
+        }
+        else if (option == "--save") {
+            saveFilename = value;
+        }
+        else if (option == "--autosave") {
+            autosaveFilename = value;
+        }
+        else if (option == "--autosave-every") {
+            autosaveInterval = atoi(value.c_str());
+        }
+        else if (option == "--history") {
+            historyDepth = atoi(value.c_str());
+        }
+        else if (option == "--games") {
+            numGames = atoi(value.c_str());
+        }
+        else if (option == "--report") {
+            reportFilename = value;
+        }
+        else if (option == "--events") {
+            eventsFilename = value;
+        }
+        else if (option == "--log") {
+            if (value == "debug") logLevel = LOG_DEBUG;
+            else if (value == "info") logLevel = LOG_INFO;
+            else if (value == "warning") logLevel = LOG_WARNING;
+            else if (value == "none") logLevel = LOG_NONE;
+            else {
+                cerr << "Unknown log level: " << value << endl;
+                displayUsage(argv[0]);
+                return 1;
+            }
+        }
+        else {
+            cerr << "Unknown option: " << option << endl;
+            displayUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (numKingdoms < 1 || numTurns < 1 || numThreads < 1 || numGames < 0 || autosaveInterval < 1 || historyDepth < 0) {
+        cerr << "--kingdoms, --turns, --threads and --autosave-every must be at least 1." << endl;
+        return 1;
+    }
+
+    // Extra event kinds must be in the catalog before any turn runs
+    if (!eventsFilename.empty()) {
+        try {
+            EventCatalog::loadFromFile(eventsFilename);
+        }
+        catch (const exception& e) {
+            cerr << e.what() << endl;
+            return 1;
+        }
+    }
+
+    // Seed the master random generator
+    setMasterSeed(seed);
+
+    // Simulation messages are off unless asked for, and go to stderr
+    SimulationLog::setLevel(logLevel);
+    SimulationLog::setOutput(clog);
+    TurnProfiler::setIsEnabled(isProfiling);
+
+    // Silence all other console output while the engine runs
+    NullStreamBuffer nullBuffer;
+    streambuf* consoleBuffer = cout.rdbuf(&nullBuffer);
+
+    if (numGames > 0) {
+        return runEnsemble(numGames, numKingdoms, numTurns, seed, numThreads, reportFilename, consoleBuffer);
+    }
+
+    int turnsRun = 0;
+    double elapsedSeconds = 0.0;
+    int finalScore = 0;
+    WorldSummary worldSummary;
+    size_t historyBytes = 0;
+    ostringstream profileReport;
+
+    try {
+        GameEngine gameEngine;
+        gameEngine.setupHeadlessGame(numKingdoms);
+        gameEngine.setNumWorkerThreads(numThreads);
+        if (!autosaveFilename.empty()) {
+            gameEngine.setAutosave(autosaveFilename, autosaveInterval);
+        }
+        gameEngine.setTurnHistoryDepth(historyDepth);
+
+        auto start = chrono::steady_clock::now();
+        turnsRun = gameEngine.runHeadless(numTurns);
+        auto end = chrono::steady_clock::now();
+
+        elapsedSeconds = chrono::duration<double>(end - start).count();
+        finalScore = gameEngine.calculateFinalScore();
+        worldSummary = gameEngine.summarizeWorld();
+        if (gameEngine.getTurnHistory()) {
+            historyBytes = gameEngine.getTurnHistory()->getTotalBytes();
+        }
+
+        if (isProfiling) {
+            gameEngine.writeProfileReport(profileReport);
+        }
+
+        // Save the final world, e.g. to compare runs with different thread counts
+        if (!saveFilename.empty()) {
+            gameEngine.saveGame(saveFilename);
+        }
+    }
+    catch (const exception& e) {
+        cout.rdbuf(consoleBuffer);
+        cerr << "Headless simulation failed: " << e.what() << endl;
+        return 1;
+    }
+
+    cout.rdbuf(consoleBuffer);
+
+    // Report throughput
+    double turnsPerSecond = (elapsedSeconds > 0.0) ? turnsRun / elapsedSeconds : 0.0;
+
+    cout << "=== HEADLESS SIMULATION REPORT ===" << endl;
+    cout << "Seed: " << seed << endl;
+    cout << "Kingdoms: " << numKingdoms << endl;
+    cout << "Worker threads: " << numThreads << endl;
+    cout << "Turns simulated: " << turnsRun << endl;
+    cout << "Elapsed time: " << fixed << setprecision(3) << elapsedSeconds << " s" << endl;
+    cout << "Turns per second: " << fixed << setprecision(1) << turnsPerSecond << endl;
+    cout << "Kingdom-turns per second: " << fixed << setprecision(1) << turnsPerSecond * numKingdoms << endl;
+    cout << "Final score (kingdom 1): " << finalScore << endl;
+    cout << "World population: " << worldSummary.totalPopulation << endl;
+    cout << "World gold: " << worldSummary.totalGold << endl;
+    cout << "Mean stability: " << fixed << setprecision(1) << worldSummary.averageStability << endl;
+    cout << "Mean army morale: " << fixed << setprecision(1) << worldSummary.averageMorale << endl;
+    if (historyDepth > 0) {
+        cout << "Turn history: " << historyDepth << " turns, " << historyBytes / 1024 << " KB" << endl;
+    }
+
+    if (isProfiling) {
+        cout << endl << profileReport.str();
+    }
+
+    return 0;
+}
+
+// Run G independent games with seeds S, S+1, ... and report their outcomes
+int runEnsemble(int numGames, int numKingdoms, int numTurns, unsigned int seed, int numThreads,
+    const string& reportFilename, streambuf* consoleBuffer) {
+    try {
+        EnsembleRunner ensemble(numGames, numKingdoms, numTurns, seed, numThreads);
+        ensemble.run();
+
+        cout.rdbuf(consoleBuffer);
+        ensemble.writeReport(cout);
+
+        if (!reportFilename.empty()) {
+            ofstream reportFile(reportFilename);
+            if (!reportFile.is_open()) {
+                cerr << "Could not open report file: " << reportFilename << endl;
+                return 1;
+            }
+            ensemble.writeReport(reportFile);
+        }
+    }
+    catch (const exception& e) {
+        cout.rdbuf(consoleBuffer);
+        cerr << "Ensemble run failed: " << e.what() << endl;
+        return 1;
+    }
+
+    return 0;
+}
+
+void displayUsage(const char* program) {
+    cout << "Usage: " << program << " [--kingdoms N] [--turns M] [--seed S] [--threads T] [--save FILE] [--profile]" << endl;
+    cout << "       " << program << " ... [--autosave FILE] [--autosave-every N] [--history K]" << endl;
+    cout << "       " << program << " --games G [--kingdoms N] [--turns M] [--seed S] [--threads T] [--report FILE]" << endl;
+    cout << "Both forms accept --log none|warning|info|debug (default none) to print" << endl;
+    cout << "simulation messages to stderr. --profile adds per-phase turn timings." << endl;
+    cout << "--events FILE adds the random event kinds listed in FILE." << endl;
+    cout << "--autosave FILE writes a binary save of the world on a background" << endl;
+    cout << "thread every N turns (default 10). --history K keeps in-memory" << endl;
+    cout << "snapshots of the last K turns, as the console game does to rewind." << endl;
+    cout << "Runs N AI-controlled kingdoms for M turns without console I/O" << endl;
+    cout << "and reports simulation throughput. With --games, plays G games" << endl;
+    cout << "(seeds S, S+1, ...) across T threads and reports their score," << endl;
+    cout << "turns survived, stability and treasury distributions." << endl;
+}
@@ -1,4 +1,4 @@
-#include "Stronghold.h"
+#include "StrongHold.h"
 #include <iostream>
 #include <fstream>
 #include <string>
@@ -126,3 +126,19 @@ void Human::load(ifstream& file) {
     file >> loyaltyLevel;
     file.ignore(); // Skip newline
 }
+
+// Save human data in binary form
+void Human::saveBinary(SaveWriter& writer) const {
+    Entity::saveBinary(writer);
+    writer.writeInt(happiness);
+    writer.writeInt(health);
+    writer.writeInt(loyaltyLevel);
+}
+
+// Load human data in binary form
+void Human::loadBinary(SaveReader& reader) {
+    Entity::loadBinary(reader);
+    happiness = reader.readInt();
+    health = reader.readInt();
+    loyaltyLevel = reader.readInt();
+}
@@ -1,13 +1,19 @@
-#include "Stronghold.h"
+#include "StrongHold.h"
 #include <iostream>
 #include <fstream>
 #include <string>
 
 using namespace std;
 
+// Loading an event applies its effects again, so a checkpoint that holds
+// the events also holds everything they affect, and the other way round
+static const unsigned int EVENT_AFFECTED_COMPONENTS =
+    COMPONENT_POPULATION | COMPONENT_ECONOMY | COMPONENT_ARMY | COMPONENT_EVENTS;
+
 // Constructor
 Kingdom::Kingdom(const string& name, bool isPlayerControlled)
-    : name(name), isPlayerControlled(isPlayerControlled), turn(1), stabilityLevel(50) {
+    : name(name), isPlayerControlled(isPlayerControlled), turn(1), stabilityLevel(50), worldStore(nullptr),
+    storeSlot(-1), logBuffer(name), turnProfile(nullptr), dirtyComponents(ALL_KINGDOM_COMPONENTS) {
 
     // Initialize components
     population = new Population(1000);
@@ -28,28 +34,26 @@ Kingdom::Kingdom(const string& name, bool isPlayerControlled)
     bank = new Bank("Royal Bank");
 
     // Initialize weather
-    currentWeather = new Weather("Clear Skies", "The weather is fair.", 1, SUNNY);
+    currentWeather = createIn<Weather>(&arena, "Clear Skies", "The weather is fair.", 1, SUNNY);
 
     // No disease initially
     currentDisease = nullptr;
 
-    // Initialize dynamic array for events
-    maxEvents = 5;
-    numEvents = 0;
-    activeEvents = new Event * [maxEvents];
-
-    for (int i = 0; i < maxEvents; i++) {
-        activeEvents[i] = nullptr;
-    }
-
     // Initialize current leader to null (must be set separately)
     currentLeader = nullptr;
 
-    cout << "Kingdom " << name << " has been established." << endl;
+    // Give this kingdom its own random streams so its turns do not depend on
+    // the order in which kingdoms are processed
+    seedRandomStreams(randomSeed());
+
+    LogLine() << "Kingdom " << name << " has been established.";
 }
 
 // Destructor
 Kingdom::~Kingdom() {
+    // Give up the world store slot before the components go away
+    detachFromStore();
+
     // Clean up all components
     delete population;
 
@@ -61,21 +65,38 @@ Kingdom::~Kingdom() {
 
     // Current leader is managed by leadership system, don't delete here
 
-    delete currentWeather;
+    destroyIn(&arena, currentWeather);
 
     if (currentDisease) {
         delete currentDisease;
     }
 
     // Delete all active events
-    for (int i = 0; i < numEvents; i++) {
-        delete activeEvents[i];
+    for (int i = 0; i < activeEvents.size(); i++) {
+        destroyIn(&arena, activeEvents[i]);
     }
 
-    // Delete the array itself
-    delete[] activeEvents;
-
     delete bank;
+    delete turnProfile;
+
+    // The arena frees its chunks when it goes away
+}
+
+// Let go of every arena object so the arena can be reset in one go
+void Kingdom::releasePooledObjects() {
+    destroyIn(&arena, currentWeather);
+    currentWeather = nullptr;
+
+    for (int i = 0; i < activeEvents.size(); i++) {
+        destroyIn(&arena, activeEvents[i]);
+    }
+    activeEvents.clear();
+
+    economy->clearTradeRoutes();
+    bank->clearLoans();
+    bank->clearInvestments();
+
+    arena.reset();
 }
 
 // Getters and setters
@@ -85,6 +106,8 @@ string Kingdom::getName() const {
 
 void Kingdom::setName(const string& newName) {
     name = newName;
+    logBuffer.setTag(newName);
+    markDirty(COMPONENT_CORE);
 }
 
 Population* Kingdom::getPopulation() const {
@@ -105,6 +128,7 @@ Leader* Kingdom::getCurrentLeader() const {
 
 void Kingdom::setCurrentLeader(Leader* leader) {
     currentLeader = leader;
+    markDirty(COMPONENT_LEADERSHIP);
 }
 
 LeadershipSystem* Kingdom::getLeadershipSystem() const {
@@ -117,9 +141,10 @@ Weather* Kingdom::getCurrentWeather() const {
 
 void Kingdom::setCurrentWeather(Weather* weather) {
     if (currentWeather) {
-        delete currentWeather;
+        destroyIn(&arena, currentWeather);
     }
     currentWeather = weather;
+    markDirty(COMPONENT_WEATHER);
 }
 
 Disease* Kingdom::getCurrentDisease() const {
@@ -131,18 +156,24 @@ void Kingdom::setCurrentDisease(Disease* disease) {
         delete currentDisease;
     }
     currentDisease = disease;
+    markDirty(COMPONENT_DISEASE);
 }
 
 Bank* Kingdom::getBank() const {
     return bank;
 }
 
+Arena* Kingdom::getArena() {
+    return &arena;
+}
+
 int Kingdom::getTurn() const {
     return turn;
 }
 
 void Kingdom::incrementTurn() {
     turn++;
+    markDirty(COMPONENT_CORE);
 }
 
 bool Kingdom::getIsPlayerControlled() const {
@@ -157,6 +188,7 @@ void Kingdom::setStabilityLevel(int level) {
     if (level < 0) level = 0;
     if (level > 100) level = 100;
     stabilityLevel = level;
+    markDirty(COMPONENT_CORE);
 }
 
 // Add an event to the kingdom
@@ -165,56 +197,28 @@ void Kingdom::addEvent(Event* event) {
         throw invalid_argument("Cannot add null event");
     }
 
-    // Check if we need to resize the array
-    if (numEvents >= maxEvents) {
-        // Create a new, larger array
-        int newMaxEvents = maxEvents * 2;
-        Event** newEvents = new Event * [newMaxEvents];
-
-        // Copy existing events to the new array
-        for (int i = 0; i < numEvents; i++) {
-            newEvents[i] = activeEvents[i];
-        }
-
-        // Initialize remaining slots to nullptr
-        for (int i = numEvents; i < newMaxEvents; i++) {
-            newEvents[i] = nullptr;
-        }
-
-        // Delete the old array and update pointers
-        delete[] activeEvents;
-        activeEvents = newEvents;
-        maxEvents = newMaxEvents;
-    }
-
-    // Add the new event
-    activeEvents[numEvents++] = event;
+    activeEvents.add(event);
 
     // Apply the event's effects
     event->applyEffects(this);
+    markDirty(EVENT_AFFECTED_COMPONENTS);
 }
 
 // Remove an event at a specific index
 void Kingdom::removeEvent(int index) {
-    if (index < 0 || index >= numEvents) {
+    if (index < 0 || index >= activeEvents.size()) {
         throw out_of_range("Event index out of range");
     }
 
-    // Delete the event object
-    delete activeEvents[index];
-
-    // Shift remaining elements
-    for (int i = index; i < numEvents - 1; i++) {
-        activeEvents[i] = activeEvents[i + 1];
-    }
-
-    // Set the last position to nullptr and decrement count
-    activeEvents[--numEvents] = nullptr;
+    // Delete the event object and close the gap
+    destroyIn(&arena, activeEvents[index]);
+    activeEvents.removeAt(index);
+    markDirty(COMPONENT_EVENTS);
 }
 
 // Get an event at a specific index
 Event* Kingdom::getEvent(int index) const {
-    if (index < 0 || index >= numEvents) {
+    if (index < 0 || index >= activeEvents.size()) {
         throw out_of_range("Event index out of range");
     }
     return activeEvents[index];
@@ -222,43 +226,74 @@ Event* Kingdom::getEvent(int index) const {
 
 // Get the number of active events
 int Kingdom::getNumEvents() const {
-    return numEvents;
+    return activeEvents.size();
 }
 
 // Process a turn for the kingdom
 void Kingdom::processTurn() {
-    // Start of turn message
-    cout << "\n=== Turn " << turn << " - " << name << " ===\n" << endl;
+    // Random draws of this turn come from the kingdom's own streams, and its
+    // messages are held until the end-of-turn flush
+    RandomStreamScope randomScope(getRandomStream(STREAM_GENERAL));
+    LogBufferScope logScope(&logBuffer);
 
-    // Check if we have a leader
-    if (!currentLeader) {
-        cout << "Warning: The kingdom has no leader!" << endl;
-        if (leadershipSystem && leadershipSystem->getNumPotentialLeaders() > 0) {
-            leadershipSystem->handleSuccession();
-        }
-        else {
-            cout << "There are no potential leaders. The kingdom is in anarchy!" << endl;
-            stabilityLevel = max(0, stabilityLevel - 10);
-        }
+    // Time each phase when profiling is on
+    if (TurnProfiler::getIsEnabled() && !turnProfile) {
+        turnProfile = new TurnProfile();
     }
+    PhaseClock phaseClock(TurnProfiler::getIsEnabled() ? turnProfile : nullptr);
 
-    // Update leadership system
-    if (leadershipSystem) {
-        leadershipSystem->update();
+    // Weather and the per-turn updates reach into nearly every component;
+    // disease and events only change while there are any
+    markDirty(ALL_KINGDOM_COMPONENTS & ~(COMPONENT_DISEASE | COMPONENT_EVENTS));
+    if (currentDisease) {
+        markDirty(COMPONENT_DISEASE);
+    }
+    if (!activeEvents.isEmpty()) {
+        markDirty(COMPONENT_EVENTS);
+    }
 
-        // Check for election
-        if (leadershipSystem->getTurnsToNextElection() == 0) {
-            leadershipSystem->holdElection();
+    // Start of turn message
+    LogLine() << "=== Turn " << turn << " ===";
+
+    // Leadership draws from its own stream
+    {
+        RandomStreamScope leadershipScope(getRandomStream(STREAM_LEADERSHIP));
+
+        // Check if we have a leader
+        if (!currentLeader) {
+            LogLine(LOG_WARNING) << "Warning: The kingdom has no leader!";
+            if (leadershipSystem && leadershipSystem->getNumPotentialLeaders() > 0) {
+                leadershipSystem->handleSuccession();
+            }
+            else {
+                LogLine(LOG_WARNING) << "There are no potential leaders. The kingdom is in anarchy!";
+                stabilityLevel = max(0, stabilityLevel - 10);
+            }
         }
 
-        // Check for coup
-        if (leadershipSystem->checkForCoup()) {
-            leadershipSystem->handleCoup();
+        // Update leadership system
+        if (leadershipSystem) {
+            leadershipSystem->update();
+            phaseClock.lap(PHASE_LEADERSHIP);
+
+            // Check for election
+            if (leadershipSystem->getTurnsToNextElection() == 0) {
+                leadershipSystem->holdElection();
+            }
+            phaseClock.lap(PHASE_ELECTION);
+
+            // Check for coup
+            if (leadershipSystem->checkForCoup()) {
+                leadershipSystem->handleCoup();
+            }
+            phaseClock.lap(PHASE_COUP);
         }
     }
 
     // Update weather
     if (currentWeather) {
+        RandomStreamScope weatherScope(getRandomStream(STREAM_WEATHER));
+
         currentWeather->update();
 
         // Apply weather effects
@@ -267,19 +302,23 @@ void Kingdom::processTurn() {
         // Check if weather has ended
         if (!currentWeather->getIsActive()) {
             // Generate new weather
-            Weather* newWeather = new Weather("Clear Skies", "The weather is fair.", 1, SUNNY);
+            Weather* newWeather = createIn<Weather>(&arena, "Clear Skies", "The weather is fair.", 1, SUNNY);
             newWeather->generateRandomWeather();
 
             setCurrentWeather(newWeather);
         }
+        phaseClock.lap(PHASE_WEATHER);
     }
 
     // Update disease if present
     if (currentDisease && currentDisease->getIsActive()) {
+        RandomStreamScope diseaseScope(getRandomStream(STREAM_DISEASE));
+
         currentDisease->update();
 
         // Apply disease effects
         currentDisease->applyEffects(this);
+        phaseClock.lap(PHASE_DISEASE);
     }
 
     // Handle economy and resources
@@ -295,57 +334,144 @@ void Kingdom::processTurn() {
             // Consume food based on population
             if (food) {
                 int requiredFood = population->getTotalPopulation() * population->getFoodConsumptionPerCapita();
-                food->consume(min(requiredFood, food->getAmount()));
+                int consumedFood = min(requiredFood, food->getAmount());
+                if (consumedFood > 0) {
+                    food->consume(consumedFood);
+                }
             }
+            phaseClock.lap(PHASE_POPULATION);
         }
 
         // Update economy
         economy->update();
+        phaseClock.lap(PHASE_ECONOMY);
     }
 
     // Update army
     if (army) {
         army->update();
+        phaseClock.lap(PHASE_ARMY);
     }
 
     // Update leader
     if (currentLeader) {
         currentLeader->update();
+        phaseClock.lap(PHASE_LEADER);
     }
 
-    // Random events
-    if (randomInt(1, 5) == 1) {
-        Event* randomEvent = Event::generateRandomEvent();
-        addEvent(randomEvent);
-    }
+    // Events draw from their own stream
+    {
+        RandomStreamScope eventScope(getRandomStream(STREAM_EVENTS));
 
-    // Update active events
-    for (int i = 0; i < numEvents; i++) {
-        if (activeEvents[i]) {
-            activeEvents[i]->update();
+        // Random events
+        if (randomInt(1, 5) == 1) {
+            Event* randomEvent = Event::generateRandomEvent(&arena);
+            addEvent(randomEvent);
+        }
 
-            // Remove expired events
-            if (activeEvents[i]->getTurnsRemaining() <= 0) {
-                cout << "The " << activeEvents[i]->getName() << " event has ended." << endl;
-                removeEvent(i);
-                i--; // Adjust index after removal
+        // Update active events
+        for (int i = 0; i < activeEvents.size(); i++) {
+            if (activeEvents[i]) {
+                activeEvents[i]->update();
+
+                // Remove expired events
+                if (activeEvents[i]->getTurnsRemaining() <= 0) {
+                    LogLine() << "The " << activeEvents[i]->getName() << " event has ended.";
+                    removeEvent(i);
+                    i--; // Adjust index after removal
+                }
             }
         }
+        phaseClock.lap(PHASE_EVENTS);
     }
 
     // Update bank
     if (bank) {
         bank->update();
+        phaseClock.lap(PHASE_BANK);
     }
 
     // Calculate stability effects
     calculateStability();
+    phaseClock.lap(PHASE_STABILITY);
 
     // Increment turn counter
     incrementTurn();
 
     // End of turn message
-    cout << "\n=== End of Turn " << turn - 1 << " ===\n" << endl;
+    LogLine() << "=== End of Turn " << turn - 1 << " ===";
+}
+
+// Apply effects that reach into other kingdoms; these run serially after all
+// kingdoms have finished their own turn
+void Kingdom::processCrossKingdomEffects() {
+    RandomStreamScope randomScope(getRandomStream(STREAM_GENERAL));
+    LogBufferScope logScope(&logBuffer);
+
+    if (economy) {
+        economy->processKingdomTradeRoutes();
+        markDirty(COMPONENT_ECONOMY);
+    }
+}
+
+LogBuffer* Kingdom::getLogBuffer() {
+    return &logBuffer;
+}
+
+// Phase timings of this kingdom, or nullptr if it was never profiled
+const TurnProfile* Kingdom::getTurnProfile() const {
+    return turnProfile;
+}
+
+// Move the kingdom's scalar state into a slot of the world store
+void Kingdom::attachToStore(WorldStore* store) {
+    detachFromStore();
+    if (store) {
+        bindToStore(store, store->addKingdom(this));
+    }
+}
+
+// Move the kingdom's scalar state back into its own components
+void Kingdom::detachFromStore() {
+    if (!worldStore) {
+        return;
+    }
+
+    WorldStore* store = worldStore;
+    int slot = storeSlot;
+    bindToStore(nullptr, -1);
+    store->removeKingdom(slot);
+}
+
+// Point every stored field at a slot; also used by the store when it moves
+// the kingdom to another slot
+void Kingdom::bindToStore(WorldStore* store, int slot) {
+    worldStore = store;
+    storeSlot = store ? slot : -1;
+
+    stabilityLevel.bind(store ? &store->stabilityLevels : nullptr, storeSlot);
+    population->bindToStore(store, storeSlot);
+    economy->bindToStore(store, storeSlot);
+    army->bindToStore(store, storeSlot);
+}
+
+WorldStore* Kingdom::getWorldStore() const {
+    return worldStore;
+}
+
+int Kingdom::getStoreSlot() const {
+    return storeSlot;
+}
+
+RandomGenerator* Kingdom::getRandomStream(RandomStream stream) {
+    return &randomStreams[stream];
+}
+
+// Every subsystem gets its own stream of the same seed
+void Kingdom::seedRandomStreams(unsigned long long seed) {
+    for (int i = 0; i < NUM_RANDOM_STREAMS; i++) {
+        randomStreams[i].seed(seed, i);
+    }
 }
 
 // Calculate kingdom stability based on various factors
@@ -410,10 +536,10 @@ void Kingdom::calculateStability() {
 
     // Report major stability changes
     if (stabilityLevel <= 20 && baseStability > 20) {
-        cout << "WARNING: The kingdom's stability has fallen to dangerous levels!" << endl;
+        LogLine(LOG_WARNING) << "WARNING: The kingdom's stability has fallen to dangerous levels!";
     }
     else if (stabilityLevel >= 80 && baseStability < 80) {
-        cout << "The kingdom has achieved remarkable stability!" << endl;
+        LogLine() << "The kingdom has achieved remarkable stability!";
     }
 }
 
@@ -457,8 +583,8 @@ void Kingdom::save(ofstream& file) const {
     bank->save(file);
 
     // Save events
-    file << numEvents << endl;
-    for (int i = 0; i < numEvents; i++) {
+    file << activeEvents.size() << endl;
+    for (int i = 0; i < activeEvents.size(); i++) {
         activeEvents[i]->save(file);
     }
 }
@@ -470,11 +596,17 @@ void Kingdom::load(ifstream& file) {
     }
 
     getline(file, name);
+    logBuffer.setTag(name);
     file >> isPlayerControlled;
     file >> turn;
     file >> stabilityLevel;
     file.ignore(); // Skip newline
 
+    // Start the arena over; weather, events, trade routes and loans are
+    // all recreated from the file
+    releasePooledObjects();
+    currentWeather = createIn<Weather>(&arena, "Clear Skies", "The weather is fair.", 1, SUNNY);
+
     // Load components
     population->load(file);
     economy->load(file);
@@ -532,28 +664,202 @@ void Kingdom::load(ifstream& file) {
     file >> loadedNumEvents;
     file.ignore(); // Skip newline
 
-    // Clear existing events
-    for (int i = 0; i < numEvents; i++) {
-        delete activeEvents[i];
-        activeEvents[i] = nullptr;
-    }
-    numEvents = 0;
-
     // Resize array if needed
-    if (loadedNumEvents > maxEvents) {
-        delete[] activeEvents;
-        maxEvents = loadedNumEvents;
-        activeEvents = new Event * [maxEvents];
-
-        for (int i = 0; i < maxEvents; i++) {
-            activeEvents[i] = nullptr;
-        }
-    }
+    activeEvents.reserve(loadedNumEvents);
 
     // Load each event
     for (int i = 0; i < loadedNumEvents; i++) {
-        Event* newEvent = new Event("", "");
+        Event* newEvent = createIn<Event>(&arena, "", "");
         newEvent->load(file);
         addEvent(newEvent);
     }
+}
+
+// Save kingdom data in binary form
+void Kingdom::saveBinary(SaveWriter& writer) const {
+    saveComponentsBinary(writer, ALL_KINGDOM_COMPONENTS);
+}
+
+// Load kingdom data in binary form
+void Kingdom::loadBinary(SaveReader& reader) {
+    // Start the arena over, as for a text load
+    releasePooledObjects();
+    loadComponentsBinary(reader, ALL_KINGDOM_COMPONENTS);
+}
+
+// Note components that have changed since the last checkpoint
+void Kingdom::markDirty(unsigned int components) {
+    dirtyComponents |= components;
+}
+
+// Components the next delta checkpoint has to hold
+unsigned int Kingdom::getDirtyComponents() const {
+    if (dirtyComponents & EVENT_AFFECTED_COMPONENTS) {
+        return dirtyComponents | EVENT_AFFECTED_COMPONENTS;
+    }
+    return dirtyComponents;
+}
+
+void Kingdom::clearDirtyComponents() {
+    dirtyComponents = 0;
+}
+
+// Everything a turn can change, for an in-memory turn snapshot: the saved
+// components, then what saves leave out (bank investments and the random
+// streams)
+void Kingdom::saveSnapshot(SaveWriter& writer) const {
+    saveComponentsBinary(writer, ALL_KINGDOM_COMPONENTS);
+    bank->saveInvestmentsBinary(writer);
+    for (int i = 0; i < NUM_RANDOM_STREAMS; i++) {
+        randomStreams[i].saveBinary(writer);
+    }
+}
+
+// Put the kingdom back as saveSnapshot found it
+void Kingdom::restoreSnapshot(SaveReader& reader) {
+    loadComponentsBinary(reader, ALL_KINGDOM_COMPONENTS);
+    bank->loadInvestmentsBinary(reader);
+    for (int i = 0; i < NUM_RANDOM_STREAMS; i++) {
+        randomStreams[i].loadBinary(reader);
+    }
+
+    markDirty(ALL_KINGDOM_COMPONENTS);
+}
+
+// Save the components in the mask, in save order; with every bit set this
+// is the full kingdom
+void Kingdom::saveComponentsBinary(SaveWriter& writer, unsigned int components) const {
+    if (components & COMPONENT_CORE) {
+        writer.writeString(name);
+        writer.writeBool(isPlayerControlled);
+        writer.writeInt(turn);
+        writer.writeInt(stabilityLevel);
+    }
+
+    if (components & COMPONENT_POPULATION) {
+        population->saveBinary(writer);
+    }
+    if (components & COMPONENT_ECONOMY) {
+        economy->saveBinary(writer);
+    }
+    if (components & COMPONENT_ARMY) {
+        army->saveBinary(writer);
+    }
+
+    if (components & COMPONENT_LEADERSHIP) {
+        writer.writeBool(currentLeader != nullptr);
+        if (currentLeader) {
+            currentLeader->saveBinary(writer);
+        }
+    }
+
+    if (components & COMPONENT_WEATHER) {
+        currentWeather->saveBinary(writer);
+    }
+
+    if (components & COMPONENT_DISEASE) {
+        writer.writeBool(currentDisease != nullptr);
+        if (currentDisease) {
+            currentDisease->saveBinary(writer);
+        }
+    }
+
+    if (components & COMPONENT_LEADERSHIP) {
+        leadershipSystem->saveBinary(writer);
+    }
+    if (components & COMPONENT_BANK) {
+        bank->saveBinary(writer);
+    }
+
+    if (components & COMPONENT_EVENTS) {
+        writer.writeInt(activeEvents.size());
+        for (int i = 0; i < activeEvents.size(); i++) {
+            activeEvents[i]->saveBinary(writer);
+        }
+    }
+}
+
+// Load the components in the mask over the current ones
+void Kingdom::loadComponentsBinary(SaveReader& reader, unsigned int components) {
+    if (components & COMPONENT_CORE) {
+        name = reader.readString();
+        logBuffer.setTag(name);
+        isPlayerControlled = reader.readBool();
+        turn = reader.readInt();
+        stabilityLevel = reader.readInt();
+    }
+
+    if (components & COMPONENT_POPULATION) {
+        population->loadBinary(reader);
+    }
+    if (components & COMPONENT_ECONOMY) {
+        economy->loadBinary(reader);
+    }
+    if (components & COMPONENT_ARMY) {
+        army->loadBinary(reader);
+    }
+
+    if (components & COMPONENT_LEADERSHIP) {
+        if (reader.readBool()) {
+            if (!currentLeader) {
+                currentLeader = new Leader("", "");
+            }
+            currentLeader->loadBinary(reader);
+        }
+        else if (currentLeader) {
+            delete currentLeader;
+            currentLeader = nullptr;
+        }
+    }
+
+    // Weather is loaded into a fresh object, as in a full load
+    if (components & COMPONENT_WEATHER) {
+        destroyIn(&arena, currentWeather);
+        currentWeather = createIn<Weather>(&arena, "Clear Skies", "The weather is fair.", 1, SUNNY);
+        currentWeather->loadBinary(reader);
+    }
+
+    if (components & COMPONENT_DISEASE) {
+        if (reader.readBool()) {
+            if (!currentDisease) {
+                currentDisease = new Disease("", "", 1, 10, 5);
+            }
+            currentDisease->loadBinary(reader);
+        }
+        else if (currentDisease) {
+            delete currentDisease;
+            currentDisease = nullptr;
+        }
+    }
+
+    if (components & COMPONENT_LEADERSHIP) {
+        leadershipSystem->loadBinary(reader);
+    }
+    if (components & COMPONENT_BANK) {
+        // Investments are not saved
+        bank->clearInvestments();
+        bank->loadBinary(reader);
+    }
+
+    if (components & COMPONENT_EVENTS) {
+        for (int i = 0; i < activeEvents.size(); i++) {
+            destroyIn(&arena, activeEvents[i]);
+        }
+        activeEvents.clear();
+
+        int loadedNumEvents = reader.readInt();
+        activeEvents.reserve(loadedNumEvents);
+        for (int i = 0; i < loadedNumEvents; i++) {
+            Event* newEvent = createIn<Event>(&arena, "", "");
+            newEvent->loadBinary(reader);
+
+            // A snapshot's components already include the event effects
+            if (reader.getIsReadingSnapshot()) {
+                activeEvents.add(newEvent);
+            }
+            else {
+                addEvent(newEvent);
+            }
+        }
+    }
 }
\ No newline at end of file
@@ -1,4 +1,4 @@
-#include "Stronghold.h"
+#include "StrongHold.h"
 #include <iostream>
 #include <fstream>
 #include <string>
@@ -10,15 +10,6 @@ Leader::Leader(const string& name, const string& title)
     : Human(name), title(title), intelligence(50), militarySkill(50), economicSkill(50),
     corruption(0), leadershipScore(0), experience(0), termLength(0), isElected(false) {
 
-    // Initialize dynamic array for traits
-    maxTraits = 5;
-    numTraits = 0;
-    traits = new LeadershipTrait * [maxTraits];
-
-    for (int i = 0; i < maxTraits; i++) {
-        traits[i] = nullptr;
-    }
-
     // Calculate initial leadership score
     calculateLeadershipScore();
 }
@@ -26,12 +17,9 @@ Leader::Leader(const string& name, const string& title)
 // Destructor
 Leader::~Leader() {
     // Clean up dynamically allocated traits
-    for (int i = 0; i < numTraits; i++) {
+    for (int i = 0; i < traits.size(); i++) {
         delete traits[i];
     }
-
-    // Clean up the array itself
-    delete[] traits;
 }
 
 // Calculate leadership score based on attributes
@@ -44,7 +32,7 @@ void Leader::calculateLeadershipScore() {
     leadershipScore += experience / 10;
 
     // Trait modifications
-    for (int i = 0; i < numTraits; i++) {
+    for (int i = 0; i < traits.size(); i++) {
         if (traits[i]) {
             // Positive traits add to score, negative traits subtract
             if (traits[i]->getIsPositive()) {
@@ -146,30 +134,7 @@ void Leader::addTrait(LeadershipTrait* trait) {
         throw invalid_argument("Cannot add null trait");
     }
 
-    // Check if we need to resize the array
-    if (numTraits >= maxTraits) {
-        // Create a new, larger array
-        int newMaxTraits = maxTraits * 2;
-        LeadershipTrait** newTraits = new LeadershipTrait * [newMaxTraits];
-
-        // Copy existing traits to the new array
-        for (int i = 0; i < numTraits; i++) {
-            newTraits[i] = traits[i];
-        }
-
-        // Initialize remaining slots to nullptr
-        for (int i = numTraits; i < newMaxTraits; i++) {
-            newTraits[i] = nullptr;
-        }
-
-        // Delete the old array and update pointers
-        delete[] traits;
-        traits = newTraits;
-        maxTraits = newMaxTraits;
-    }
-
-    // Add the new trait
-    traits[numTraits++] = trait;
+    traits.add(trait);
 
     // Apply trait effects
     trait->applyEffects(this);
@@ -180,23 +145,16 @@ void Leader::addTrait(LeadershipTrait* trait) {
 
 // Remove trait at a specific index
 void Leader::removeTrait(int index) {
-    if (index < 0 || index >= numTraits) {
+    if (index < 0 || index >= traits.size()) {
         throw out_of_range("Trait index out of range");
     }
 
     // Remove trait effects first
     traits[index]->removeEffects(this);
 
-    // Delete the trait object
+    // Delete the trait object and close the gap
     delete traits[index];
-
-    // Shift remaining elements
-    for (int i = index; i < numTraits - 1; i++) {
-        traits[i] = traits[i + 1];
-    }
-
-    // Set the last position to nullptr and decrement count
-    traits[--numTraits] = nullptr;
+    traits.removeAt(index);
 
     // Recalculate leadership score
     calculateLeadershipScore();
@@ -204,7 +162,7 @@ void Leader::removeTrait(int index) {
 
 // Get trait at a specific index
 LeadershipTrait* Leader::getTrait(int index) const {
-    if (index < 0 || index >= numTraits) {
+    if (index < 0 || index >= traits.size()) {
         throw out_of_range("Trait index out of range");
     }
     return traits[index];
@@ -212,7 +170,7 @@ LeadershipTrait* Leader::getTrait(int index) const {
 
 // Get number of traits
 int Leader::getNumTraits() const {
-    return numTraits;
+    return traits.size();
 }
 
 // Calculate population bonus based on leader attributes
@@ -334,7 +292,7 @@ void Leader::update() {
     }
 
     // Update all traits
-    for (int i = 0; i < numTraits; i++) {
+    for (int i = 0; i < traits.size(); i++) {
         if (traits[i]) {
             traits[i]->update();
         }
@@ -358,8 +316,8 @@ void Leader::save(ofstream& file) const {
     file << isElected << endl;
 
     // Save traits
-    file << numTraits << endl;
-    for (int i = 0; i < numTraits; i++) {
+    file << traits.size() << endl;
+    for (int i = 0; i < traits.size(); i++) {
         if (traits[i]) {
             traits[i]->save(file);
         }
@@ -388,23 +346,14 @@ void Leader::load(ifstream& file) {
     file.ignore(); // Skip newline
 
     // Delete existing traits
-    for (int i = 0; i < numTraits; i++) {
+    for (int i = 0; i < traits.size(); i++) {
         delete traits[i];
-        traits[i] = nullptr;
     }
 
-    numTraits = 0;
+    traits.clear();
 
     // Resize array if needed
-    if (loadedNumTraits > maxTraits) {
-        delete[] traits;
-        maxTraits = loadedNumTraits;
-        traits = new LeadershipTrait * [maxTraits];
-
-        for (int i = 0; i < maxTraits; i++) {
-            traits[i] = nullptr;
-        }
-    }
+    traits.reserve(loadedNumTraits);
 
     // Load each trait
     for (int i = 0; i < loadedNumTraits; i++) {
@@ -413,3 +362,56 @@ void Leader::load(ifstream& file) {
         addTrait(newTrait);
     }
 }
+
+// Save leader data in binary form
+void Leader::saveBinary(SaveWriter& writer) const {
+    Human::saveBinary(writer);
+    writer.writeString(title);
+    writer.writeInt(intelligence);
+    writer.writeInt(militarySkill);
+    writer.writeInt(economicSkill);
+    writer.writeInt(corruption);
+    writer.writeInt(leadershipScore);
+    writer.writeInt(experience);
+    writer.writeInt(termLength);
+    writer.writeBool(isElected);
+
+    writer.writeInt(traits.size());
+    for (int i = 0; i < traits.size(); i++) {
+        traits[i]->saveBinary(writer);
+    }
+}
+
+// Load leader data in binary form
+void Leader::loadBinary(SaveReader& reader) {
+    Human::loadBinary(reader);
+    title = reader.readString();
+    intelligence = reader.readInt();
+    militarySkill = reader.readInt();
+    economicSkill = reader.readInt();
+    corruption = reader.readInt();
+    leadershipScore = reader.readInt();
+    experience = reader.readInt();
+    termLength = reader.readInt();
+    isElected = reader.readBool();
+
+    for (int i = 0; i < traits.size(); i++) {
+        delete traits[i];
+    }
+    traits.clear();
+
+    int loadedNumTraits = reader.readInt();
+    traits.reserve(loadedNumTraits);
+    for (int i = 0; i < loadedNumTraits; i++) {
+        LeadershipTrait* newTrait = new LeadershipTrait("", "", true);
+        newTrait->loadBinary(reader);
+
+        // The skills read above already include a snapshot's trait effects
+        if (reader.getIsReadingSnapshot()) {
+            traits.add(newTrait);
+        }
+        else {
+            addTrait(newTrait);
+        }
+    }
+}
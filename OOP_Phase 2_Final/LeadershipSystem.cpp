@@ -1,4 +1,4 @@
-#include "Stronghold.h"
+#include "StrongHold.h"
 #include <iostream>
 #include <fstream>
 #include <string>
@@ -10,15 +10,6 @@ LeadershipSystem::LeadershipSystem(Kingdom* kingdom)
     : kingdom(kingdom), electionCycle(5), turnsToNextElection(5),
     stabilityFactor(50), coupRisk(10) {
 
-    // Initialize dynamic array for potential leaders
-    maxLeaders = 5;
-    numLeaders = 0;
-    potentialLeaders = new Leader * [maxLeaders];
-
-    for (int i = 0; i < maxLeaders; i++) {
-        potentialLeaders[i] = nullptr;
-    }
-
     // Add some initial potential leaders if kingdom exists
     if (kingdom) {
         // Generate 2-4 potential leaders
@@ -32,12 +23,9 @@ LeadershipSystem::LeadershipSystem(Kingdom* kingdom)
 // Destructor
 LeadershipSystem::~LeadershipSystem() {
     // Clean up dynamically allocated leaders
-    for (int i = 0; i < numLeaders; i++) {
+    for (int i = 0; i < potentialLeaders.size(); i++) {
         delete potentialLeaders[i];
     }
-
-    // Clean up the array itself
-    delete[] potentialLeaders;
 }
 
 // Add a potential leader
@@ -46,35 +34,12 @@ void LeadershipSystem::addPotentialLeader(Leader* leader) {
         throw invalid_argument("Cannot add null leader");
     }
 
-    // Check if we need to resize the array
-    if (numLeaders >= maxLeaders) {
-        // Create a new, larger array
-        int newMaxLeaders = maxLeaders * 2;
-        Leader** newLeaders = new Leader * [newMaxLeaders];
-
-        // Copy existing leaders to the new array
-        for (int i = 0; i < numLeaders; i++) {
-            newLeaders[i] = potentialLeaders[i];
-        }
-
-        // Initialize remaining slots to nullptr
-        for (int i = numLeaders; i < newMaxLeaders; i++) {
-            newLeaders[i] = nullptr;
-        }
-
-        // Delete the old array and update pointers
-        delete[] potentialLeaders;
-        potentialLeaders = newLeaders;
-        maxLeaders = newMaxLeaders;
-    }
-
-    // Add the new leader
-    potentialLeaders[numLeaders++] = leader;
+    potentialLeaders.add(leader);
 }
 
 // Remove a potential leader at a specific index
 void LeadershipSystem::removePotentialLeader(int index) {
-    if (index < 0 || index >= numLeaders) {
+    if (index < 0 || index >= potentialLeaders.size()) {
         throw out_of_range("Leader index out of range");
     }
 
@@ -82,28 +47,18 @@ void LeadershipSystem::removePotentialLeader(int index) {
     // as the Kingdom class has responsibility for the current leader
     if (kingdom && potentialLeaders[index] == kingdom->getCurrentLeader()) {
         // Just shift the pointers without deleting
-        for (int i = index; i < numLeaders - 1; i++) {
-            potentialLeaders[i] = potentialLeaders[i + 1];
-        }
-        potentialLeaders[--numLeaders] = nullptr;
+        potentialLeaders.removeAt(index);
         return;
     }
 
-    // Otherwise, delete the leader object
+    // Otherwise, delete the leader object and close the gap
     delete potentialLeaders[index];
-
-    // Shift remaining elements
-    for (int i = index; i < numLeaders - 1; i++) {
-        potentialLeaders[i] = potentialLeaders[i + 1];
-    }
-
-    // Set the last position to nullptr and decrement count
-    potentialLeaders[--numLeaders] = nullptr;
+    potentialLeaders.removeAt(index);
 }
 
 // Get a potential leader at a specific index
 Leader* LeadershipSystem::getPotentialLeader(int index) const {
-    if (index < 0 || index >= numLeaders) {
+    if (index < 0 || index >= potentialLeaders.size()) {
         throw out_of_range("Leader index out of range");
     }
     return potentialLeaders[index];
@@ -111,7 +66,7 @@ Leader* LeadershipSystem::getPotentialLeader(int index) const {
 
 // Get number of potential leaders
 int LeadershipSystem::getNumPotentialLeaders() const {
-    return numLeaders;
+    return potentialLeaders.size();
 }
 
 // Getters and setters
@@ -228,12 +183,12 @@ void LeadershipSystem::holdElection() {
         throw runtime_error("Cannot hold election: Kingdom is null");
     }
 
-    cout << "An election is being held in " << kingdom->getName() << "!" << endl;
+    LogLine() << "An election is being held in " << kingdom->getName() << "!";
 
     // Need at least 2 leaders for an election
-    if (numLeaders < 2) {
+    if (potentialLeaders.size() < 2) {
         // Generate some candidates if necessary
-        while (numLeaders < 3) {
+        while (potentialLeaders.size() < 3) {
             addPotentialLeader(generateRandomLeader());
         }
     }
@@ -247,9 +202,9 @@ void LeadershipSystem::holdElection() {
     }
 
     // Calculate scores for each candidate
-    int* scores = new int[numLeaders];
+    int* scores = new int[potentialLeaders.size()];
 
-    for (int i = 0; i < numLeaders; i++) {
+    for (int i = 0; i < potentialLeaders.size(); i++) {
         Leader* candidate = potentialLeaders[i];
 
         // Base score is leadership score
@@ -266,13 +221,13 @@ void LeadershipSystem::holdElection() {
         // Corruption reduces score
         scores[i] -= candidate->getCorruption() / 2;
 
-        cout << "Candidate: " << candidate->getTitle() << " " << candidate->getName()
-            << " - Election Score: " << scores[i] << endl;
+        LogLine(LOG_DEBUG) << "Candidate: " << candidate->getTitle() << " " << candidate->getName()
+            << " - Election Score: " << scores[i];
     }
 
     // Find the winner
     int winnerIndex = 0;
-    for (int i = 1; i < numLeaders; i++) {
+    for (int i = 1; i < potentialLeaders.size(); i++) {
         if (scores[i] > scores[winnerIndex]) {
             winnerIndex = i;
         }
@@ -284,13 +239,13 @@ void LeadershipSystem::holdElection() {
 
     // If the winner is already the current leader, increment term
     if (winner == currentLeader) {
-        cout << currentLeader->getTitle() << " " << currentLeader->getName()
-            << " has been re-elected!" << endl;
+        LogLine() << currentLeader->getTitle() << " " << currentLeader->getName()
+            << " has been re-elected!";
     }
     else {
         // Set the new leader
-        cout << winner->getTitle() << " " << winner->getName()
-            << " has been elected as the new leader!" << endl;
+        LogLine() << winner->getTitle() << " " << winner->getName()
+            << " has been elected as the new leader!";
         kingdom->setCurrentLeader(winner);
     }
 
@@ -354,11 +309,11 @@ void LeadershipSystem::handleCoup() {
         throw runtime_error("Cannot handle coup: Current leader is null");
     }
 
-    cout << "A military coup has been launched against " << currentLeader->getTitle()
-        << " " << currentLeader->getName() << "!" << endl;
+    LogLine(LOG_WARNING) << "A military coup has been launched against " << currentLeader->getTitle()
+        << " " << currentLeader->getName() << "!";
 
     // Need at least one potential replacement
-    if (numLeaders < 2) {
+    if (potentialLeaders.size() < 2) {
         // Generate a new leader if necessary
         Leader* newLeader = generateRandomLeader();
         addPotentialLeader(newLeader);
@@ -368,7 +323,7 @@ void LeadershipSystem::handleCoup() {
     int coupLeaderIndex = -1;
     int highestMilitarySkill = -1;
 
-    for (int i = 0; i < numLeaders; i++) {
+    for (int i = 0; i < potentialLeaders.size(); i++) {
         if (potentialLeaders[i] != currentLeader &&
             potentialLeaders[i]->getMilitarySkill() > highestMilitarySkill) {
             highestMilitarySkill = potentialLeaders[i]->getMilitarySkill();
@@ -382,7 +337,7 @@ void LeadershipSystem::handleCoup() {
         militaryLeader->setMilitarySkill(randomInt(70, 90)); // Higher military skill
         militaryLeader->setTitle("General"); // Military title
         addPotentialLeader(militaryLeader);
-        coupLeaderIndex = numLeaders - 1;
+        coupLeaderIndex = potentialLeaders.size() - 1;
     }
 
     Leader* coupLeader = potentialLeaders[coupLeaderIndex];
@@ -400,8 +355,8 @@ void LeadershipSystem::handleCoup() {
 
     // Determine if coup succeeds
     if (randomInt(1, 100) <= coupSuccess) {
-        cout << "The coup has succeeded! " << coupLeader->getTitle() << " "
-            << coupLeader->getName() << " has seized power!" << endl;
+        LogLine() << "The coup has succeeded! " << coupLeader->getTitle() << " "
+            << coupLeader->getName() << " has seized power!";
 
         // Set the new leader
         kingdom->setCurrentLeader(coupLeader);
@@ -414,8 +369,8 @@ void LeadershipSystem::handleCoup() {
         coupRisk = min(100, coupRisk + 15);
     }
     else {
-        cout << "The coup has failed! " << currentLeader->getTitle() << " "
-            << currentLeader->getName() << " remains in power." << endl;
+        LogLine() << "The coup has failed! " << currentLeader->getTitle() << " "
+            << currentLeader->getName() << " remains in power.";
 
         // Remove the coup leader
         removePotentialLeader(coupLeaderIndex);
@@ -439,17 +394,14 @@ void LeadershipSystem::handleDeath() {
         throw runtime_error("Cannot handle death: Current leader is null");
     }
 
-    cout << currentLeader->getTitle() << " " << currentLeader->getName()
-        << " has died!" << endl;
+    LogLine() << currentLeader->getTitle() << " " << currentLeader->getName()
+        << " has died!";
 
     // Remove the dead leader from potential leaders list
-    for (int i = 0; i < numLeaders; i++) {
+    for (int i = 0; i < potentialLeaders.size(); i++) {
         if (potentialLeaders[i] == currentLeader) {
             // Just remove from the list, don't delete (Kingdom has ownership)
-            for (int j = i; j < numLeaders - 1; j++) {
-                potentialLeaders[j] = potentialLeaders[j + 1];
-            }
-            potentialLeaders[--numLeaders] = nullptr;
+            potentialLeaders.removeAt(i);
             break;
         }
     }
@@ -465,7 +417,7 @@ void LeadershipSystem::handleSuccession() {
     }
 
     // Need at least one potential successor
-    if (numLeaders < 1) {
+    if (potentialLeaders.size() < 1) {
         // Generate new potential leaders
         int newLeaders = randomInt(2, 4);
         for (int i = 0; i < newLeaders; i++) {
@@ -483,7 +435,7 @@ void LeadershipSystem::handleSuccession() {
 
         // Find the leader with the highest leadership score
         int successorIndex = 0;
-        for (int i = 1; i < numLeaders; i++) {
+        for (int i = 1; i < potentialLeaders.size(); i++) {
             if (potentialLeaders[i]->getLeadershipScore() > potentialLeaders[successorIndex]->getLeadershipScore()) {
                 successorIndex = i;
             }
@@ -492,8 +444,8 @@ void LeadershipSystem::handleSuccession() {
         Leader* successor = potentialLeaders[successorIndex];
         successor->setIsElected(false); // Not elected
 
-        cout << successor->getTitle() << " " << successor->getName()
-            << " has assumed leadership of the kingdom." << endl;
+        LogLine() << successor->getTitle() << " " << successor->getName()
+            << " has assumed leadership of the kingdom.";
 
         // Set the new leader
         kingdom->setCurrentLeader(successor);
@@ -524,6 +476,12 @@ void LeadershipSystem::update() {
     // Check if it's election time
     if (turnsToNextElection <= 0) {
         holdElection();
+
+        // The election may have replaced the leader
+        currentLeader = kingdom->getCurrentLeader();
+        if (!currentLeader) {
+            return;
+        }
     }
 
     // Update stability based on current conditions
@@ -571,16 +529,22 @@ void LeadershipSystem::update() {
         stabilityFactor = max(10, min(100, stabilityFactor + change));
 
         if (change > 0) {
-            cout << "Political stability has improved in the kingdom." << endl;
+            LogLine() << "Political stability has improved in the kingdom.";
         }
         else if (change < 0) {
-            cout << "Political stability has deteriorated in the kingdom." << endl;
+            LogLine() << "Political stability has deteriorated in the kingdom.";
         }
     }
 
     // Check for coup
     if (checkForCoup()) {
         handleCoup();
+
+        // A successful coup replaces the leader
+        currentLeader = kingdom->getCurrentLeader();
+        if (!currentLeader) {
+            return;
+        }
     }
 
     // Small chance for leader death (higher for older terms)
@@ -590,10 +554,10 @@ void LeadershipSystem::update() {
     }
 
     // Randomly generate new potential leaders
-    if (numLeaders < 3 && randomInt(1, 5) == 1) {
+    if (potentialLeaders.size() < 3 && randomInt(1, 5) == 1) {
         addPotentialLeader(generateRandomLeader());
-        cout << "A new potential leader, " << potentialLeaders[numLeaders - 1]->getName()
-            << ", has emerged in the kingdom." << endl;
+        LogLine() << "A new potential leader, " << potentialLeaders[potentialLeaders.size() - 1]->getName()
+            << ", has emerged in the kingdom.";
     }
 }
 
@@ -609,10 +573,10 @@ void LeadershipSystem::save(ofstream& file) const {
     file << coupRisk << endl;
 
     // Save number of potential leaders
-    file << numLeaders << endl;
+    file << potentialLeaders.size() << endl;
 
     // Save each potential leader
-    for (int i = 0; i < numLeaders; i++) {
+    for (int i = 0; i < potentialLeaders.size(); i++) {
         if (potentialLeaders[i]) {
             // Check if this is the current leader
             bool isCurrentLeader = (kingdom && potentialLeaders[i] == kingdom->getCurrentLeader());
@@ -643,27 +607,18 @@ void LeadershipSystem::load(ifstream& file) {
     file.ignore(); // Skip newline
 
     // Clean up existing leaders
-    for (int i = 0; i < numLeaders; i++) {
+    for (int i = 0; i < potentialLeaders.size(); i++) {
         // Don't delete the current leader (kingdom owns it)
         if (kingdom && potentialLeaders[i] == kingdom->getCurrentLeader()) {
             continue;
         }
         delete potentialLeaders[i];
-        potentialLeaders[i] = nullptr;
     }
 
-    numLeaders = 0;
+    potentialLeaders.clear();
 
     // Resize array if needed
-    if (loadedNumLeaders > maxLeaders) {
-        delete[] potentialLeaders;
-        maxLeaders = loadedNumLeaders;
-        potentialLeaders = new Leader * [maxLeaders];
-
-        for (int i = 0; i < maxLeaders; i++) {
-            potentialLeaders[i] = nullptr;
-        }
-    }
+    potentialLeaders.reserve(loadedNumLeaders);
 
     // Load each potential leader
     for (int i = 0; i < loadedNumLeaders; i++) {
@@ -685,3 +640,53 @@ void LeadershipSystem::load(ifstream& file) {
         }
     }
 }
+
+// Save leadership system data in binary form
+void LeadershipSystem::saveBinary(SaveWriter& writer) const {
+    writer.writeInt(electionCycle);
+    writer.writeInt(turnsToNextElection);
+    writer.writeInt(stabilityFactor);
+    writer.writeInt(coupRisk);
+
+    // The current leader is saved by the kingdom and only marked here
+    writer.writeInt(potentialLeaders.size());
+    for (int i = 0; i < potentialLeaders.size(); i++) {
+        bool isCurrentLeader = (kingdom && potentialLeaders[i] == kingdom->getCurrentLeader());
+        writer.writeBool(isCurrentLeader);
+        if (!isCurrentLeader) {
+            potentialLeaders[i]->saveBinary(writer);
+        }
+    }
+}
+
+// Load leadership system data in binary form
+void LeadershipSystem::loadBinary(SaveReader& reader) {
+    electionCycle = reader.readInt();
+    turnsToNextElection = reader.readInt();
+    stabilityFactor = reader.readInt();
+    coupRisk = reader.readInt();
+
+    for (int i = 0; i < potentialLeaders.size(); i++) {
+        // Don't delete the current leader (kingdom owns it)
+        if (kingdom && potentialLeaders[i] == kingdom->getCurrentLeader()) {
+            continue;
+        }
+        delete potentialLeaders[i];
+    }
+    potentialLeaders.clear();
+
+    int loadedNumLeaders = reader.readInt();
+    potentialLeaders.reserve(loadedNumLeaders);
+    for (int i = 0; i < loadedNumLeaders; i++) {
+        if (reader.readBool()) {
+            if (kingdom && kingdom->getCurrentLeader()) {
+                addPotentialLeader(kingdom->getCurrentLeader());
+            }
+        }
+        else {
+            Leader* newLeader = new Leader("", "");
+            newLeader->loadBinary(reader);
+            addPotentialLeader(newLeader);
+        }
+    }
+}
@@ -1,4 +1,4 @@
-#include "Stronghold.h"
+#include "StrongHold.h"
 #include <iostream>
 #include <fstream>
 #include <string>
@@ -240,3 +240,27 @@ void LeadershipTrait::load(ifstream& file) {
     file >> isPositive;
     file.ignore(); // Skip newline
 }
+
+// Save leadership trait data in binary form
+void LeadershipTrait::saveBinary(SaveWriter& writer) const {
+    Entity::saveBinary(writer);
+    writer.writeInt(static_cast<int>(traitType));
+    writer.writeInt(charismaEffect);
+    writer.writeInt(intelligenceEffect);
+    writer.writeInt(militaryEffect);
+    writer.writeInt(economicEffect);
+    writer.writeInt(corruptionEffect);
+    writer.writeBool(isPositive);
+}
+
+// Load leadership trait data in binary form
+void LeadershipTrait::loadBinary(SaveReader& reader) {
+    Entity::loadBinary(reader);
+    traitType = static_cast<LeadershipTraitType>(reader.readInt());
+    charismaEffect = reader.readInt();
+    intelligenceEffect = reader.readInt();
+    militaryEffect = reader.readInt();
+    economicEffect = reader.readInt();
+    corruptionEffect = reader.readInt();
+    isPositive = reader.readBool();
+}
@@ -1,22 +1,79 @@
-#include "Stronghold.h"
+#include "StrongHold.h"
 #include <iostream>
 #include <fstream>
 #include <string>
 
 using namespace std;
 
-// Constructor
-MilitaryUnit::MilitaryUnit(const string& name, int count, int attack, int defense, int speed, int foodConsumption)
-    : CombatUnit(name, "", attack, defense, speed), count(count), maxCount(count * 2),
-    morale(70), experience(0), foodConsumption(foodConsumption), trainingLevel(50), isVeteran(false) {
+// Constructor for a unit of a catalog archetype
+MilitaryUnit::MilitaryUnit(string_view name, int archetypeId, int count)
+    : name(name), archetypeId(archetypeId), count(count), maxCount(count * 2), experience(0),
+    attackBonus(0), defenseBonus(0), morale(70), trainingLevel(50), isVeteran(false), isActive(true) {
+
+    // Check the id up front
+    UnitCatalog::getArchetype(archetypeId);
 }
 
-// Destructor
-MilitaryUnit::~MilitaryUnit() {
-    // No dynamic memory to clean up in this class
+// Constructor from explicit stats; the archetype is looked up in the catalog
+MilitaryUnit::MilitaryUnit(string_view name, int count, int attack, int defense, int speed, int foodConsumption)
+    : MilitaryUnit(name, UnitCatalog::findOrAdd(Symbol(name), attack, defense, speed, foodConsumption), count) {
+
+    const UnitArchetype& archetype = getArchetype();
+    attackBonus = attack - archetype.attack;
+    defenseBonus = defense - archetype.defense;
 }
 
 // Getters and setters
+string_view MilitaryUnit::getName() const {
+    return name.view();
+}
+
+Symbol MilitaryUnit::getNameSymbol() const {
+    return name;
+}
+
+string MilitaryUnit::getDescription() const {
+    return isVeteran ? "Veteran " + string(name.view()) : "";
+}
+
+bool MilitaryUnit::getIsActive() const {
+    return isActive;
+}
+
+void MilitaryUnit::setIsActive(bool active) {
+    isActive = active;
+}
+
+int MilitaryUnit::getArchetypeId() const {
+    return archetypeId;
+}
+
+const UnitArchetype& MilitaryUnit::getArchetype() const {
+    return UnitCatalog::getArchetype(archetypeId);
+}
+
+int MilitaryUnit::getAttack() const {
+    return getArchetype().attack + attackBonus;
+}
+
+void MilitaryUnit::setAttack(int value) {
+    if (value < 0) value = 0;
+    attackBonus = value - getArchetype().attack;
+}
+
+int MilitaryUnit::getDefense() const {
+    return getArchetype().defense + defenseBonus;
+}
+
+void MilitaryUnit::setDefense(int value) {
+    if (value < 0) value = 0;
+    defenseBonus = value - getArchetype().defense;
+}
+
+int MilitaryUnit::getSpeed() const {
+    return getArchetype().speed;
+}
+
 int MilitaryUnit::getCount() const {
     return count;
 }
@@ -43,11 +100,12 @@ int MilitaryUnit::getMorale() const {
 }
 
 void MilitaryUnit::adjustMorale(int change) {
-    morale += change;
+    int newMorale = morale + change;
 
     // Keep morale within bounds
-    if (morale < 10) morale = 10;
-    if (morale > 100) morale = 100;
+    if (newMorale < 10) newMorale = 10;
+    if (newMorale > 100) newMorale = 100;
+    morale = static_cast<unsigned char>(newMorale);
 }
 
 int MilitaryUnit::getExperience() const {
@@ -62,16 +120,13 @@ void MilitaryUnit::gainExperience(int amount) {
         isVeteran = true;
 
         // Veterans get bonuses
-        attack += 5;
-        defense += 5;
-
-        // Adjust description
-        description = "Veteran " + name;
+        attackBonus += 5;
+        defenseBonus += 5;
     }
 }
 
 int MilitaryUnit::getFoodConsumption() const {
-    return foodConsumption * count;
+    return getArchetype().foodConsumption * count;
 }
 
 int MilitaryUnit::getTrainingLevel() const {
@@ -85,7 +140,7 @@ bool MilitaryUnit::getIsVeteran() const {
 // Combat methods
 int MilitaryUnit::getCombatStrength() const {
     // Base strength is attack + defense
-    int strength = (attack + defense) * count;
+    int strength = (getAttack() + getDefense()) * count;
 
     // Morale affects strength
     strength = (strength * morale) / 100;
@@ -121,19 +176,20 @@ void MilitaryUnit::train() {
 
     // Small chance to improve stats
     if (randomInt(1, 100) <= 20) {
-        attack += 1;
+        attackBonus += 1;
     }
 
     if (randomInt(1, 100) <= 20) {
-        defense += 1;
+        defenseBonus += 1;
     }
 
     // Improve morale and training level
     adjustMorale(5);
 
     // Increase training level
-    trainingLevel += randomInt(1, 3);
-    if (trainingLevel > 100) trainingLevel = 100;
+    int newTrainingLevel = trainingLevel + randomInt(1, 3);
+    if (newTrainingLevel > 100) newTrainingLevel = 100;
+    trainingLevel = static_cast<unsigned char>(newTrainingLevel);
 }
 
 // Recruit more troops
@@ -152,14 +208,42 @@ void MilitaryUnit::recruit(int newTroops) {
     experience = max(0, experience - 5);
 }
 
-// Override base class's calculatePower method
 int MilitaryUnit::calculatePower() const {
     return getCombatStrength();
 }
 
-// Update method required by Entity base class
+// How well the unit fights on a terrain
+double MilitaryUnit::calculateTerrainModifier(TerrainType battleTerrain) const {
+    return calculateTerrainModifier(getSpeed(), battleTerrain);
+}
+
+// How well units of a speed fight on a terrain. Fast (mounted) units want
+// open ground; slow foot soldiers hold rough ground better.
+double MilitaryUnit::calculateTerrainModifier(int speed, TerrainType battleTerrain) {
+    if (speed >= 8) {
+        switch (battleTerrain) {
+        case PLAINS: return 1.2;
+        case DESERT: return 1.1;
+        case FOREST: return 0.8;
+        case MOUNTAINS: return 0.7;
+        case SWAMP: return 0.7;
+        }
+    }
+    else if (speed <= 5) {
+        switch (battleTerrain) {
+        case FOREST: return 1.1;
+        case MOUNTAINS: return 1.15;
+        case SWAMP: return 0.9;
+        case DESERT: return 0.9;
+        case PLAINS: return 1.0;
+        }
+    }
+    return 1.0;
+}
+
+// Per-turn update of the unit
 void MilitaryUnit::update() {
-    if (!getIsActive()) return;
+    if (!isActive) return;
 
     // Natural morale recovery
     adjustMorale(1);
@@ -170,22 +254,27 @@ void MilitaryUnit::update() {
     }
 }
 
-// Save military unit data to file
+// Save military unit data to file, in the layout of a CombatUnit followed
+// by the unit's own fields
 void MilitaryUnit::save(ofstream& file) const {
     if (!file.is_open()) {
         throw runtime_error("Failed to save MilitaryUnit: File not open");
     }
 
-    // Call base class save first
-    CombatUnit::save(file);
+    const UnitArchetype& archetype = getArchetype();
+    file << name << endl;
+    file << getDescription() << endl;
+    file << isActive << endl;
+    file << archetype.attack + attackBonus << endl;
+    file << archetype.defense + defenseBonus << endl;
+    file << archetype.speed << endl;
 
-    // Save MilitaryUnit-specific attributes
     file << count << endl;
     file << maxCount << endl;
-    file << morale << endl;
+    file << static_cast<int>(morale) << endl;
     file << experience << endl;
-    file << foodConsumption << endl;
-    file << trainingLevel << endl;
+    file << archetype.foodConsumption << endl;
+    file << static_cast<int>(trainingLevel) << endl;
     file << isVeteran << endl;
 }
 
@@ -195,17 +284,75 @@ void MilitaryUnit::load(ifstream& file) {
         throw runtime_error("Failed to load MilitaryUnit: File not open");
     }
 
-    // Call base class load first
-    CombatUnit::load(file);
+    // The description follows from the name and veteran status
+    string text;
+    getline(file, text);
+    name = Symbol(text);
+    getline(file, text);
+    file >> isActive;
+
+    int attack, defense, speed;
+    file >> attack;
+    file >> defense;
+    file >> speed;
 
-    // Load MilitaryUnit-specific attributes
+    int loadMorale, foodConsumption, loadTrainingLevel;
     file >> count;
     file >> maxCount;
-    file >> morale;
+    file >> loadMorale;
     file >> experience;
     file >> foodConsumption;
-    file >> trainingLevel;
+    file >> loadTrainingLevel;
     file >> isVeteran;
-
     file.ignore(); // Skip newline
-}
\ No newline at end of file
+
+    morale = static_cast<unsigned char>(loadMorale);
+    trainingLevel = static_cast<unsigned char>(loadTrainingLevel);
+
+    // Per-unit stats become bonuses over a matching archetype
+    archetypeId = UnitCatalog::findOrAdd(name, attack, defense, speed, foodConsumption);
+    const UnitArchetype& archetype = getArchetype();
+    attackBonus = attack - archetype.attack;
+    defenseBonus = defense - archetype.defense;
+}
+
+// Save military unit data in binary form, with the same fields as the text save
+void MilitaryUnit::saveBinary(SaveWriter& writer) const {
+    const UnitArchetype& archetype = getArchetype();
+    writer.writeSymbol(name);
+    writer.writeBool(isActive);
+    writer.writeInt(archetype.attack + attackBonus);
+    writer.writeInt(archetype.defense + defenseBonus);
+    writer.writeInt(archetype.speed);
+
+    writer.writeInt(count);
+    writer.writeInt(maxCount);
+    writer.writeInt(morale);
+    writer.writeInt(experience);
+    writer.writeInt(archetype.foodConsumption);
+    writer.writeInt(trainingLevel);
+    writer.writeBool(isVeteran);
+}
+
+// Load military unit data in binary form
+void MilitaryUnit::loadBinary(SaveReader& reader) {
+    name = reader.readSymbol();
+    isActive = reader.readBool();
+    int attack = reader.readInt();
+    int defense = reader.readInt();
+    int speed = reader.readInt();
+
+    count = reader.readInt();
+    maxCount = reader.readInt();
+    morale = static_cast<unsigned char>(reader.readInt());
+    experience = reader.readInt();
+    int foodConsumption = reader.readInt();
+    trainingLevel = static_cast<unsigned char>(reader.readInt());
+    isVeteran = reader.readBool();
+
+    // Per-unit stats become bonuses over a matching archetype
+    archetypeId = UnitCatalog::findOrAdd(name, attack, defense, speed, foodConsumption);
+    const UnitArchetype& archetype = getArchetype();
+    attackBonus = attack - archetype.attack;
+    defenseBonus = defense - archetype.defense;
+}
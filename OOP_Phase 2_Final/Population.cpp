@@ -1,4 +1,4 @@
-#include "Stronghold.h"
+#include "StrongHold.h"
 #include <iostream>
 #include <fstream>
 #include <string>
@@ -8,16 +8,12 @@ using namespace std;
 // Constructor
 Population::Population(int initialPopulation)
     : totalPopulation(initialPopulation), growthRate(5), foodConsumptionPerCapita(2),
-    healthLevel(70), unrestActive(false), diseaseSusceptibility(50) {
+    healthLevel(70), unrestActive(false), maxClasses(0),
+    diseaseSusceptibility(50), classPopulations(nullptr), classHappiness(nullptr),
+    classHealth(nullptr), classLoyalty(nullptr), classTaxRates(nullptr), classStarvationDeaths(nullptr) {
 
-    // Initialize dynamic array for social classes
-    maxClasses = 5;
-    numClasses = 0;
-    classes = new SocialClass * [maxClasses];
-
-    for (int i = 0; i < maxClasses; i++) {
-        classes[i] = nullptr;
-    }
+    // Initialize dynamic arrays for social classes
+    reserveClasses(5);
 
     // Create default social classes if initialPopulation > 0
     if (initialPopulation > 0) {
@@ -36,12 +32,34 @@ Population::Population(int initialPopulation)
 // Destructor
 Population::~Population() {
     // Clean up dynamically allocated social classes
-    for (int i = 0; i < numClasses; i++) {
+    for (int i = 0; i < classes.size(); i++) {
         delete classes[i];
     }
 
-    // Clean up the array itself
-    delete[] classes;
+    // Clean up the columns themselves
+    delete[] classPopulations;
+    delete[] classHappiness;
+    delete[] classHealth;
+    delete[] classLoyalty;
+    delete[] classTaxRates;
+    delete[] classStarvationDeaths;
+}
+
+// Grow the class array and the per-class columns together
+void Population::reserveClasses(int newMaxClasses) {
+    if (newMaxClasses <= maxClasses) {
+        return;
+    }
+
+    classes.reserve(newMaxClasses);
+    growArray(classPopulations, classes.size(), newMaxClasses);
+    growArray(classHappiness, classes.size(), newMaxClasses);
+    growArray(classHealth, classes.size(), newMaxClasses);
+    growArray(classLoyalty, classes.size(), newMaxClasses);
+    growArray(classTaxRates, classes.size(), newMaxClasses);
+    growArray(classStarvationDeaths, classes.size(), newMaxClasses);
+
+    maxClasses = newMaxClasses;
 }
 
 // Add a new social class to the population
@@ -50,30 +68,14 @@ void Population::addSocialClass(SocialClass* newClass) {
         throw invalid_argument("Cannot add null social class");
     }
 
-    // Check if we need to resize the array
-    if (numClasses >= maxClasses) {
-        // Create a new, larger array
-        int newMaxClasses = maxClasses * 2;
-        SocialClass** newClasses = new SocialClass * [newMaxClasses];
-
-        // Copy existing classes to the new array
-        for (int i = 0; i < numClasses; i++) {
-            newClasses[i] = classes[i];
-        }
-
-        // Initialize remaining slots to nullptr
-        for (int i = numClasses; i < newMaxClasses; i++) {
-            newClasses[i] = nullptr;
-        }
-
-        // Delete the old array and update pointers
-        delete[] classes;
-        classes = newClasses;
-        maxClasses = newMaxClasses;
+    // Check if we need to resize the arrays
+    if (classes.size() >= maxClasses) {
+        reserveClasses(maxClasses * 2);
     }
 
-    // Add the new class
-    classes[numClasses++] = newClass;
+    // Add the new class; its numbers move into the columns
+    newClass->bindToPopulation(this, classes.size());
+    classes.add(newClass);
 
     // Update total population
     recalculateTotalPopulation();
@@ -81,33 +83,36 @@ void Population::addSocialClass(SocialClass* newClass) {
 
 // Remove a social class at a specific index
 void Population::removeClassAt(int index) {
-    if (index < 0 || index >= numClasses) {
+    if (index < 0 || index >= classes.size()) {
         throw out_of_range("Social class index out of range");
     }
 
-    // Delete the class object
+    // Delete the class object and close the gap
     delete classes[index];
+    classes.removeAt(index);
 
-    // Shift remaining elements
-    for (int i = index; i < numClasses - 1; i++) {
-        classes[i] = classes[i + 1];
+    // The later classes move their column slots along
+    for (int i = index; i < classes.size(); i++) {
+        classes[i]->bindToPopulation(this, i);
     }
 
-    // Set the last position to nullptr and decrement count
-    classes[--numClasses] = nullptr;
-
     // Update total population
     recalculateTotalPopulation();
 }
 
 // Recalculate the total population by summing all social classes
 void Population::recalculateTotalPopulation() {
-    totalPopulation = 0;
-    for (int i = 0; i < numClasses; i++) {
-        if (classes[i]) {
-            totalPopulation += classes[i]->getPopulation();
-        }
+    int total = 0;
+    for (int i = 0; i < classes.size(); i++) {
+        total += classPopulations[i];
     }
+    totalPopulation = total;
+}
+
+// Keep the totals in a world store slot (store == nullptr moves them back here)
+void Population::bindToStore(WorldStore* store, int slot) {
+    totalPopulation.bind(store ? &store->totalPopulations : nullptr, slot);
+    healthLevel.bind(store ? &store->healthLevels : nullptr, slot);
 }
 
 // Getters and setters
@@ -150,14 +155,14 @@ void Population::setDiseaseSusceptibility(int susceptibility) {
 }
 
 SocialClass* Population::getSocialClass(int index) const {
-    if (index < 0 || index >= numClasses) {
+    if (index < 0 || index >= classes.size()) {
         throw out_of_range("Social class index out of range");
     }
     return classes[index];
 }
 
 int Population::getNumClasses() const {
-    return numClasses;
+    return classes.size();
 }
 
 int Population::getFoodConsumptionPerCapita() const {
@@ -183,62 +188,22 @@ void Population::update(int availableFood) {
         foodShortageRatio = static_cast<double>(foodShortage) / requiredFood;
     }
 
-    // Iterate through all social classes
-    for (int i = 0; i < numClasses; i++) {
-        if (!classes[i]) continue;
-
-        // Update class
-        classes[i]->update();
-
-        // Handle food shortages - apply effects based on social hierarchy
-        // Lower classes (higher indices) suffer more from shortage
-        if (foodShortageRatio > 0.0) {
-            double classFoodShortage = foodShortageRatio * (1.0 + static_cast<double>(i) / numClasses);
-            classFoodShortage = min(1.0, classFoodShortage); // Cap at 100% shortage
-
-            // Happiness and health penalties based on food shortage
-            int happinessReduction = static_cast<int>(classFoodShortage * 30);
-            int healthReduction = static_cast<int>(classFoodShortage * 15);
-
-            classes[i]->adjustHappiness(-happinessReduction);
-            classes[i]->adjustHealth(-healthReduction);
-
-            // Extreme food shortage causes population decline
-            if (classFoodShortage > 0.5) {
-                int starvationDeaths = static_cast<int>(classes[i]->getPopulation() * (classFoodShortage - 0.5) * 0.1);
-                int newPopulation = max(0, classes[i]->getPopulation() - starvationDeaths);
-                classes[i]->setPopulation(newPopulation);
-
-                if (starvationDeaths > 0) {
-                    cout << starvationDeaths << " people died of starvation in the " << classes[i]->getName() << " class." << endl;
-                }
-            }
-        }
-
-        // Check for unrest
-        if (classes[i]->isUnrestLikely()) {
-            // The larger the class, the more impact its unrest has
-            double unrestProbability = static_cast<double>(classes[i]->getPopulation()) / totalPopulation * 0.5;
-
-            if (randomDouble(0.0, 1.0) < unrestProbability) {
-                unrestActive = true;
-                cout << "Unrest has broken out among the " << classes[i]->getName() << "!" << endl;
-            }
-        }
-    }
+    // Update every class and apply food shortages in one pass over the columns
+    updateClassColumns(foodShortageRatio);
 
-    // Recalculate total population
-    recalculateTotalPopulation();
+    // Report starvation and check for unrest, class by class
+    checkClassUnrest(foodShortageRatio);
 
-    // Calculate new average health level
-    int totalHealth = 0;
-    for (int i = 0; i < numClasses; i++) {
-        if (classes[i]) {
-            totalHealth += classes[i]->getHealth() * classes[i]->getPopulation();
-        }
+    // Recalculate total population and the new average health level together
+    int total = 0;
+    long long totalHealth = 0;
+    for (int i = 0; i < classes.size(); i++) {
+        total += classPopulations[i];
+        totalHealth += static_cast<long long>(classHealth[i]) * classPopulations[i];
     }
+    totalPopulation = total;
 
-    healthLevel = (totalPopulation > 0) ? (totalHealth / totalPopulation) : 50;
+    healthLevel = (total > 0) ? static_cast<int>(totalHealth / total) : 50;
 
     // Update disease susceptibility based on health level
     diseaseSusceptibility = 100 - healthLevel / 2;
@@ -262,21 +227,93 @@ void Population::update(int availableFood) {
     // Constrain growth rate
     growthRate = max(-10, min(20, baseGrowthRate));
 
-    // Apply natural population growth/decline to each class
-    for (int i = 0; i < numClasses; i++) {
-        if (classes[i]) {
-            int classGrowth = static_cast<int>(classes[i]->getPopulation() * growthRate / 1000.0);
-            classes[i]->setPopulation(max(0, classes[i]->getPopulation() + classGrowth));
-        }
+    // Apply natural population growth/decline to each class and total it up
+    total = 0;
+    for (int i = 0; i < classes.size(); i++) {
+        int classGrowth = static_cast<int>(classPopulations[i] * growthRate / 1000.0);
+        classPopulations[i] = max(0, classPopulations[i] + classGrowth);
+        total += classPopulations[i];
     }
-
-    // Recalculate total population again after growth
-    recalculateTotalPopulation();
+    totalPopulation = total;
 
     // Chance for unrest to subside naturally
     if (unrestActive && randomInt(1, 5) == 1) {
         unrestActive = false;
-        cout << "The unrest in the kingdom has subsided." << endl;
+        LogLine() << "The unrest in the kingdom has subsided.";
+    }
+}
+
+// Apply SocialClass::update and the food shortage effects to every class.
+// Lower classes (higher indices) suffer more from shortage.
+void Population::updateClassColumns(double foodShortageRatio) {
+    for (int i = 0; i < classes.size(); i++) {
+        int population = classPopulations[i];
+        int happiness = classHappiness[i];
+        int health = classHealth[i];
+        int loyalty = classLoyalty[i];
+        double taxRate = classTaxRates[i];
+
+        // Natural healing and happiness drift
+        health += (health < 100 && health > 20) ? 1 : 0;
+        happiness -= (happiness > 90) ? 1 : 0;
+        happiness += (happiness < 10) ? 1 : 0;
+
+        // Natural growth based on health and happiness (1% max growth)
+        double growthFactor = (health / 100.0) * (happiness / 100.0);
+        population += static_cast<int>(population * growthFactor * 0.01);
+
+        // Tax rate affects loyalty over time
+        if (taxRate > 0.6) {
+            loyalty = max(0, loyalty - 1);
+        }
+        else if (taxRate < 0.2) {
+            loyalty = min(100, loyalty + 1);
+        }
+
+        // Happiness and health penalties, and starvation under extreme shortage
+        int starvationDeaths = 0;
+        if (foodShortageRatio > 0.0) {
+            double classFoodShortage = foodShortageRatio * (1.0 + static_cast<double>(i) / classes.size());
+            classFoodShortage = min(1.0, classFoodShortage); // Cap at 100% shortage
+
+            happiness = max(0, happiness - static_cast<int>(classFoodShortage * 30));
+            health = max(0, health - static_cast<int>(classFoodShortage * 15));
+
+            if (classFoodShortage > 0.5) {
+                starvationDeaths = static_cast<int>(population * (classFoodShortage - 0.5) * 0.1);
+                population = max(0, population - starvationDeaths);
+            }
+        }
+
+        classPopulations[i] = population;
+        classHappiness[i] = happiness;
+        classHealth[i] = health;
+        classLoyalty[i] = loyalty;
+        classStarvationDeaths[i] = starvationDeaths;
+    }
+}
+
+// Starvation messages and unrest checks after updateClassColumns. Random
+// draws happen here, in class order.
+void Population::checkClassUnrest(double foodShortageRatio) {
+    for (int i = 0; i < classes.size(); i++) {
+        if (foodShortageRatio > 0.0 && classStarvationDeaths[i] > 0) {
+            LogLine(LOG_WARNING) << classStarvationDeaths[i] << " people died of starvation in the " << classes[i]->getName() << " class.";
+        }
+
+        // Same test as SocialClass::isUnrestLikely
+        bool isUnrestLikely = classHappiness[i] < 30 || classLoyalty[i] < 25 ||
+            classTaxRates[i] > 0.7 || classHealth[i] < 20;
+
+        if (isUnrestLikely) {
+            // The larger the class, the more impact its unrest has
+            double unrestProbability = static_cast<double>(classPopulations[i]) / totalPopulation * 0.5;
+
+            if (randomDouble(0.0, 1.0) < unrestProbability) {
+                unrestActive = true;
+                LogLine(LOG_WARNING) << "Unrest has broken out among the " << classes[i]->getName() << "!";
+            }
+        }
     }
 }
 
@@ -288,7 +325,7 @@ void Population::handleEvent(const Event& event) {
     if (effect == 0) return; // No population effect
 
     // Apply effects to each class proportionally
-    for (int i = 0; i < numClasses; i++) {
+    for (int i = 0; i < classes.size(); i++) {
         if (!classes[i]) continue;
 
         // Effect can be positive (population increase) or negative (decrease)
@@ -315,18 +352,18 @@ void Population::handleEvent(const Event& event) {
     // Events can trigger or resolve unrest
     if (effect < -10 && !unrestActive && randomInt(1, 4) == 1) {
         unrestActive = true;
-        cout << "The event has triggered unrest among the population!" << endl;
+        LogLine() << "The event has triggered unrest among the population!";
     }
     else if (effect > 10 && unrestActive && randomInt(1, 3) == 1) {
         unrestActive = false;
-        cout << "The positive event has helped resolve the unrest!" << endl;
+        LogLine() << "The positive event has helped resolve the unrest!";
     }
 }
 
 // Handle effects of weather on population
 void Population::handleWeatherEffects(const Weather& weather) {
     // Apply weather effects to each social class
-    for (int i = 0; i < numClasses; i++) {
+    for (int i = 0; i < classes.size(); i++) {
         if (classes[i]) {
             classes[i]->applyWeatherEffect(weather);
         }
@@ -338,14 +375,14 @@ void Population::handleWeatherEffects(const Weather& weather) {
     // Extreme weather can trigger unrest
     if (weather.getIsExtreme() && !unrestActive && randomInt(1, 4) == 1) {
         unrestActive = true;
-        cout << "The " << weather.getName() << " has caused unrest among the population!" << endl;
+        LogLine() << "The " << weather.getName() << " has caused unrest among the population!";
     }
 }
 
 // Handle effects of disease on population
 void Population::handleDiseaseEffects(const Disease& disease) {
     // Apply disease effects to each social class
-    for (int i = 0; i < numClasses; i++) {
+    for (int i = 0; i < classes.size(); i++) {
         if (classes[i]) {
             classes[i]->applyDiseaseEffect(disease);
         }
@@ -360,7 +397,7 @@ void Population::handleDiseaseEffects(const Disease& disease) {
 
         if (!unrestActive && randomInt(1, 3) == 1) {
             unrestActive = true;
-            cout << "The " << disease.getName() << " outbreak has caused unrest among the population!" << endl;
+            LogLine() << "The " << disease.getName() << " outbreak has caused unrest among the population!";
         }
     }
 }
@@ -379,10 +416,10 @@ void Population::save(ofstream& file) const {
     file << diseaseSusceptibility << endl;
 
     // Save number of classes
-    file << numClasses << endl;
+    file << classes.size() << endl;
 
     // Save each social class
-    for (int i = 0; i < numClasses; i++) {
+    for (int i = 0; i < classes.size(); i++) {
         if (classes[i]) {
             classes[i]->save(file);
         }
@@ -408,23 +445,14 @@ void Population::load(ifstream& file) {
     file.ignore(); // Skip newline
 
     // Delete existing classes
-    for (int i = 0; i < numClasses; i++) {
+    for (int i = 0; i < classes.size(); i++) {
         delete classes[i];
-        classes[i] = nullptr;
     }
 
-    numClasses = 0;
+    classes.clear();
 
-    // Resize array if needed
-    if (loadedNumClasses > maxClasses) {
-        delete[] classes;
-        maxClasses = loadedNumClasses;
-        classes = new SocialClass * [maxClasses];
-
-        for (int i = 0; i < maxClasses; i++) {
-            classes[i] = nullptr;
-        }
-    }
+    // Resize arrays if needed
+    reserveClasses(loadedNumClasses);
 
     // Load each social class
     for (int i = 0; i < loadedNumClasses; i++) {
@@ -433,3 +461,41 @@ void Population::load(ifstream& file) {
         addSocialClass(newClass);
     }
 }
+
+// Save population data in binary form
+void Population::saveBinary(SaveWriter& writer) const {
+    writer.writeInt(totalPopulation);
+    writer.writeInt(growthRate);
+    writer.writeInt(foodConsumptionPerCapita);
+    writer.writeInt(healthLevel);
+    writer.writeBool(unrestActive);
+    writer.writeInt(diseaseSusceptibility);
+
+    writer.writeInt(classes.size());
+    for (int i = 0; i < classes.size(); i++) {
+        classes[i]->saveBinary(writer);
+    }
+}
+
+// Load population data in binary form
+void Population::loadBinary(SaveReader& reader) {
+    totalPopulation = reader.readInt();
+    growthRate = reader.readInt();
+    foodConsumptionPerCapita = reader.readInt();
+    healthLevel = reader.readInt();
+    unrestActive = reader.readBool();
+    diseaseSusceptibility = reader.readInt();
+
+    for (int i = 0; i < classes.size(); i++) {
+        delete classes[i];
+    }
+    classes.clear();
+
+    int loadedNumClasses = reader.readInt();
+    reserveClasses(loadedNumClasses);
+    for (int i = 0; i < loadedNumClasses; i++) {
+        SocialClass* newClass = new SocialClass("", 0, 0.0);
+        newClass->loadBinary(reader);
+        addSocialClass(newClass);
+    }
+}
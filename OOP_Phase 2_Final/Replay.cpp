@@ -0,0 +1,97 @@
+#include "StrongHold.h"
+#include <fstream>
+#include <string>
+#include <cstring>
+
+using namespace std;
+
+// Journal layout: magic, format version and master seed, then every byte
+// of input in the order the game consumed it
+static const char JOURNAL_MAGIC[4] = { 'S', 'H', 'R', 'J' };
+static const unsigned int JOURNAL_FORMAT_VERSION = 1;
+static const size_t JOURNAL_HEADER_SIZE = 16;
+
+// Constructor; the header goes out before any input
+InputRecorder::InputRecorder(const string& filename, streambuf* source, unsigned long long seed)
+    : source(source), journal(filename, ios::binary | ios::trunc), numBytes(0) {
+    if (!source) {
+        throw invalid_argument("Input recorder needs a source");
+    }
+    if (!journal.is_open()) {
+        throw runtime_error("Could not open replay journal for writing: " + filename);
+    }
+
+    // Fixed-width fields are little-endian, as in binary saves
+    char header[JOURNAL_HEADER_SIZE];
+    memcpy(header, JOURNAL_MAGIC, 4);
+    for (int i = 0; i < 4; i++) {
+        header[4 + i] = static_cast<char>((JOURNAL_FORMAT_VERSION >> (8 * i)) & 0xFF);
+    }
+    for (int i = 0; i < 8; i++) {
+        header[8 + i] = static_cast<char>((seed >> (8 * i)) & 0xFF);
+    }
+    journal.write(header, JOURNAL_HEADER_SIZE);
+    journal.flush();
+}
+
+// Peeking does not consume, so nothing is recorded yet
+InputRecorder::int_type InputRecorder::underflow() {
+    return source->sgetc();
+}
+
+InputRecorder::int_type InputRecorder::uflow() {
+    int_type c = source->sbumpc();
+    if (traits_type::eq_int_type(c, traits_type::eof())) {
+        return c;
+    }
+
+    journal.put(traits_type::to_char_type(c));
+    numBytes++;
+
+    // A line is one answer; keep it even if the game dies on the next one
+    if (traits_type::to_char_type(c) == '\n') {
+        journal.flush();
+    }
+    return c;
+}
+
+unsigned long long InputRecorder::getNumBytes() const {
+    return numBytes;
+}
+
+// Constructor; the recorded input is read straight from the mapped file
+InputReplayer::InputReplayer(const string& filename) : file(filename), seed(0) {
+    const char* data = file.getData();
+    if (file.getSize() < JOURNAL_HEADER_SIZE || memcmp(data, JOURNAL_MAGIC, 4) != 0) {
+        throw runtime_error("Not a replay journal: " + filename);
+    }
+
+    unsigned int version = 0;
+    for (int i = 0; i < 4; i++) {
+        version |= static_cast<unsigned int>(static_cast<unsigned char>(data[4 + i])) << (8 * i);
+    }
+    if (version != JOURNAL_FORMAT_VERSION) {
+        throw runtime_error("Unsupported replay journal version " + to_string(version) + " in " + filename);
+    }
+
+    for (int i = 0; i < 8; i++) {
+        seed |= static_cast<unsigned long long>(static_cast<unsigned char>(data[8 + i])) << (8 * i);
+    }
+
+    // The whole input is one get area; the stream never writes to it
+    char* input = const_cast<char*>(data) + JOURNAL_HEADER_SIZE;
+    setg(input, input, input + (file.getSize() - JOURNAL_HEADER_SIZE));
+}
+
+// Only reached once the recorded input is used up
+InputReplayer::int_type InputReplayer::underflow() {
+    throw ReplayFinished();
+}
+
+unsigned long long InputReplayer::getSeed() const {
+    return seed;
+}
+
+unsigned long long InputReplayer::getNumBytes() const {
+    return file.getSize() - JOURNAL_HEADER_SIZE;
+}
@@ -1,4 +1,4 @@
-#include "Stronghold.h"
+#include "StrongHold.h"
 #include <iostream>
 #include <fstream>
 #include <string>
@@ -110,6 +110,14 @@ void Resource::setIsStockpiled(bool stockpiled) {
     isStockpiled = stockpiled;
 }
 
+// Keep amount and rates in a slot of the economy's resource columns
+// (owner == nullptr moves them back here)
+void Resource::bindToEconomy(Economy* owner, int slot) {
+    amount.bind(owner ? &owner->resourceAmounts : nullptr, slot);
+    gatherRate.bind(owner ? &owner->resourceGatherRates : nullptr, slot);
+    consumptionRate.bind(owner ? &owner->resourceConsumptionRates : nullptr, slot);
+}
+
 void Resource::update() {
     gather();
 
@@ -137,3 +145,19 @@ void Resource::load(ifstream& file) {
     file >> consumptionRate;
     file.ignore(); // Skip newline
 }
+
+void Resource::saveBinary(SaveWriter& writer) const {
+    Entity::saveBinary(writer);
+    writer.writeInt(static_cast<int>(type));
+    writer.writeInt(amount);
+    writer.writeInt(gatherRate);
+    writer.writeInt(consumptionRate);
+}
+
+void Resource::loadBinary(SaveReader& reader) {
+    Entity::loadBinary(reader);
+    type = static_cast<ResourceType>(reader.readInt());
+    amount = reader.readInt();
+    gatherRate = reader.readInt();
+    consumptionRate = reader.readInt();
+}
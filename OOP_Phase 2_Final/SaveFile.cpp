@@ -0,0 +1,583 @@
+#include "StrongHold.h"
+#include <fstream>
+#include <string>
+#include <cstring>
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+static const char SAVE_MAGIC[4] = { 'S', 'H', 'L', 'D' };
+static const size_t SAVE_HEADER_SIZE = 24;
+static const size_t SECTION_HEADER_SIZE = 16;
+static const size_t SECTION_ENTRY_SIZE = 24;
+
+// Little-endian byte order, whatever the host uses
+static void storeUInt32(char* out, unsigned int value) {
+    for (int i = 0; i < 4; i++) {
+        out[i] = static_cast<char>((value >> (8 * i)) & 0xFF);
+    }
+}
+
+static void storeUInt64(char* out, unsigned long long value) {
+    for (int i = 0; i < 8; i++) {
+        out[i] = static_cast<char>((value >> (8 * i)) & 0xFF);
+    }
+}
+
+static unsigned int fetchUInt32(const char* in) {
+    unsigned int value = 0;
+    for (int i = 0; i < 4; i++) {
+        value |= static_cast<unsigned int>(static_cast<unsigned char>(in[i])) << (8 * i);
+    }
+    return value;
+}
+
+static unsigned long long fetchUInt64(const char* in) {
+    unsigned long long value = 0;
+    for (int i = 0; i < 8; i++) {
+        value |= static_cast<unsigned long long>(static_cast<unsigned char>(in[i])) << (8 * i);
+    }
+    return value;
+}
+
+// Constructor
+SaveWriter::SaveWriter(bool isFragment)
+    : data(nullptr), size(0), capacity(0), isSectionOpen(false), isFinished(false), isFragment(isFragment),
+    stringIndices(nullptr), numStringIndices(0) {
+
+    if (isFragment) {
+        return;
+    }
+
+    // Header; the section count and table offset are filled in at the end
+    reserveBytes(SAVE_HEADER_SIZE);
+    memcpy(data, SAVE_MAGIC, 4);
+    size = 4;
+    writeUInt32(SAVE_FORMAT_VERSION);
+    writeUInt32(0);
+    writeUInt32(0);
+    writeUInt64(0);
+
+    // Index 0 of the string table is the empty string
+    strings.add(Symbol());
+}
+
+// Destructor
+SaveWriter::~SaveWriter() {
+    delete[] data;
+    delete[] stringIndices;
+}
+
+void SaveWriter::reserveBytes(size_t extraBytes) {
+    if (size + extraBytes <= capacity) {
+        return;
+    }
+
+    size_t newCapacity = max(size + extraBytes, max((size_t)4096, capacity * 2));
+    char* newData = new char[newCapacity];
+    if (size > 0) {
+        memcpy(newData, data, size);
+    }
+    delete[] data;
+    data = newData;
+    capacity = newCapacity;
+}
+
+void SaveWriter::writeUInt32(unsigned int value) {
+    reserveBytes(4);
+    storeUInt32(data + size, value);
+    size += 4;
+}
+
+void SaveWriter::writeUInt64(unsigned long long value) {
+    reserveBytes(8);
+    storeUInt64(data + size, value);
+    size += 8;
+}
+
+// Start a section; its length is filled in by endSection
+void SaveWriter::beginSection(SaveSectionType type) {
+    if (isFinished) {
+        throw logic_error("Save has already been written");
+    }
+    if (isSectionOpen) {
+        throw logic_error("Save section is already open");
+    }
+
+    writeUInt32(static_cast<unsigned int>(type));
+    writeUInt32(0);
+    writeUInt64(0);
+
+    SaveSection section;
+    section.type = type;
+    section.offset = size;
+    section.length = 0;
+    sections.add(section);
+    isSectionOpen = true;
+}
+
+void SaveWriter::endSection() {
+    if (!isSectionOpen) {
+        throw logic_error("No save section is open");
+    }
+
+    SaveSection& section = sections[sections.size() - 1];
+    section.length = size - section.offset;
+    storeUInt64(data + section.offset - 8, section.length);
+    isSectionOpen = false;
+}
+
+void SaveWriter::writeInt(int value) {
+    writeUInt32(static_cast<unsigned int>(value));
+}
+
+void SaveWriter::writeInt64(long long value) {
+    writeUInt64(static_cast<unsigned long long>(value));
+}
+
+void SaveWriter::writeDouble(double value) {
+    unsigned long long bits;
+    memcpy(&bits, &value, sizeof(bits));
+    writeUInt64(bits);
+}
+
+void SaveWriter::writeBool(bool value) {
+    reserveBytes(1);
+    data[size++] = value ? 1 : 0;
+}
+
+// Text goes into the string table once; fields hold its index. Fragments
+// hold the symbol id until they are appended.
+void SaveWriter::writeSymbol(Symbol value) {
+    if (isFragment) {
+        symbolOffsets.add(size);
+        writeUInt32(static_cast<unsigned int>(value.getId()));
+        return;
+    }
+    writeUInt32(findStringIndex(value));
+}
+
+unsigned int SaveWriter::findStringIndex(Symbol value) {
+    int id = value.getId();
+    if (id >= numStringIndices) {
+        int newNumStringIndices = max(id + 1, max(Symbol::getNumSymbols(), numStringIndices * 2));
+        growArray(stringIndices, numStringIndices, newNumStringIndices);
+        for (int i = numStringIndices; i < newNumStringIndices; i++) {
+            stringIndices[i] = -1;
+        }
+        numStringIndices = newNumStringIndices;
+        stringIndices[0] = 0;
+    }
+
+    if (stringIndices[id] < 0) {
+        stringIndices[id] = strings.size();
+        strings.add(value);
+    }
+    return static_cast<unsigned int>(stringIndices[id]);
+}
+
+// Copy the sections of a fragment, turning its symbol ids into indices in
+// this writer's string table
+void SaveWriter::appendSections(const SaveWriter& fragment) {
+    if (!fragment.isFragment) {
+        throw invalid_argument("Only fragments can be appended to a save");
+    }
+    if (fragment.isSectionOpen) {
+        throw logic_error("Save section is still open");
+    }
+
+    int nextSymbol = 0;
+    for (int i = 0; i < fragment.sections.size(); i++) {
+        const SaveSection& section = fragment.sections[i];
+        beginSection(section.type);
+
+        size_t start = size;
+        reserveBytes(section.length);
+        if (section.length > 0) {
+            memcpy(data + size, fragment.data + section.offset, section.length);
+        }
+        size += section.length;
+
+        // Symbol offsets are in write order, so they follow the sections
+        size_t sectionEnd = section.offset + section.length;
+        while (nextSymbol < fragment.symbolOffsets.size() && fragment.symbolOffsets[nextSymbol] < sectionEnd) {
+            size_t offset = fragment.symbolOffsets[nextSymbol++];
+            if (offset < section.offset) {
+                continue;
+            }
+            Symbol symbol = Symbol::fromId(static_cast<int>(fetchUInt32(fragment.data + offset)));
+            storeUInt32(data + start + (offset - section.offset), findStringIndex(symbol));
+        }
+
+        endSection();
+    }
+}
+
+// Start over, keeping the buffer for the next save. Only fragments can be
+// reused; a full save's string table is built up as it is written.
+void SaveWriter::reset() {
+    if (!isFragment) {
+        throw logic_error("Only save fragments can be reset");
+    }
+    size = 0;
+    sections.clear();
+    symbolOffsets.clear();
+    isSectionOpen = false;
+}
+
+// Bytes written so far
+size_t SaveWriter::getSize() const {
+    return size;
+}
+
+void SaveWriter::writeString(string_view value) {
+    writeSymbol(Symbol(value));
+}
+
+// Add the string table and the section table
+void SaveWriter::finish() {
+    if (isFragment) {
+        throw logic_error("A save fragment cannot be written on its own");
+    }
+    if (isFinished) {
+        return;
+    }
+    if (isSectionOpen) {
+        throw logic_error("Save section is still open");
+    }
+
+    beginSection(SECTION_STRINGS);
+    writeUInt32(static_cast<unsigned int>(strings.size()));
+    for (int i = 0; i < strings.size(); i++) {
+        string_view text = strings[i].view();
+        writeUInt32(static_cast<unsigned int>(text.size()));
+        reserveBytes(text.size());
+        if (!text.empty()) {
+            memcpy(data + size, text.data(), text.size());
+        }
+        size += text.size();
+    }
+    endSection();
+
+    size_t tableOffset = size;
+    for (int i = 0; i < sections.size(); i++) {
+        writeUInt32(static_cast<unsigned int>(sections[i].type));
+        writeUInt32(0);
+        writeUInt64(sections[i].offset);
+        writeUInt64(sections[i].length);
+    }
+    storeUInt32(data + 8, static_cast<unsigned int>(sections.size()));
+    storeUInt64(data + 16, tableOffset);
+    isFinished = true;
+}
+
+// Write the save as a file of its own
+void SaveWriter::writeToFile(const string& filename) {
+    finish();
+
+    ofstream file(filename, ios::binary | ios::trunc);
+    if (!file.is_open()) {
+        throw runtime_error("Could not open file for saving: " + filename);
+    }
+    file.write(data, static_cast<streamsize>(size));
+    if (!file) {
+        throw runtime_error("Failed to write save file: " + filename);
+    }
+}
+
+// Add the save to the end of a delta log, in a single write
+void SaveWriter::appendToFile(const string& filename) {
+    finish();
+
+    ofstream file(filename, ios::binary | ios::app);
+    if (!file.is_open()) {
+        throw runtime_error("Could not open file for appending: " + filename);
+    }
+    file.write(data, static_cast<streamsize>(size));
+    if (!file) {
+        throw runtime_error("Failed to append to save file: " + filename);
+    }
+}
+
+// Constructor; maps the file, or reads it into memory where mmap is not available
+MappedFile::MappedFile(const string& filename) : data(nullptr), size(0), isMapped(false) {
+#ifndef _WIN32
+    int descriptor = open(filename.c_str(), O_RDONLY);
+    if (descriptor < 0) {
+        throw runtime_error("Could not open file for loading: " + filename);
+    }
+
+    struct stat fileStatus;
+    if (fstat(descriptor, &fileStatus) != 0) {
+        close(descriptor);
+        throw runtime_error("Could not read file size: " + filename);
+    }
+    size = static_cast<size_t>(fileStatus.st_size);
+
+    if (size > 0) {
+        void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+        if (mapping == MAP_FAILED) {
+            close(descriptor);
+            throw runtime_error("Could not map file: " + filename);
+        }
+        data = static_cast<const char*>(mapping);
+        isMapped = true;
+    }
+    close(descriptor);
+#else
+    ifstream file(filename, ios::binary | ios::ate);
+    if (!file.is_open()) {
+        throw runtime_error("Could not open file for loading: " + filename);
+    }
+    size = static_cast<size_t>(file.tellg());
+    char* buffer = new char[max(size, (size_t)1)];
+    file.seekg(0);
+    file.read(buffer, static_cast<streamsize>(size));
+    data = buffer;
+#endif
+}
+
+// Destructor
+MappedFile::~MappedFile() {
+#ifndef _WIN32
+    if (isMapped) {
+        munmap(const_cast<char*>(data), size);
+    }
+#else
+    delete[] data;
+#endif
+}
+
+const char* MappedFile::getData() const {
+    return data;
+}
+
+size_t MappedFile::getSize() const {
+    return size;
+}
+
+// Constructor for a whole save file
+SaveReader::SaveReader(const string& filename)
+    : ownedFile(new MappedFile(filename)), image(nullptr), imageSize(0), strings(nullptr), numStrings(0),
+    cursor(nullptr), sectionEnd(nullptr), isReadingSnapshot(false) {
+
+    image = ownedFile->getData();
+    imageSize = ownedFile->getSize();
+    try {
+        readTables(filename);
+    }
+    catch (...) {
+        delete[] strings;
+        delete ownedFile;
+        throw;
+    }
+}
+
+// Constructor for the save image at an offset in a delta log; the file
+// must outlive the reader
+SaveReader::SaveReader(const MappedFile& file, size_t offset)
+    : ownedFile(nullptr), image(nullptr), imageSize(0), strings(nullptr), numStrings(0),
+    cursor(nullptr), sectionEnd(nullptr), isReadingSnapshot(false) {
+
+    if (offset > file.getSize()) {
+        throw out_of_range("Save image offset is past the end of the file");
+    }
+    image = file.getData() + offset;
+    imageSize = file.getSize() - offset;
+    try {
+        readTables("delta log");
+    }
+    catch (...) {
+        delete[] strings;
+        throw;
+    }
+}
+
+// Constructor for a fragment still in memory. Its text fields are symbol
+// ids of this run, so there is no string table to read. The fragment must
+// outlive the reader and not be written to while it is read.
+SaveReader::SaveReader(const SaveWriter& fragment)
+    : ownedFile(nullptr), image(fragment.data), imageSize(fragment.size), strings(nullptr), numStrings(0),
+    cursor(nullptr), sectionEnd(nullptr), isReadingSnapshot(true) {
+
+    if (!fragment.isFragment) {
+        throw invalid_argument("Only save fragments can be read from memory");
+    }
+    if (fragment.isSectionOpen) {
+        throw logic_error("Save section is still open");
+    }
+    sections.reserve(fragment.sections.size());
+    for (int i = 0; i < fragment.sections.size(); i++) {
+        sections.add(fragment.sections[i]);
+    }
+}
+
+// Check the header and read the section and string tables
+void SaveReader::readTables(const string& sourceName) {
+    if (imageSize < SAVE_HEADER_SIZE || memcmp(image, SAVE_MAGIC, 4) != 0) {
+        throw runtime_error("Not a binary save file: " + sourceName);
+    }
+
+    unsigned int version = fetchUInt32(image + 4);
+    if (version != SAVE_FORMAT_VERSION) {
+        throw runtime_error("Unsupported save format version " + to_string(version) + " in " + sourceName);
+    }
+
+    unsigned int numSections = fetchUInt32(image + 8);
+    unsigned long long tableOffset = fetchUInt64(image + 16);
+    if (tableOffset > imageSize || (imageSize - tableOffset) / SECTION_ENTRY_SIZE < numSections) {
+        throw runtime_error("Corrupt section table in " + sourceName);
+    }
+
+    // Anything after the table belongs to the next image
+    imageSize = static_cast<size_t>(tableOffset) + numSections * SECTION_ENTRY_SIZE;
+
+    sections.reserve(static_cast<int>(numSections));
+    int stringSection = -1;
+    for (unsigned int i = 0; i < numSections; i++) {
+        const char* entry = image + tableOffset + i * SECTION_ENTRY_SIZE;
+        SaveSection section;
+        section.type = static_cast<SaveSectionType>(fetchUInt32(entry));
+        section.offset = fetchUInt64(entry + 8);
+        section.length = fetchUInt64(entry + 16);
+        if (section.offset > tableOffset || section.length > tableOffset - section.offset) {
+            throw runtime_error("Corrupt section table in " + sourceName);
+        }
+        if (section.type == SECTION_STRINGS) {
+            stringSection = sections.size();
+        }
+        sections.add(section);
+    }
+
+    if (stringSection < 0) {
+        throw runtime_error("Missing string table in " + sourceName);
+    }
+
+    // Intern the text straight from the mapping
+    openSection(stringSection);
+    numStrings = static_cast<int>(readUInt32());
+    if ((size_t)numStrings > static_cast<size_t>(sectionEnd - cursor) / 4) {
+        throw runtime_error("Corrupt string table in " + sourceName);
+    }
+    strings = new Symbol[max(numStrings, 1)];
+    for (int i = 0; i < numStrings; i++) {
+        unsigned int length = readUInt32();
+        const char* text = take(length);
+        strings[i] = Symbol(string_view(text, length));
+    }
+    cursor = nullptr;
+    sectionEnd = nullptr;
+}
+
+// Destructor
+SaveReader::~SaveReader() {
+    delete[] strings;
+    delete ownedFile;
+}
+
+const char* SaveReader::take(size_t numBytes) {
+    if (static_cast<size_t>(sectionEnd - cursor) < numBytes) {
+        throw runtime_error("Save section ends early");
+    }
+    const char* bytes = cursor;
+    cursor += numBytes;
+    return bytes;
+}
+
+unsigned int SaveReader::readUInt32() {
+    return fetchUInt32(take(4));
+}
+
+unsigned long long SaveReader::readUInt64() {
+    return fetchUInt64(take(8));
+}
+
+int SaveReader::getNumSections() const {
+    return sections.size();
+}
+
+SaveSectionType SaveReader::getSectionType(int index) const {
+    return sections.get(index).type;
+}
+
+// Read from the start of a section
+void SaveReader::openSection(int index) {
+    const SaveSection& section = sections.get(index);
+    cursor = image + section.offset;
+    sectionEnd = cursor + section.length;
+}
+
+bool SaveReader::isAtSectionEnd() const {
+    return cursor == sectionEnd;
+}
+
+int SaveReader::readInt() {
+    return static_cast<int>(readUInt32());
+}
+
+long long SaveReader::readInt64() {
+    return static_cast<long long>(readUInt64());
+}
+
+double SaveReader::readDouble() {
+    unsigned long long bits = readUInt64();
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+bool SaveReader::readBool() {
+    return *take(1) != 0;
+}
+
+Symbol SaveReader::readSymbol() {
+    unsigned int index = readUInt32();
+    if (isReadingSnapshot) {
+        return Symbol::fromId(static_cast<int>(index));
+    }
+    if (index >= (unsigned int)numStrings) {
+        throw runtime_error("String index out of range in save");
+    }
+    return strings[index];
+}
+
+string SaveReader::readString() {
+    return string(readSymbol().view());
+}
+
+// Bytes taken by this save image, header to section table
+size_t SaveReader::getImageSize() const {
+    return imageSize;
+}
+
+// A snapshot holds state exactly as it was, so loads from it put state back
+// without applying effects (of events, traits, ...) a second time
+bool SaveReader::getIsReadingSnapshot() const {
+    return isReadingSnapshot;
+}
+
+// True when the file starts like a binary save
+bool SaveReader::isBinarySave(const string& filename) {
+    ifstream file(filename, ios::binary);
+    char magic[4];
+    return file.read(magic, 4) && memcmp(magic, SAVE_MAGIC, 4) == 0;
+}
+
+// Size of the save image at data, or 0 if there is no complete header
+// there. The result can exceed available when the image was cut short.
+size_t SaveReader::findImageSize(const char* data, size_t available) {
+    if (available < SAVE_HEADER_SIZE || memcmp(data, SAVE_MAGIC, 4) != 0) {
+        return 0;
+    }
+    unsigned long long numSections = fetchUInt32(data + 8);
+    unsigned long long tableOffset = fetchUInt64(data + 16);
+    if (tableOffset > available) {
+        return static_cast<size_t>(-1);
+    }
+    return static_cast<size_t>(tableOffset + numSections * SECTION_ENTRY_SIZE);
+}
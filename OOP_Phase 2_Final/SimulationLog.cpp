@@ -0,0 +1,104 @@
+#include "StrongHold.h"
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <mutex>
+
+using namespace std;
+
+LogLevel SimulationLog::minLevel = LOG_INFO;
+ostream* SimulationLog::output = &cout;
+mutex SimulationLog::outputMutex;
+
+// Log buffer bound to the current thread, or nullptr to write straight through
+static thread_local LogBuffer* activeBuffer = nullptr;
+
+// Constructor
+LogBuffer::LogBuffer(const string& tag) : tag(tag) {
+}
+
+void LogBuffer::setTag(const string& newTag) {
+    tag = newTag;
+}
+
+void LogBuffer::append(const string& line) {
+    if (!tag.empty()) {
+        text += "[";
+        text += tag;
+        text += "] ";
+    }
+    text += line;
+    text += '\n';
+}
+
+bool LogBuffer::isEmpty() const {
+    return text.empty();
+}
+
+// Write the buffered lines and start over
+void LogBuffer::writeTo(ostream& out) {
+    out << text;
+    text.clear();
+}
+
+LogLevel SimulationLog::getLevel() {
+    return minLevel;
+}
+
+void SimulationLog::setLevel(LogLevel level) {
+    minLevel = level;
+}
+
+bool SimulationLog::isEnabled(LogLevel level) {
+    return level >= minLevel && level != LOG_NONE;
+}
+
+void SimulationLog::setOutput(ostream& out) {
+    lock_guard<mutex> lock(outputMutex);
+    output = &out;
+}
+
+void SimulationLog::write(const string& line) {
+    if (activeBuffer) {
+        activeBuffer->append(line);
+        return;
+    }
+
+    lock_guard<mutex> lock(outputMutex);
+    *output << line << '\n';
+}
+
+// Write a buffer out in one piece and flush the output once
+void SimulationLog::flush(LogBuffer* buffer) {
+    lock_guard<mutex> lock(outputMutex);
+    if (buffer && !buffer->isEmpty()) {
+        buffer->writeTo(*output);
+    }
+    output->flush();
+}
+
+LogBufferScope::LogBufferScope(LogBuffer* buffer)
+    : previousBuffer(activeBuffer) {
+    activeBuffer = buffer;
+}
+
+LogBufferScope::~LogBufferScope() {
+    activeBuffer = previousBuffer;
+}
+
+// Constructor
+LogLine::LogLine(LogLevel level) : text(nullptr) {
+    if (SimulationLog::isEnabled(level)) {
+        // One formatting stream per thread, reused by every line
+        static thread_local ostringstream lineText;
+        lineText.str("");
+        text = &lineText;
+    }
+}
+
+// Destructor
+LogLine::~LogLine() {
+    if (text) {
+        SimulationLog::write(text->str());
+    }
+}
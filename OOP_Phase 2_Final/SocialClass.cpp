@@ -1,4 +1,4 @@
-#include "Stronghold.h"
+#include "StrongHold.h"
 #include <iostream>
 #include <fstream>
 #include <string>
@@ -67,6 +67,16 @@ void SocialClass::setDiseaseResistance(int resistance) {
     diseaseResistance = resistance;
 }
 
+// Keep this class's numbers in a slot of its population's columns
+// (owner == nullptr moves them back here)
+void SocialClass::bindToPopulation(Population* owner, int slot) {
+    population.bind(owner ? &owner->classPopulations : nullptr, slot);
+    happiness.bind(owner ? &owner->classHappiness : nullptr, slot);
+    health.bind(owner ? &owner->classHealth : nullptr, slot);
+    loyaltyLevel.bind(owner ? &owner->classLoyalty : nullptr, slot);
+    taxRate.bind(owner ? &owner->classTaxRates : nullptr, slot);
+}
+
 // Override the isUnrestLikely method from Human
 bool SocialClass::isUnrestLikely() const {
     // Base likelihood from Human class
@@ -163,3 +173,19 @@ void SocialClass::load(ifstream& file) {
     file >> diseaseResistance;
     file.ignore(); // Skip newline
 }
+
+// Save social class data in binary form
+void SocialClass::saveBinary(SaveWriter& writer) const {
+    Human::saveBinary(writer);
+    writer.writeInt(population);
+    writer.writeDouble(taxRate);
+    writer.writeInt(diseaseResistance);
+}
+
+// Load social class data in binary form
+void SocialClass::loadBinary(SaveReader& reader) {
+    Human::loadBinary(reader);
+    population = reader.readInt();
+    taxRate = reader.readDouble();
+    diseaseResistance = reader.readInt();
+}
@@ -7,6 +7,17 @@
 #include <cstdlib>
 #include <iostream>
 #include <iomanip>
+#include <sstream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <atomic>
+#include <exception>
+#include <chrono>
+#include <new>
+#include <utility>
+#include <string_view>
 using namespace std;
 
 // Forward declarations
@@ -26,6 +37,11 @@ class Economy;
 class Bank;
 class Army;
 class GameEngine;
+class WorldStore;
+class AutosaveJob;
+class SaveWriter;
+class SaveReader;
+class BattleOdds;
 
 // Enumerations for game systems
 enum CombatStrategy { AGGRESSIVE, DEFENSIVE, BALANCED, GUERRILLA };
@@ -48,6 +64,17 @@ enum EventType {
     EVENT_NEUTRAL     // Neutral impact
 };
 
+// What a random event affects
+enum EventCategory {
+    EVENT_UNCATEGORIZED = -1,  // Only known from saves; never drawn
+    EVENT_HARVEST,
+    EVENT_ECONOMIC,
+    EVENT_MILITARY,
+    EVENT_RESOURCE,
+    EVENT_POPULATION,
+    NUM_EVENT_CATEGORIES
+};
+
 enum GameDifficulty {
     EASY,      // More resources, less challenges
     NORMAL,    // Balanced gameplay
@@ -63,33 +90,896 @@ enum ResourceType {
     IRON
 };
 
+enum RandomStream {
+    STREAM_GENERAL,     // Population, economy, army and bank updates
+    STREAM_WEATHER,     // Weather changes
+    STREAM_DISEASE,     // Disease spread
+    STREAM_EVENTS,      // Random events
+    STREAM_LEADERSHIP,  // Elections, coups and succession
+    STREAM_AI,          // AI decisions
+    STREAM_MILITARY,    // Battles
+    NUM_RANDOM_STREAMS
+};
+
+enum LogLevel {
+    LOG_DEBUG,    // Detailed simulation internals
+    LOG_INFO,     // Regular turn messages
+    LOG_WARNING,  // Problems the player should act on
+    LOG_NONE      // Logging switched off
+};
+
+enum TurnPhase {
+    PHASE_LEADERSHIP,  // Succession and leadership system update
+    PHASE_ELECTION,
+    PHASE_COUP,
+    PHASE_WEATHER,
+    PHASE_DISEASE,
+    PHASE_POPULATION,  // Population update and food consumption
+    PHASE_ECONOMY,
+    PHASE_ARMY,
+    PHASE_LEADER,
+    PHASE_EVENTS,
+    PHASE_BANK,
+    PHASE_STABILITY,
+    NUM_TURN_PHASES
+};
+
 // Global Functions
 int randomInt(int min, int max);
 double randomDouble(double min, double max);
+unsigned long long randomSeed();
+void setMasterSeed(unsigned long long seed);
+unsigned long long getMasterSeed();
 string currentDateTime();
 void trimString(string& str);
 
+// PCG32 generator; generators seeded with different stream numbers
+// produce independent sequences
+class RandomGenerator
+{
+private:
+    unsigned long long state;
+    unsigned long long increment;
+public:
+    RandomGenerator(unsigned long long seed = 0, unsigned long long stream = 0);
+
+    void seed(unsigned long long seed, unsigned long long stream);
+    unsigned int next();
+    unsigned int nextBelow(unsigned int bound);
+    double nextDouble();
+
+    void saveBinary(SaveWriter& writer) const;
+    void loadBinary(SaveReader& reader);
+};
+
+// Binds a generator to the calling thread so that randomInt/randomDouble
+// draw from it instead of the master generator
+class RandomStreamScope
+{
+private:
+    RandomGenerator* previousGenerator;
+public:
+    RandomStreamScope(RandomGenerator* generator);
+    ~RandomStreamScope();
+};
+
+// Log lines of one kingdom, held until the end-of-turn flush
+class LogBuffer
+{
+private:
+    string tag;
+    string text;
+public:
+    LogBuffer(const string& tag = "");
+
+    void setTag(const string& newTag);
+    void append(const string& line);
+    bool isEmpty() const;
+    void writeTo(ostream& out);
+};
+
+// Leveled sink for simulation messages. Lines go to the log buffer bound to
+// the calling thread, or straight to the output when none is bound.
+class SimulationLog
+{
+private:
+    static LogLevel minLevel;
+    static ostream* output;
+    static mutex outputMutex;
+public:
+    static LogLevel getLevel();
+    static void setLevel(LogLevel level);
+    static bool isEnabled(LogLevel level);
+    static void setOutput(ostream& out);
+    static void write(const string& line);
+    static void flush(LogBuffer* buffer);
+};
+
+// Binds a log buffer to the calling thread
+class LogBufferScope
+{
+private:
+    LogBuffer* previousBuffer;
+public:
+    LogBufferScope(LogBuffer* buffer);
+    ~LogBufferScope();
+};
+
+// A single log line, written when it goes out of scope; nothing is
+// formatted when its level is disabled
+class LogLine
+{
+private:
+    ostringstream* text;  // nullptr when the level is disabled
+public:
+    LogLine(LogLevel level = LOG_INFO);
+    ~LogLine();
+
+    template <class T>
+    LogLine& operator<<(const T& value) {
+        if (text) {
+            *text << value;
+        }
+        return *this;
+    }
+};
+
+// Histogram of durations in nanoseconds, four buckets per power of two
+class LatencyHistogram
+{
+private:
+    static const int NUM_BUCKETS = 256;
+    unsigned long long counts[NUM_BUCKETS];
+    unsigned long long numSamples;
+    unsigned long long totalNanoseconds;
+    unsigned long long maxNanoseconds;
+public:
+    LatencyHistogram();
+
+    void record(unsigned long long nanoseconds);
+    void merge(const LatencyHistogram& other);
+    unsigned long long getCount() const;
+    unsigned long long getTotal() const;
+    unsigned long long getMax() const;
+    double getMean() const;
+    unsigned long long getPercentile(double percent) const;
+};
+
+// Phase timings collected over one kingdom's turns
+class TurnProfile
+{
+private:
+    LatencyHistogram phases[NUM_TURN_PHASES];
+public:
+    void record(TurnPhase phase, unsigned long long nanoseconds);
+    void merge(const TurnProfile& other);
+    const LatencyHistogram& getPhase(TurnPhase phase) const;
+    void writeReport(ostream& out) const;
+
+    static string getPhaseName(TurnPhase phase);
+};
+
+// Global switch for turn profiling
+class TurnProfiler
+{
+private:
+    static bool isEnabled;
+public:
+    static bool getIsEnabled();
+    static void setIsEnabled(bool enabled);
+};
+
+// Times consecutive phases of a turn; each lap ends the named phase.
+// Does nothing when created without a profile.
+class PhaseClock
+{
+private:
+    TurnProfile* profile;
+    chrono::steady_clock::time_point lastLap;
+public:
+    PhaseClock(TurnProfile* profile);
+
+    void lap(TurnPhase phase);
+};
+
+// Fixed-size pool of worker threads for data-parallel loops
+class ThreadPool
+{
+private:
+    thread* workers;
+    int numWorkers;
+    mutex poolMutex;
+    condition_variable workAvailable;
+    condition_variable workFinished;
+    const function<void(int)>* currentTask;
+    int taskCount;
+    atomic<int> nextIndex;
+    int busyWorkers;
+    unsigned long generation;
+    bool isStopping;
+    exception_ptr firstError;
+    int firstErrorIndex;
+
+    void workerLoop();
+    void runTasks();
+
+public:
+    ThreadPool(int numThreads);
+    ~ThreadPool();
+
+    int getNumThreads() const;
+    void parallelFor(int count, const function<void(int)>& task);
+};
+
+// Scalar that lives in its object until it is bound to a slot of a column
+// array, such as a WorldStore column; reads and writes then go to the column
+template <class T>
+class ColumnField
+{
+private:
+    T localValue;
+    T* const* column;  // Address of the column array, nullptr when unbound
+    int slot;
+
+public:
+    ColumnField(T initialValue = T()) : localValue(initialValue), column(nullptr), slot(-1) {
+    }
+
+    ColumnField(const ColumnField& other) : localValue(other.get()), column(nullptr), slot(-1) {
+    }
+
+    // Move the current value to a column slot, or back into the object when
+    // newColumn is nullptr
+    void bind(T* const* newColumn, int newSlot) {
+        T currentValue = get();
+        column = newColumn;
+        slot = newSlot;
+        set(currentValue);
+    }
+
+    T get() const {
+        return column ? (*column)[slot] : localValue;
+    }
+
+    void set(T value) {
+        if (column) {
+            (*column)[slot] = value;
+        }
+        else {
+            localValue = value;
+        }
+    }
+
+    operator T() const {
+        return get();
+    }
+
+    ColumnField& operator=(const ColumnField& other) {
+        set(other.get());
+        return *this;
+    }
+
+    ColumnField& operator=(T value) {
+        set(value);
+        return *this;
+    }
+
+    ColumnField& operator+=(T value) {
+        set(get() + value);
+        return *this;
+    }
+
+    ColumnField& operator-=(T value) {
+        set(get() - value);
+        return *this;
+    }
+};
+
+template <class T>
+istream& operator>>(istream& in, ColumnField<T>& field) {
+    T value;
+    in >> value;
+    field.set(value);
+    return in;
+}
+
+// Replace an array with a larger copy holding its first count elements
+template <class T>
+void growArray(T*& items, int count, int newCapacity) {
+    T* newItems = new T[newCapacity];
+    for (int i = 0; i < count; i++) {
+        newItems[i] = items[i];
+    }
+    delete[] items;
+    items = newItems;
+}
+
+// Growable array of values stored contiguously. The first InlineCapacity
+// values live inside the collection itself, so small collections need no
+// heap block. Growing moves the values, so pointers to elements do not
+// survive an add.
+template <class T, int InlineCapacity = 4>
+class Collection
+{
+private:
+    T* items;
+    int count;
+    int capacity;
+    alignas(T) unsigned char inlineStorage[InlineCapacity * sizeof(T)];
+
+    static_assert(InlineCapacity > 0, "Collection needs room for at least one inline value");
+
+    T* inlineItems() {
+        return reinterpret_cast<T*>(inlineStorage);
+    }
+
+    bool isInline() const {
+        return items == reinterpret_cast<const T*>(inlineStorage);
+    }
+
+    // Move the values into a heap block of newCapacity
+    void reallocate(int newCapacity) {
+        T* newItems = static_cast<T*>(::operator new(sizeof(T) * newCapacity));
+        for (int i = 0; i < count; i++) {
+            new (&newItems[i]) T(std::move(items[i]));
+            items[i].~T();
+        }
+        if (!isInline()) {
+            ::operator delete(items);
+        }
+        items = newItems;
+        capacity = newCapacity;
+    }
+
+    // Take over the values of other, which must not be this; this must be
+    // empty and inline
+    void moveFrom(Collection& other) {
+        if (other.isInline()) {
+            for (int i = 0; i < other.count; i++) {
+                new (&items[i]) T(std::move(other.items[i]));
+                other.items[i].~T();
+            }
+        }
+        else {
+            items = other.items;
+            capacity = other.capacity;
+            other.items = other.inlineItems();
+            other.capacity = InlineCapacity;
+        }
+        count = other.count;
+        other.count = 0;
+    }
+
+    // Give back the heap block, if any, after the values are gone
+    void releaseStorage() {
+        if (!isInline()) {
+            ::operator delete(items);
+            items = inlineItems();
+            capacity = InlineCapacity;
+        }
+    }
+
+public:
+    Collection() : items(inlineItems()), count(0), capacity(InlineCapacity) {
+    }
+
+    Collection(const Collection& other) : Collection() {
+        reserve(other.count);
+        for (int i = 0; i < other.count; i++) {
+            new (&items[i]) T(other.items[i]);
+        }
+        count = other.count;
+    }
+
+    Collection(Collection&& other) noexcept : Collection() {
+        moveFrom(other);
+    }
+
+    Collection& operator=(const Collection& other) {
+        if (this != &other) {
+            clear();
+            reserve(other.count);
+            for (int i = 0; i < other.count; i++) {
+                new (&items[i]) T(other.items[i]);
+            }
+            count = other.count;
+        }
+        return *this;
+    }
+
+    Collection& operator=(Collection&& other) noexcept {
+        if (this != &other) {
+            clear();
+            releaseStorage();
+            moveFrom(other);
+        }
+        return *this;
+    }
+
+    ~Collection() {
+        clear();
+        releaseStorage();
+    }
+
+    // Construct a value in place at the end
+    template <class... Args>
+    T& emplace(Args&&... args) {
+        if (count >= capacity) {
+            // The arguments may refer to a value of this collection
+            T value(std::forward<Args>(args)...);
+            reallocate(capacity * 2);
+            new (&items[count]) T(std::move(value));
+        }
+        else {
+            new (&items[count]) T(std::forward<Args>(args)...);
+        }
+        return items[count++];
+    }
+
+    void add(const T& item) {
+        emplace(item);
+    }
+
+    void add(T&& item) {
+        emplace(std::move(item));
+    }
+
+    // Remove a value and shift the later ones down, keeping their order
+    void removeAt(int index) {
+        if (index < 0 || index >= count) {
+            throw out_of_range("Index out of range");
+        }
+        for (int i = index; i < count - 1; i++) {
+            items[i] = std::move(items[i + 1]);
+        }
+        items[--count].~T();
+    }
+
+    // Remove a value in O(1) by moving the last value into its place
+    void swapRemove(int index) {
+        if (index < 0 || index >= count) {
+            throw out_of_range("Index out of range");
+        }
+        if (index != count - 1) {
+            items[index] = std::move(items[count - 1]);
+        }
+        items[--count].~T();
+    }
+
+    T& get(int index) {
+        if (index < 0 || index >= count) {
+            throw out_of_range("Index out of range");
+        }
+        return items[index];
+    }
+
+    const T& get(int index) const {
+        if (index < 0 || index >= count) {
+            throw out_of_range("Index out of range");
+        }
+        return items[index];
+    }
+
+    // Unchecked access
+    T& operator[](int index) {
+        return items[index];
+    }
+
+    const T& operator[](int index) const {
+        return items[index];
+    }
+
+    T* begin() {
+        return items;
+    }
+
+    T* end() {
+        return items + count;
+    }
+
+    const T* begin() const {
+        return items;
+    }
+
+    const T* end() const {
+        return items + count;
+    }
+
+    int size() const {
+        return count;
+    }
+
+    bool isEmpty() const {
+        return count == 0;
+    }
+
+    int getCapacity() const {
+        return capacity;
+    }
+
+    void reserve(int newCapacity) {
+        if (newCapacity > capacity) {
+            reallocate(newCapacity);
+        }
+    }
+
+    // Destroy all values; the storage is kept for reuse
+    void clear() {
+        for (int i = 0; i < count; i++) {
+            items[i].~T();
+        }
+        count = 0;
+    }
+};
+
+// Block allocator for short-lived simulation objects. Blocks are carved
+// from large chunks and freed blocks are kept on per-size free lists, so
+// once warmed up it serves objects without touching the global heap.
+// reset() hands every chunk back at once.
+class Arena
+{
+private:
+    static const int BLOCK_ALIGNMENT = 16;
+    static const int NUM_SIZE_CLASSES = 32;  // Blocks of up to 512 bytes
+
+    struct FreeBlock
+    {
+        FreeBlock* next;
+    };
+
+    struct Chunk
+    {
+        Chunk* next;
+        size_t size;
+    };
+
+    Chunk* chunks;
+    char* chunkCursor;  // Next unused byte of the newest chunk
+    char* chunkEnd;
+    size_t chunkSize;
+    FreeBlock* freeLists[NUM_SIZE_CLASSES];
+    int numLiveBlocks;
+
+    static int sizeClassOf(size_t size);
+    void addChunk(size_t minSize);
+
+public:
+    Arena(size_t chunkSize = 16384);
+    ~Arena();
+
+    void* allocate(size_t size);
+    void deallocate(void* block, size_t size);
+    void reset();
+
+    int getNumLiveBlocks() const;
+    size_t getReservedBytes() const;
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+};
+
+// Create an object in an arena, or on the heap when there is none
+template <class T, class... Args>
+T* createIn(Arena* arena, Args&&... args) {
+    if (!arena) {
+        return new T(std::forward<Args>(args)...);
+    }
+    return new (arena->allocate(sizeof(T))) T(std::forward<Args>(args)...);
+}
+
+// Destroy an object made by createIn with the same arena
+template <class T>
+void destroyIn(Arena* arena, T* object) {
+    if (!object) {
+        return;
+    }
+    if (!arena) {
+        delete object;
+        return;
+    }
+    object->~T();
+    arena->deallocate(object, sizeof(T));
+}
+
+// Totals and averages over all kingdoms of a WorldStore
+struct WorldSummary
+{
+    int numKingdoms;
+    long long totalPopulation;
+    long long totalGold;
+    double averageStability;
+    double averageHealth;
+    double averageMarketStability;
+    double averageInflation;
+    double averageEmploymentRate;
+    double averageMorale;
+
+    WorldSummary() : numKingdoms(0), totalPopulation(0), totalGold(0), averageStability(0.0),
+        averageHealth(0.0), averageMarketStability(0.0), averageInflation(0.0),
+        averageEmploymentRate(0.0), averageMorale(0.0) {
+    }
+};
+
+// Scalar state of every kingdom in the world, one contiguous array per field.
+// Slots are kept dense: removing a kingdom moves the last one into its slot.
+class WorldStore
+{
+private:
+    Kingdom** owners;
+    int numSlots;
+    int capacity;
+
+public:
+    // Columns, indexed by slot
+    int* stabilityLevels;
+    int* gold;
+    int* totalPopulations;
+    int* healthLevels;
+    int* marketStabilities;
+    double* inflations;
+    int* employmentRates;
+    int* overallMorales;
+
+    WorldStore(int initialCapacity = 16);
+    ~WorldStore();
+
+    int getNumSlots() const;
+    int getCapacity() const;
+    Kingdom* getOwner(int slot) const;
+    void reserve(int newCapacity);
+
+    int addKingdom(Kingdom* kingdom);
+    void removeKingdom(int slot);
+
+    WorldSummary summarize() const;
+};
+
+// Id of an interned string. Equal text is stored once in a table that
+// lives for the whole run, so symbols are copied and compared as ints.
+class Symbol
+{
+private:
+    static const int CHUNK_BITS = 10;
+    static const int CHUNK_SIZE = 1 << CHUNK_BITS;
+    static const int MAX_CHUNKS = 4096;
+
+    static string* chunks[MAX_CHUNKS];  // Text by id; chunks never move
+    static atomic<int> numSymbols;
+    static int* hashSlots;              // Ids by hash of their text, -1 when empty
+    static int numHashSlots;
+    static mutex tableMutex;
+
+    int id;  // 0 is the empty string
+
+    static string_view textOf(int id);
+    static void rehash(int newNumHashSlots);
+    static int findOrAdd(string_view text);
+
+public:
+    Symbol();
+    explicit Symbol(string_view text);
+
+    int getId() const;
+    string_view view() const;
+    bool isEmpty() const;
+    bool operator==(Symbol other) const;
+    bool operator!=(Symbol other) const;
+
+    static Symbol fromId(int id);
+    static int getNumSymbols();
+};
+
+ostream& operator<<(ostream& out, Symbol symbol);
+
+// Kinds of sections in a binary save
+enum SaveSectionType {
+    SECTION_GAME = 1,     // Game engine state
+    SECTION_KINGDOM = 2,  // One kingdom, in game order
+    SECTION_STRINGS = 3,  // Text referred to by index from the other sections
+    SECTION_KINGDOM_DELTA = 4  // Kingdom index, component mask, then the masked components
+};
+
+// Binary save layout, all fields fixed-width little-endian:
+//   header:  "SHLD", u32 version, u32 section count, u32 reserved, u64 table offset
+//   section: u32 type, u32 reserved, u64 payload length, payload
+//   table:   per section u32 type, u32 reserved, u64 payload offset, u64 payload length
+// Offsets are from the start of the header. A delta log is a run of such
+// images appended one after another.
+const unsigned int SAVE_FORMAT_VERSION = 1;
+
+// Where a section's payload lies in a binary save
+struct SaveSection
+{
+    SaveSectionType type;
+    unsigned long long offset;
+    unsigned long long length;
+};
+
+// Builds a binary save in memory and writes it out in one go. Text is
+// written as an index into a string table that is added at the end.
+// A fragment has no header or tables; it holds sections that are built
+// apart, e.g. on other threads, and then appended to a full writer.
+class SaveWriter
+{
+private:
+    char* data;
+    size_t size;
+    size_t capacity;
+    Collection<SaveSection> sections;
+    bool isSectionOpen;
+    bool isFinished;  // String and section tables are in place
+    bool isFragment;
+    int* stringIndices;  // Index in the string table by symbol id, -1 if not in it
+    int numStringIndices;
+    Collection<Symbol> strings;
+    Collection<size_t> symbolOffsets;  // Fragments only: where each symbol id was written
+
+    friend class SaveReader;
+
+    void reserveBytes(size_t extraBytes);
+    void writeUInt32(unsigned int value);
+    void writeUInt64(unsigned long long value);
+    unsigned int findStringIndex(Symbol value);
+    void finish();
+
+public:
+    explicit SaveWriter(bool isFragment = false);
+    ~SaveWriter();
+    SaveWriter(const SaveWriter&) = delete;
+    SaveWriter& operator=(const SaveWriter&) = delete;
+
+    void beginSection(SaveSectionType type);
+    void endSection();
+
+    void writeInt(int value);
+    void writeInt64(long long value);
+    void writeDouble(double value);
+    void writeBool(bool value);
+    void writeSymbol(Symbol value);
+    void writeString(string_view value);
+
+    void appendSections(const SaveWriter& fragment);
+    void reset();
+    size_t getSize() const;
+    void writeToFile(const string& filename);
+    void appendToFile(const string& filename);
+};
+
+// Read-only view of a whole file; memory-mapped where the platform allows
+class MappedFile
+{
+private:
+    const char* data;
+    size_t size;
+    bool isMapped;
+
+public:
+    MappedFile(const string& filename);
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const char* getData() const;
+    size_t getSize() const;
+};
+
+// Reads a binary save straight from the mapped file. Every read is checked
+// against the end of the open section.
+class SaveReader
+{
+private:
+    MappedFile* ownedFile;  // Null when reading an image inside someone else's file
+    const char* image;
+    size_t imageSize;
+    Collection<SaveSection> sections;
+    Symbol* strings;
+    int numStrings;
+    const char* cursor;
+    const char* sectionEnd;
+    bool isReadingSnapshot;  // Reading a fragment in memory, whose text fields are symbol ids
+
+    const char* take(size_t numBytes);
+    unsigned int readUInt32();
+    unsigned long long readUInt64();
+    void readTables(const string& sourceName);
+
+public:
+    SaveReader(const string& filename);
+    SaveReader(const MappedFile& file, size_t offset);
+    explicit SaveReader(const SaveWriter& fragment);
+    ~SaveReader();
+    SaveReader(const SaveReader&) = delete;
+    SaveReader& operator=(const SaveReader&) = delete;
+
+    int getNumSections() const;
+    SaveSectionType getSectionType(int index) const;
+    void openSection(int index);
+    bool isAtSectionEnd() const;
+
+    int readInt();
+    long long readInt64();
+    double readDouble();
+    bool readBool();
+    Symbol readSymbol();
+    string readString();
+
+    size_t getImageSize() const;
+    bool getIsReadingSnapshot() const;
+
+    static bool isBinarySave(const string& filename);
+    static size_t findImageSize(const char* data, size_t available);
+};
+
+// Thrown when a replayed session runs out of recorded input. It is not a
+// std::exception, so the game's error handlers let it through to the
+// code that started the replay.
+class ReplayFinished
+{
+};
+
+// Sits in front of the console input and writes every character the game
+// consumes to a journal, after the master seed, so that the session can be
+// played again exactly
+class InputRecorder : public streambuf
+{
+private:
+    streambuf* source;
+    ofstream journal;
+    unsigned long long numBytes;
+
+protected:
+    virtual int_type underflow() override;
+    virtual int_type uflow() override;
+
+public:
+    InputRecorder(const string& filename, streambuf* source, unsigned long long seed);
+
+    unsigned long long getNumBytes() const;
+};
+
+// Plays back the input of a journal written by InputRecorder
+class InputReplayer : public streambuf
+{
+private:
+    MappedFile file;
+    unsigned long long seed;
+
+protected:
+    virtual int_type underflow() override;
+
+public:
+    InputReplayer(const string& filename);
+
+    unsigned long long getSeed() const;
+    unsigned long long getNumBytes() const;
+};
+
 // Base Entity class for common attributes and methods
 class Entity
 {
 protected:
-    string name;
-    string description;
+    Symbol name;
+    Symbol description;
     bool isActive;
 public:
-    Entity(const string& name, const string& description = "");
+    Entity(string_view name, string_view description = "");
+    Entity(Symbol name, Symbol description);
     virtual ~Entity();
 
-    string getName() const;
-    void setName(const string& newName);
-    string getDescription() const;
-    void setDescription(const string& newDescription);
+    string_view getName() const;
+    Symbol getNameSymbol() const;
+    void setName(string_view newName);
+    string_view getDescription() const;
+    Symbol getDescriptionSymbol() const;
+    void setDescription(string_view newDescription);
     bool getIsActive() const;
     void setIsActive(bool active);
 
     virtual void update() = 0;
     virtual void save(ofstream& file) const;
     virtual void load(ifstream& file);
+    virtual void saveBinary(SaveWriter& writer) const;
+    virtual void loadBinary(SaveReader& reader);
 };
 
 // Resource class for handling different types of resources
@@ -97,9 +987,9 @@ class Resource : public Entity
 {
 private:
     ResourceType type;
-    int amount;
-    int gatherRate;
-    int consumptionRate;
+    ColumnField<int> amount;
+    ColumnField<int> gatherRate;
+    ColumnField<int> consumptionRate;
     int value;
     bool isStockpiled;
 public:
@@ -121,19 +1011,22 @@ public:
     void setValue(int newValue);
     bool getIsStockpiled() const;
     void setIsStockpiled(bool stockpiled);
+    void bindToEconomy(Economy* owner, int slot);
 
     virtual void update() override;
     virtual void save(ofstream& file) const override;
     virtual void load(ifstream& file) override;
+    virtual void saveBinary(SaveWriter& writer) const override;
+    virtual void loadBinary(SaveReader& reader) override;
 };
 
 // Base Human class for population units
 class Human : public Entity
 {
 protected:
-    int happiness;
-    int health;
-    int loyaltyLevel;
+    ColumnField<int> happiness;
+    ColumnField<int> health;
+    ColumnField<int> loyaltyLevel;
 public:
     Human(const string& name, int happiness = 50, int health = 100, int loyaltyLevel = 50);
     virtual ~Human();
@@ -152,14 +1045,16 @@ public:
     virtual void update() override;
     virtual void save(ofstream& file) const override;
     virtual void load(ifstream& file) override;
+    virtual void saveBinary(SaveWriter& writer) const override;
+    virtual void loadBinary(SaveReader& reader) override;
 };
 
 // Social class representation
 class SocialClass : public Human
 {
 private:
-    int population;
-    double taxRate;
+    ColumnField<int> population;
+    ColumnField<double> taxRate;
     int diseaseResistance;
 public:
     SocialClass(const string& name, int initialPopulation, double initialTaxRate);
@@ -172,6 +1067,7 @@ public:
     int calculateTaxRevenue() const;
     int getDiseaseResistance() const;
     void setDiseaseResistance(int resistance);
+    void bindToPopulation(Population* owner, int slot);
 
     virtual bool isUnrestLikely() const override;
     virtual void applyDiseaseEffect(const Disease& disease) override;
@@ -180,6 +1076,8 @@ public:
     virtual void update() override;
     virtual void save(ofstream& file) const override;
     virtual void load(ifstream& file) override;
+    virtual void saveBinary(SaveWriter& writer) const override;
+    virtual void loadBinary(SaveReader& reader) override;
 };
 
 // Environmental Effect base class for weather and disease
@@ -205,6 +1103,8 @@ public:
     virtual void update() override = 0;
     virtual void save(ofstream& file) const override;
     virtual void load(ifstream& file) override;
+    virtual void saveBinary(SaveWriter& writer) const override;
+    virtual void loadBinary(SaveReader& reader) override;
 };
 
 // Disease class for handling epidemics and health issues
@@ -235,6 +1135,8 @@ public:
     virtual void update() override;
     virtual void save(ofstream& file) const override;
     virtual void load(ifstream& file) override;
+    virtual void saveBinary(SaveWriter& writer) const override;
+    virtual void loadBinary(SaveReader& reader) override;
 };
 
 // Weather system implementation
@@ -271,23 +1173,38 @@ public:
     virtual void update() override;
     virtual void save(ofstream& file) const override;
     virtual void load(ifstream& file) override;
+    virtual void saveBinary(SaveWriter& writer) const override;
+    virtual void loadBinary(SaveReader& reader) override;
 };
 
-// Population management
+// Population management. Social classes added to a population keep their
+// numbers in the population's per-class columns, so turn updates run as
+// loops over contiguous arrays.
 class Population
 {
 private:
-    int totalPopulation;
+    ColumnField<int> totalPopulation;
     int growthRate;
     int foodConsumptionPerCapita;
-    int healthLevel;
+    ColumnField<int> healthLevel;
     bool unrestActive;
-    SocialClass** classes;
-    int numClasses;
-    int maxClasses;
+    Collection<SocialClass*> classes;
+    int maxClasses;  // Capacity of the class columns
     int diseaseSusceptibility;
 
+    void reserveClasses(int newMaxClasses);
+    void updateClassColumns(double foodShortageRatio);
+    void checkClassUnrest(double foodShortageRatio);
+
 public:
+    // Per-class columns, indexed like classes
+    int* classPopulations;
+    int* classHappiness;
+    int* classHealth;
+    int* classLoyalty;
+    double* classTaxRates;
+    int* classStarvationDeaths;  // Scratch column filled by updateClassColumns
+
     Population(int initialPopulation = 1000);
     ~Population();
 
@@ -306,6 +1223,7 @@ public:
     int getFoodConsumptionPerCapita() const;
     void setFoodConsumptionPerCapita(int consumption);
     void recalculateTotalPopulation();
+    void bindToStore(WorldStore* store, int slot);
 
     void update(int availableFood);
     void handleEvent(const Event& event);
@@ -313,6 +1231,8 @@ public:
     void handleDiseaseEffects(const Disease& disease);
     void save(ofstream& file) const;
     void load(ifstream& file);
+    void saveBinary(SaveWriter& writer) const;
+    void loadBinary(SaveReader& reader);
 };
 
 // Leadership trait class
@@ -351,6 +1271,8 @@ public:
     virtual void update() override;
     virtual void save(ofstream& file) const override;
     virtual void load(ifstream& file) override;
+    virtual void saveBinary(SaveWriter& writer) const override;
+    virtual void loadBinary(SaveReader& reader) override;
 };
 
 // Leader class
@@ -364,9 +1286,7 @@ private:
     int corruption;
     int leadershipScore;
     int experience;
-    LeadershipTrait** traits;
-    int numTraits;
-    int maxTraits;
+    Collection<LeadershipTrait*> traits;
     int termLength;
     bool isElected;
 
@@ -408,15 +1328,15 @@ public:
     virtual void update() override;
     virtual void save(ofstream& file) const override;
     virtual void load(ifstream& file) override;
+    virtual void saveBinary(SaveWriter& writer) const override;
+    virtual void loadBinary(SaveReader& reader) override;
 };
 
 // Leadership system for managing succession and leadership changes
 class LeadershipSystem
 {
 private:
-    Leader** potentialLeaders;
-    int numLeaders;
-    int maxLeaders;
+    Collection<Leader*> potentialLeaders;
     int electionCycle;
     int turnsToNextElection;
     int stabilityFactor;
@@ -450,6 +1370,8 @@ public:
     void update();
     void save(ofstream& file) const;
     void load(ifstream& file);
+    void saveBinary(SaveWriter& writer) const;
+    void loadBinary(SaveReader& reader);
 };
 
 // Military unit base class
@@ -481,24 +1403,93 @@ public:
     virtual void update() override;
     virtual void save(ofstream& file) const override;
     virtual void load(ifstream& file) override;
+    virtual void saveBinary(SaveWriter& writer) const override;
+    virtual void loadBinary(SaveReader& reader) override;
+};
+
+// Stats shared by every unit of one kind
+struct UnitArchetype
+{
+    Symbol name;
+    int attack;
+    int defense;
+    int speed;
+    int foodConsumption;  // Per soldier
+    int cost;             // Gold to recruit one unit
 };
 
-// Specific military unit types
-class MilitaryUnit : public CombatUnit
+// Archetypes that are always in the catalog, by id
+enum BuiltInArchetype {
+    GARRISON_INFANTRY,     // Starting units of every army
+    GARRISON_ARCHERS,
+    GARRISON_CAVALRY,
+    RECRUIT_INFANTRY,      // Recruitable units, in menu order
+    RECRUIT_ARCHERS,
+    RECRUIT_CAVALRY,
+    RECRUIT_ROYAL_GUARDS,
+    NUM_BUILT_IN_ARCHETYPES
+};
+
+// Table of unit archetypes. Units refer to their archetype by id and keep
+// only what differs per unit. Archetypes may only be added while no turns
+// are running.
+class UnitCatalog
 {
 private:
+    static UnitArchetype* archetypes;
+    static int numArchetypes;
+    static int maxArchetypes;
+    static mutex catalogMutex;
+
+    static int addArchetype(Symbol name, int attack, int defense, int speed, int foodConsumption, int cost);
+
+public:
+    static bool addBuiltInArchetypes();
+    static int findOrAdd(Symbol name, int attack, int defense, int speed, int foodConsumption);
+    static const UnitArchetype& getArchetype(int id);
+    static const UnitArchetype* getArchetypes();
+    static int getNumArchetypes();
+};
+
+// One unit of an army: an archetype plus what has changed for this unit.
+// Units are stored by value in their army, so pointers to them do not
+// survive adding or removing units.
+class MilitaryUnit
+{
+private:
+    Symbol name;
+    int archetypeId;
     int count;
     int maxCount;
-    int morale;
     int experience;
-    int foodConsumption;
-    int trainingLevel;
+    int attackBonus;   // Over the archetype, from training and veterancy
+    int defenseBonus;
+    unsigned char morale;
+    unsigned char trainingLevel;
     bool isVeteran;
+    bool isActive;
+
+    // Army totals and battles read the fields directly in tight loops
+    friend class Army;
+    friend class Battle;
 
 public:
-    MilitaryUnit(const string& name, int count = 0, int attack = 10, int defense = 5, int speed = 5, int foodConsumption = 1);
-    ~MilitaryUnit();
+    MilitaryUnit(string_view name, int archetypeId, int count = 0);
+    MilitaryUnit(string_view name, int count, int attack, int defense, int speed, int foodConsumption = 1);
 
+    string_view getName() const;
+    Symbol getNameSymbol() const;
+    string getDescription() const;
+    bool getIsActive() const;
+    void setIsActive(bool active);
+    int getArchetypeId() const;
+    const UnitArchetype& getArchetype() const;
+
+    int getAttack() const;
+    void setAttack(int value);
+    int getDefense() const;
+    void setDefense(int value);
+    int getSpeed() const;
     int getCount() const;
     void setCount(int newCount);
     int getMaxCount() const;
@@ -508,46 +1499,67 @@ public:
     int getExperience() const;
     void gainExperience(int amount);
     int getFoodConsumption() const;
-    void setFoodConsumption(int amount);
     int getTrainingLevel() const;
     bool getIsVeteran() const;
     int getCombatStrength() const;
     void takeCasualties(int casualties);
     void recruit(int newTroops);
 
-    virtual int calculatePower() const override;
-    virtual void train() override;
+    int calculatePower() const;
+    void train();
     int calculateUpkeepCost() const;
     double calculateTerrainModifier(TerrainType battleTerrain) const;
+    static double calculateTerrainModifier(int speed, TerrainType battleTerrain);
 
-    virtual void update() override;
-    virtual void save(ofstream& file) const override;
-    virtual void load(ifstream& file) override;
+    void update();
+    void save(ofstream& file) const;
+    void load(ifstream& file);
+    void saveBinary(SaveWriter& writer) const;
+    void loadBinary(SaveReader& reader);
 };
 
 // Army class for managing military units
 class Army : public Entity
 {
 private:
-    MilitaryUnit** units;
-    int numUnits;
-    int maxUnits;
+    Collection<MilitaryUnit> units;
     int totalStrength;
-    int overallMorale;
+    ColumnField<int> overallMorale;
     int discipline;
     int trainingLevel;
     int foodConsumption;
     CombatStrategy strategy;
     int lastBattleResult;
 
+    // Sums over the units, kept up to date as units change, so the totals
+    // above are recalculated without rescanning the units
+    long long unitStrengthSum;
+    long long unitMoraleSum;
+    long long unitFoodSum;
+
+    // Battles write their losses to the units directly
+    friend class Battle;
+
+    static int calculateUnitStrength(const UnitArchetype& archetype, const MilitaryUnit& unit);
+    void addToTotals(const MilitaryUnit& unit, int numCopies = 1);
+    void removeFromTotals(const MilitaryUnit& unit);
+    void recountUnits();
+
 public:
     Army(const string& name = "Royal Army");
     ~Army();
 
-    void addUnit(MilitaryUnit* unit);
+    void addUnit(const MilitaryUnit& unit);
+    void addUnits(const MilitaryUnit& unit, int numCopies);
+    void reserveUnits(int numUnits);
     void removeUnit(int index);
-    MilitaryUnit* getUnit(int index) const;
+    const MilitaryUnit* getUnit(int index) const;
     int getNumUnits() const;
+    void takeUnitCasualties(int index, int casualties);
+    void adjustUnitMorale(int index, int change);
+    void trainUnit(int index);
+    void setUnitCount(int index, int count);
+    void setUnitStats(int index, int attack, int defense);
     int getTotalStrength() const;
     int getOverallMorale() const;
     int getMorale() const;
@@ -565,29 +1577,174 @@ public:
     void trainAllUnits();
     void adjustMorale(int amount);
     void train();
-    void recruit(MilitaryUnit* newUnit);
+    void recruit(const MilitaryUnit& newUnit);
     void calculateTotalStrength();
     void calculateOverallMorale();
     void calculateFoodConsumption();
+    void verifyTotals() const;
     int calculateMaintenanceCost() const;
     int getMaintenanceCost() const;
     int calculateAttackPower() const;
     int calculateDefensePower() const;
+    void calculateArchetypeTotals(int* soldiers, int* strengths) const;
     void applyWeatherEffects(const Weather& weather);
     void applyLeaderEffects(const Leader& leader);
     void handleBattleResults(bool victory, int casualties);
     void processBattleResults(bool victory, int casualtyPercentage);
+    void bindToStore(WorldStore* store, int slot);
 
     virtual void update() override;
     virtual void save(ofstream& file) const override;
     virtual void load(ifstream& file) override;
+    virtual void saveBinary(SaveWriter& writer) const override;
+    virtual void loadBinary(SaveReader& reader) override;
+};
+
+// Result of one simulated battle
+struct BattleOutcome
+{
+    bool isAttackerVictory;
+    int numTicks;
+    int attackerCasualties;
+    int defenderCasualties;
+    int attackerSurvivors;
+    int defenderSurvivors;
+};
+
+// Units of one side of a battle, one contiguous array per field, indexed
+// like the army's units
+struct BattleSide
+{
+    float* troops;
+    float* morale;
+    float* attack;        // Damage per soldier per tick, with every modifier applied
+    float* chargeAttack;  // Attack in the first tick, when speed counts most
+    float* defense;       // Damage it takes to kill one soldier
+    float* exposure;      // Share of incoming damage per soldier; fast units are harder to hit
+    float* startTroops;
+    float* startMorale;
+    float* scratch;       // Per-unit terms of the sums a tick needs
+    int numUnits;
+    int capacity;
+    float moraleLossRate; // Morale lost per percent of a unit's troops lost
+    float startTotal;
+};
+
+// How closely a battle is modeled
+enum BattleFidelity {
+    FIDELITY_DETAILED,   // Tick by tick, unit by unit; for battles the player sees
+    FIDELITY_AGGREGATE   // Closed form from army totals; for background wars
+};
+
+// Resolves combat between two armies over discrete ticks, from per-unit
+// attack, defense, speed, morale and terrain plus each army's strategy and
+// the weather. setArmies copies the units into a BattleSide per army, so a
+// tick is a few branch-free loops over contiguous floats; simulate() can
+// then run the same battle any number of times, e.g. for AI-vs-AI wars.
+// resolveAggregate skips the ticks and solves Lanchester's equations for
+// whole armies instead.
+class Battle
+{
+private:
+    BattleSide sides[2];  // Attacker, defender
+    TerrainType terrain;
+    float speedModifier;  // From the weather's movement effect
+    int moraleModifier;   // From the weather's morale effect
+    int maxTicks;
+    float defenderScale;  // Multiplies the defender's troops when a simulation starts
+
+    static void reserveSide(BattleSide& side, int numUnits);
+    void loadSide(BattleSide& side, const Army& army);
+    void resetSides();
+    float dealDamage(const BattleSide& side, bool isFirstTick);
+    float takeDamage(BattleSide& side, float damage);
+    float sumTroops(const BattleSide& side) const;
+    static void applyAggregateResult(const BattleOutcome& outcome, Army& army, bool isAttacker);
+
+public:
+    Battle(TerrainType terrain = PLAINS, const Weather* weather = nullptr);
+    ~Battle();
+    Battle(const Battle&) = delete;
+    Battle& operator=(const Battle&) = delete;
+
+    TerrainType getTerrain() const;
+    int getMaxTicks() const;
+    void setMaxTicks(int ticks);
+    float getDefenderScale() const;
+    void setDefenderScale(float scale);
+
+    void setArmies(const Army& attacker, const Army& defender);
+    void copySetup(const Battle& other);
+    BattleOutcome simulate();
+    void applyResult(const BattleOutcome& outcome, Army& attacker, Army& defender) const;
+    BattleOutcome fight(Army& attacker, Army& defender, BattleFidelity fidelity = FIDELITY_DETAILED);
+    BattleOutcome resolveAggregate(const Army& attacker, const Army& defender) const;
+};
+
+// Battle odds estimated from many simulations. Margins are half-widths of
+// 95% confidence intervals.
+struct BattleOddsEstimate
+{
+    int numSimulations;
+    double winProbability;
+    double winProbabilityMargin;
+    double expectedAttackerCasualties;
+    double attackerCasualtiesMargin;
+    double expectedDefenderCasualties;
+    double defenderCasualtiesMargin;
+    double elapsedMilliseconds;
+    bool isCached;
+
+    BattleOddsEstimate() : numSimulations(0), winProbability(0.0), winProbabilityMargin(0.0),
+        expectedAttackerCasualties(0.0), attackerCasualtiesMargin(0.0), expectedDefenderCasualties(0.0),
+        defenderCasualtiesMargin(0.0), elapsedMilliseconds(0.0), isCached(false) {
+    }
+};
+
+// Estimates the odds of a battle by running randomized simulations of it on
+// worker threads, each on its own copy of the battle, until a time budget or
+// a simulation count runs out. Estimates are cached by a key of the
+// quantized army state, terrain and weather until clearCache.
+class BattleOdds
+{
+private:
+    int numThreads;
+    ThreadPool* threadPool;    // Null with a single thread
+    Battle** workerBattles;    // One per thread
+    double timeBudgetMilliseconds;
+    int maxSimulations;
+    unsigned long long* cacheKeys;
+    BattleOddsEstimate* cachedEstimates;
+    int numCached;
+    int maxCached;
+
+    static unsigned long long hashArmy(unsigned long long hash, const Army& army);
+
+public:
+    BattleOdds(int numThreads = 1);
+    ~BattleOdds();
+    BattleOdds(const BattleOdds&) = delete;
+    BattleOdds& operator=(const BattleOdds&) = delete;
+
+    int getNumThreads() const;
+    double getTimeBudget() const;
+    void setTimeBudget(double milliseconds);
+    int getMaxSimulations() const;
+    void setMaxSimulations(int count);
+    int getNumCached() const;
+    void clearCache();
+
+    static unsigned long long makeKey(const Army& attacker, const Army& defender, TerrainType terrain,
+        const Weather* weather, double defenderSizeError);
+    BattleOddsEstimate estimate(const Army& attacker, const Army& defender, TerrainType terrain,
+        const Weather* weather, double defenderSizeError = 0.0);
 };
 
 // Treasury class for financial management
 class Treasury : public Entity
 {
 private:
-    int gold;
+    ColumnField<int> gold;
     int income;
     int expenses;
     int taxIncome;
@@ -637,10 +1794,13 @@ public:
     void calculateTradeIncome(int tradeLevel, int numResources);
     void calculateMilitaryExpenses(const Army* army);
     void applyTurnChanges();
+    void bindToStore(WorldStore* store, int slot);
 
     virtual void update() override;
     virtual void save(ofstream& file) const override;
     virtual void load(ifstream& file) override;
+    virtual void saveBinary(SaveWriter& writer) const override;
+    virtual void loadBinary(SaveReader& reader) override;
 };
 
 // Economy class for economic simulation
@@ -670,21 +1830,29 @@ private:
     int tradeLevel;
     double taxRate;
     double tariffRate;  // Added tariff rate for international trade
-    int marketStability;
-    double inflation;
-    int employmentRate;
+    ColumnField<int> marketStability;
+    ColumnField<double> inflation;
+    ColumnField<int> employmentRate;
     int corruptionLevel;
-    Resource** resources;
-    int numResources;
-    int maxResources;
+    Collection<Resource*> resources;
+    int maxResources;  // Capacity of the resource columns
+    Resource** resourcesByType;  // First resource of each type, indexed by type
+    int resourceTableSize;
     Bank* bank;
 
     // Trade routes
-    TradeRoute** tradeRoutes;
-    int numTradeRoutes;
-    int maxTradeRoutes;
+    Collection<TradeRoute> tradeRoutes;
+
+    void settleTradeRoute(TradeRoute* route);
+    void reserveResources(int newMaxResources);
+    void indexResourceType(ResourceType type);
 
 public:
+    // Per-resource columns, indexed like resources
+    int* resourceAmounts;
+    int* resourceGatherRates;
+    int* resourceConsumptionRates;
+
     Economy(const string& name, Treasury* treasury);
     ~Economy();
 
@@ -713,6 +1881,7 @@ public:
     Resource* getResource(int index) const;
     Resource* getResourceByType(ResourceType type) const;
     int getNumResources() const;
+    void gatherResources();
 
     // Trade route methods
     void addTradeRoute(Kingdom* targetKingdom, ResourceType exportResource, int exportAmount,
@@ -720,10 +1889,12 @@ public:
     void addTradeRoute(const string& targetKingdomName, ResourceType exportResource, int exportAmount,
         ResourceType importResource, int importAmount);
     void removeTradeRoute(int index);
+    void clearTradeRoutes();
     int getNumTradeRoutes() const;
     int getMaxTradeRoutes() const;
     void displayTradeRoutes() const;
     void processTradeRoutes();
+    void processKingdomTradeRoutes();
 
     void collectTaxes(Population* population);
     void payArmy(Army* army);
@@ -734,23 +1905,26 @@ public:
     bool trade(ResourceType sellResource, int sellAmount, ResourceType buyResource, int buyAmount);
     int calculateProductionOutput() const;
     void calculateInflation();
+    void bindToStore(WorldStore* store, int slot);
 
     virtual void update() override;
     virtual void save(ofstream& file) const override;
     virtual void load(ifstream& file) override;
+    virtual void saveBinary(SaveWriter& writer) const override;
+    virtual void loadBinary(SaveReader& reader) override;
 };
 
 // Loan structure for banking system
 struct Loan
 {
-    string name;
+    Symbol name;
     int amount;
     double interestRate;
     int duration;
     int turnsRemaining;
     bool isActive;
 
-    Loan(const string& loanName)
+    Loan(string_view loanName)
         : name(loanName), amount(0), interestRate(0),
         duration(0), turnsRemaining(0), isActive(false) {
     }
@@ -760,14 +1934,14 @@ struct Loan
 class Investment
 {
 public:
-    string name;
+    Symbol name;
     int amount;
     double returnRate;
     int duration;
     int turnsRemaining;
     bool isActive;
 
-    Investment(const string& investmentName)
+    Investment(string_view investmentName)
         : name(investmentName), amount(0), returnRate(0),
         duration(0), turnsRemaining(0), isActive(false) {
     }
@@ -784,12 +1958,8 @@ private:
     int loanLimit;
     int defaultRisk;
     int fraudLevel;
-    Loan** loans;
-    int numLoans;
-    int maxLoans;
-    Investment** investments;
-    int numInvestments;
-    int maxInvestments;
+    Collection<Loan> loans;
+    Collection<Investment> investments;
 
 public:
     Bank(const string& name);
@@ -824,16 +1994,57 @@ public:
     int displayLoans();
     void displayInvestments();
     bool makeInvestment(int amount, int duration, Treasury* treasury);
+    void clearLoans();
+    void clearInvestments();
+    void saveInvestmentsBinary(SaveWriter& writer) const;
+    void loadInvestmentsBinary(SaveReader& reader);
 
     virtual void update() override;
     virtual void save(ofstream& file) const override;
     virtual void load(ifstream& file) override;
+    virtual void saveBinary(SaveWriter& writer) const override;
+    virtual void loadBinary(SaveReader& reader) override;
+};
+
+// One kind of random event: its text, and what it affects
+struct EventKind
+{
+    Symbol name;
+    Symbol description;
+    EventCategory category;
+    EventType type;
+};
+
+// Interned table of all event kinds. Events refer to their kind by id and
+// share its text. The built-in kinds are always present; more can be loaded
+// from a data file. Kinds may only be added while no turns are running.
+class EventCatalog
+{
+private:
+    static EventKind* kinds;
+    static int numKinds;
+    static int maxKinds;
+    static int* drawTable[NUM_EVENT_CATEGORIES][3];  // Kind ids by category and type
+    static int drawTableSizes[NUM_EVENT_CATEGORIES][3];
+    static mutex catalogMutex;
+
+    static int findKind(Symbol name, Symbol description);
+    static int addKind(Symbol name, Symbol description, EventCategory category, EventType type);
+
+public:
+    static bool addBuiltInKinds();
+    static int intern(Symbol name, Symbol description, EventCategory category, EventType type);
+    static int loadFromFile(const string& filename);
+    static const EventKind& getKind(int id);
+    static int getNumKinds();
+    static int chooseKind(EventCategory category, EventType type);
 };
 
 // Event class for random occurrences
 class Event : public Entity
 {
 private:
+    int kindId;
     EventType type;
     int populationEffect;
     int economyEffect;
@@ -845,8 +2056,11 @@ private:
 
 public:
     Event(const string& name, const string& description, EventType type = EVENT_NEUTRAL);
+    Event(int kindId);
     ~Event();
 
+    int getKindId() const;
+    const EventKind& getKind() const;
     EventType getType() const;
     void setType(EventType newType);
     int getPopulationEffect() const;
@@ -864,15 +2078,32 @@ public:
     ResourceType getAffectedResourceType() const;
     void setAffectedResourceType(ResourceType type);
 
-    static Event* generateRandomEvent();
+    static Event* generateRandomEvent(Arena* arena = nullptr);
     void applyEffects(Kingdom* kingdom);
 
     virtual void update() override;
     virtual void save(ofstream& file) const override;
     virtual void load(ifstream& file) override;
+    virtual void saveBinary(SaveWriter& writer) const override;
+    virtual void loadBinary(SaveReader& reader) override;
 };
 
 // Kingdom class for managing overall game state
+// Parts of a kingdom that are saved separately in a delta checkpoint;
+// bits of a mask, in save order
+enum KingdomComponent {
+    COMPONENT_CORE = 1 << 0,        // Name, control, turn and stability
+    COMPONENT_POPULATION = 1 << 1,
+    COMPONENT_ECONOMY = 1 << 2,     // Including the treasury
+    COMPONENT_ARMY = 1 << 3,
+    COMPONENT_LEADERSHIP = 1 << 4,  // Current leader and leadership system; they share leaders
+    COMPONENT_WEATHER = 1 << 5,
+    COMPONENT_DISEASE = 1 << 6,
+    COMPONENT_BANK = 1 << 7,
+    COMPONENT_EVENTS = 1 << 8,
+    ALL_KINGDOM_COMPONENTS = (1 << 9) - 1
+};
+
 class Kingdom
 {
 private:
@@ -884,13 +2115,20 @@ private:
     LeadershipSystem* leadershipSystem;
     Weather* currentWeather;
     Disease* currentDisease;
-    Event** activeEvents;
-    int numEvents;
-    int maxEvents;
+    Collection<Event*> activeEvents;
     int turn;
     bool isPlayerControlled;
     Bank* bank;
-    int stabilityLevel;
+    ColumnField<int> stabilityLevel;
+    WorldStore* worldStore;  // Holds the kingdom's scalar state when attached
+    int storeSlot;
+    RandomGenerator randomStreams[NUM_RANDOM_STREAMS];
+    LogBuffer logBuffer;
+    TurnProfile* turnProfile;  // Created on the first profiled turn
+    Arena arena;  // Serves weather and events
+    unsigned int dirtyComponents;  // Changed since the last checkpoint
+
+    void releasePooledObjects();
 
 public:
     Kingdom(const string& name, bool isPlayerControlled = true);
@@ -905,7 +2143,7 @@ public:
     void setCurrentLeader(Leader* leader);
     LeadershipSystem* getLeadershipSystem() const;
     Weather* getCurrentWeather() const;
-    void setCurrentWeather(Weather* weather);
+    void setCurrentWeather(Weather* weather);  // weather must come from getArena()
     Disease* getCurrentDisease() const;
     void setCurrentDisease(Disease* disease);
     int getTurn() const;
@@ -913,16 +2151,28 @@ public:
     bool getIsPlayerControlled() const;
     void setIsPlayerControlled(bool isPlayer);
     Bank* getBank() const;
+    Arena* getArena();
     int getStabilityLevel() const;
     void setStabilityLevel(int level);
 
-    void addEvent(Event* event);
+    void addEvent(Event* event);  // event must come from getArena()
     void removeEvent(int index);
     Event* getEvent(int index) const;
     int getNumEvents() const;
 
     void processTurn();
+    void processCrossKingdomEffects();
     void calculateStability();
+    RandomGenerator* getRandomStream(RandomStream stream);
+    void seedRandomStreams(unsigned long long seed);
+    LogBuffer* getLogBuffer();
+    const TurnProfile* getTurnProfile() const;
+
+    void attachToStore(WorldStore* store);
+    void detachFromStore();
+    void bindToStore(WorldStore* store, int slot);
+    WorldStore* getWorldStore() const;
+    int getStoreSlot() const;
 
     void updateResources();
     void updatePopulation();
@@ -939,16 +2189,95 @@ public:
     void save(ofstream& file) const;
     void save(const string& filename) const;
     void load(ifstream& file);
+    void saveBinary(SaveWriter& writer) const;
+    void loadBinary(SaveReader& reader);
     void load(const string& filename);
+
+    void markDirty(unsigned int components);
+    unsigned int getDirtyComponents() const;
+    void clearDirtyComponents();
+    void saveComponentsBinary(SaveWriter& writer, unsigned int components) const;
+    void loadComponentsBinary(SaveReader& reader, unsigned int components);
+    void saveSnapshot(SaveWriter& writer) const;
+    void restoreSnapshot(SaveReader& reader);
 };
 
-// Game Engine for managing the game
-class GameEngine
+// Writes a full binary save of the world as it stood at a turn boundary
+// on a background thread. Kingdoms are serialized in chunks: the thread
+// works from the last chunk down while the next turn claims each chunk
+// before changing one of its kingdoms, so every chunk is serialized once,
+// by whichever side gets to it first.
+class AutosaveJob
 {
 private:
+    enum ChunkState { CHUNK_UNCLAIMED, CHUNK_SERIALIZING, CHUNK_DONE };
+
+    string filename;
+    int turn;
     Kingdom** kingdoms;
     int numKingdoms;
-    int maxKingdoms;
+    int numChunks;
+    SaveWriter gameSection;  // Engine state, taken when the job starts
+    SaveWriter** chunks;     // Fragments; null if serializing failed
+    atomic<int>* chunkStates;
+    atomic<bool> isFinished;
+    string errorMessage;     // First failure
+    mutex jobMutex;
+    condition_variable chunkDone;
+    thread worker;
+
+    void claimChunk(int chunk);
+    void run();
+
+public:
+    static const int CHUNK_SIZE = 16;  // Kingdoms per chunk
+
+    AutosaveJob(const string& filename, GameEngine& engine);
+    ~AutosaveJob();
+    AutosaveJob(const AutosaveJob&) = delete;
+    AutosaveJob& operator=(const AutosaveJob&) = delete;
+
+    void start();
+    void claim(int kingdomIndex);
+    void wait();
+    bool getIsFinished() const;
+};
+
+// In-memory snapshots of the world at the last few turn boundaries, kept
+// in a ring. Each is a save fragment, with symbol ids in place of text;
+// slots keep their buffers, so steady-state snapshots do not allocate.
+class TurnHistory
+{
+private:
+    SaveWriter** snapshots;
+    int* snapshotTurns;
+    int capacity;
+    int numSnapshots;
+    int newestSlot;
+
+public:
+    TurnHistory(int capacity);
+    ~TurnHistory();
+    TurnHistory(const TurnHistory&) = delete;
+    TurnHistory& operator=(const TurnHistory&) = delete;
+
+    SaveWriter& beginSnapshot(int turn);
+    const SaveWriter* findSnapshot(int turn) const;
+    void dropNewerThan(int turn);
+    void clear();
+
+    int getCapacity() const;
+    int getNumSnapshots() const;
+    int getOldestTurn() const;
+    int getNewestTurn() const;
+    size_t getTotalBytes() const;
+};
+
+// Game Engine for managing the game
+class GameEngine
+{
+private:
+    Collection<Kingdom*> kingdoms;
     int currentTurn;
     bool isGameRunning;
     bool isGamePaused;
@@ -958,6 +2287,34 @@ private:
     bool isMultiplayerMode;
     int numHumanPlayers;
     bool chatbotEnabled;
+    bool isHeadlessMode;
+    int turnLimit;
+    int numWorkerThreads;
+    ThreadPool* threadPool;
+    WorldStore worldStore;
+    string checkpointFilename;   // Snapshot that the delta log builds on
+    int numDeltasSinceSnapshot;
+    int compactionInterval;      // Deltas appended before a new full snapshot
+    bool isSnapshotNeeded;       // Kingdoms were added, removed or reloaded
+    string autosaveFilename;
+    int autosaveInterval;        // Turns between autosaves; 0 when off
+    AutosaveJob* autosaveJob;    // Latest autosave, possibly still running
+    bool isLazyLoading;          // Binary saves load their kingdoms on first use
+    SaveReader* lazyReader;      // Save that pending kingdoms are read from
+    int* lazySections;           // Section of each kingdom still to load, or -1
+    int numLazySections;
+    int numPendingKingdoms;
+    unsigned long long lazySeed; // Seeds the random state each pending kingdom loads with
+    TurnHistory* turnHistory;    // Snapshots of recent turns; null when off
+    BattleOdds* battleOdds;      // Created on the first battle plan
+
+    void startAutosave();
+    Kingdom* materializeKingdom(int index);
+    void materializeAllKingdoms();
+    void releaseLazyReader();
+    void takeTurnSnapshot();
+    void clearTurnHistory();
+    void forEachKingdom(const function<void(Kingdom*)>& action);
 
 public:
     GameEngine();
@@ -965,7 +2322,7 @@ public:
 
     void addKingdom(Kingdom* kingdom);
     void removeKingdom(int index);
-    Kingdom* getKingdom(int index) const;
+    Kingdom* getKingdom(int index);
     int getNumKingdoms() const;
     int getCurrentTurn() const;
     void setCurrentTurn(int turn);
@@ -985,6 +2342,12 @@ public:
     void setNumHumanPlayers(int players);
     bool getChatbotEnabled() const;
     void setChatbotEnabled(bool enabled);
+    bool getIsHeadlessMode() const;
+    void setIsHeadlessMode(bool headless);
+    int getTurnLimit() const;
+    void setTurnLimit(int limit);
+    int getNumWorkerThreads() const;
+    void setNumWorkerThreads(int threads);
 
     // Game Flow Methods
     void startGame();
@@ -1028,6 +2391,7 @@ public:
 
     // AI and Game Logic Methods
     void handleAIDecisions();
+    void handleAIDecisions(Kingdom* aiKingdom);
     void generateAIResponse(const string& input, string& response);
     void processChatMessage(const string& message, int fromPlayerId, int toPlayerId);
     void checkGameEndingConditions();
@@ -1040,86 +2404,77 @@ public:
     void handlePlayerChat();
     string getChatbotResponse(const string& message);
 
+    // Headless Simulation Methods
+    void setupHeadlessGame(int numAIKingdoms);
+    int runHeadless(int numTurns);
+    void writeProfileReport(ostream& out) const;
+    WorldSummary summarizeWorld();
+
     // Save/Load Methods
     void saveGame(const string& filename);
     void saveGame();
+    void saveGameBinary(const string& filename);
     void loadGame(const string& filename);
+    void loadGameBinary(const string& filename);
+    void saveCheckpoint(const string& filename);
+    int getCompactionInterval() const;
+    void setCompactionInterval(int numDeltas);
+    void applyDeltaLog(const string& filename);
+    void writeGameSection(SaveWriter& writer) const;
+    void setAutosave(const string& filename, int interval);
+    int getAutosaveInterval() const;
+    void waitForAutosave();
+    bool getIsLazyLoading() const;
+    void setLazyLoading(bool lazy);
+    int getNumPendingKingdoms() const;
+
+    // Turn History Methods
+    int getTurnHistoryDepth() const;
+    void setTurnHistoryDepth(int numTurns);
+    const TurnHistory* getTurnHistory() const;
+    void rewindToTurn(int turn);
+    void rewindInterface();
 };
 
-// Template class for managing collections
-template <class T>
-class Collection
+// Outcome of one game in an ensemble
+struct GameResult
 {
-private:
-    T** items;
-    int count;
-    int capacity;
-
-public:
-    Collection(int initialCapacity = 10) {
-        capacity = initialCapacity;
-        count = 0;
-        items = new T * [capacity];
-        for (int i = 0; i < capacity; i++) {
-            items[i] = nullptr;
-        }
-    }
+    unsigned long long seed;
+    int finalScore;
+    int turnsSurvived;
+    int finalStability;
+    int finalTreasury;
 
-    ~Collection() {
-        for (int i = 0; i < count; i++) {
-            delete items[i];
-        }
-        delete[] items;
-    }
-
-    void add(T* item) {
-        if (count >= capacity) {
-            // Resize the array
-            capacity *= 2;
-            T** newItems = new T * [capacity];
-            for (int i = 0; i < count; i++) {
-                newItems[i] = items[i];
-            }
-            delete[] items;
-            items = newItems;
-        }
-        items[count++] = item;
+    GameResult() : seed(0), finalScore(0), turnsSurvived(0), finalStability(0), finalTreasury(0) {
     }
+};
 
-    void remove(int index) {
-        if (index < 0 || index >= count) {
-            throw out_of_range("Index out of range");
-        }
-        delete items[index];
-        for (int i = index; i < count - 1; i++) {
-            items[i] = items[i + 1];
-        }
-        items[count - 1] = nullptr;
-        count--;
-    }
+// Runs many independent seeded headless games and summarizes their outcomes
+class EnsembleRunner
+{
+private:
+    int numGames;
+    int numKingdoms;
+    int numTurns;
+    int numThreads;
+    unsigned long long baseSeed;
+    GameResult* results;
+    double elapsedSeconds;
 
-    T* get(int index) const {
-        if (index < 0 || index >= count) {
-            throw out_of_range("Index out of range");
-        }
-        return items[index];
-    }
+    GameResult runGame(unsigned long long seed) const;
+    void writeDistribution(ostream& out, const string& label, double* values) const;
 
-    int size() const {
-        return count;
-    }
+public:
+    EnsembleRunner(int numGames, int numKingdoms, int numTurns, unsigned long long baseSeed, int numThreads);
+    ~EnsembleRunner();
 
-    int getCapacity() const {
-        return capacity;
-    }
+    int getNumGames() const;
+    const GameResult& getResult(int index) const;
+    double getElapsedSeconds() const;
+    double getGamesPerSecond() const;
 
-    void clear() {
-        for (int i = 0; i < count; i++) {
-            delete items[i];
-            items[i] = nullptr;
-        }
-        count = 0;
-    }
+    void run();
+    void writeReport(ostream& out) const;
 };
 
 #endif // STRONGHOLD_H
@@ -0,0 +1,123 @@
+#include "StrongHold.h"
+#include <string>
+
+using namespace std;
+
+string* Symbol::chunks[Symbol::MAX_CHUNKS] = {};
+atomic<int> Symbol::numSymbols(1);
+int* Symbol::hashSlots = nullptr;
+int Symbol::numHashSlots = 0;
+mutex Symbol::tableMutex;
+
+// Constructor for the empty string
+Symbol::Symbol() : id(0) {
+}
+
+// Constructor; the text is interned
+Symbol::Symbol(string_view text) : id(text.empty() ? 0 : findOrAdd(text)) {
+}
+
+// Text of an id that is known to exist. Chunks never move, so readers
+// need no lock: whoever holds an id got it after its text was written.
+string_view Symbol::textOf(int id) {
+    if (id == 0) {
+        return string_view();
+    }
+    return chunks[id >> CHUNK_BITS][id & (CHUNK_SIZE - 1)];
+}
+
+// Spread the ids over a new table of numHashSlots (a power of two)
+void Symbol::rehash(int newNumHashSlots) {
+    int* newHashSlots = new int[newNumHashSlots];
+    for (int i = 0; i < newNumHashSlots; i++) {
+        newHashSlots[i] = -1;
+    }
+
+    size_t mask = (size_t)newNumHashSlots - 1;
+    int count = numSymbols.load(memory_order_relaxed);
+    for (int id = 1; id < count; id++) {
+        size_t slot = hash<string_view>()(textOf(id)) & mask;
+        while (newHashSlots[slot] >= 0) {
+            slot = (slot + 1) & mask;
+        }
+        newHashSlots[slot] = id;
+    }
+
+    delete[] hashSlots;
+    hashSlots = newHashSlots;
+    numHashSlots = newNumHashSlots;
+}
+
+// Id of the text, added if it is new
+int Symbol::findOrAdd(string_view text) {
+    lock_guard<mutex> lock(tableMutex);
+
+    int count = numSymbols.load(memory_order_relaxed);
+
+    // Keep the table at most half full
+    if ((count + 1) * 2 > numHashSlots) {
+        rehash(max(256, numHashSlots * 2));
+    }
+
+    size_t mask = (size_t)numHashSlots - 1;
+    size_t slot = hash<string_view>()(text) & mask;
+    while (hashSlots[slot] >= 0) {
+        if (textOf(hashSlots[slot]) == text) {
+            return hashSlots[slot];
+        }
+        slot = (slot + 1) & mask;
+    }
+
+    if (count >= MAX_CHUNKS * CHUNK_SIZE) {
+        throw runtime_error("Symbol table is full");
+    }
+
+    int chunk = count >> CHUNK_BITS;
+    if (!chunks[chunk]) {
+        chunks[chunk] = new string[CHUNK_SIZE];
+    }
+    chunks[chunk][count & (CHUNK_SIZE - 1)] = string(text);
+
+    hashSlots[slot] = count;
+    numSymbols.store(count + 1, memory_order_release);
+    return count;
+}
+
+int Symbol::getId() const {
+    return id;
+}
+
+string_view Symbol::view() const {
+    return textOf(id);
+}
+
+bool Symbol::isEmpty() const {
+    return id == 0;
+}
+
+bool Symbol::operator==(Symbol other) const {
+    return id == other.id;
+}
+
+bool Symbol::operator!=(Symbol other) const {
+    return id != other.id;
+}
+
+// Symbol of an id read back from a save
+Symbol Symbol::fromId(int id) {
+    if (id < 0 || id >= numSymbols.load(memory_order_acquire)) {
+        throw out_of_range("Symbol id out of range");
+    }
+    Symbol symbol;
+    symbol.id = id;
+    return symbol;
+}
+
+// Number of ids handed out, counting the empty string
+int Symbol::getNumSymbols() {
+    return numSymbols.load(memory_order_acquire);
+}
+
+ostream& operator<<(ostream& out, Symbol symbol) {
+    return out << symbol.view();
+}
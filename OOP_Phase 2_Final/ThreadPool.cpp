@@ -0,0 +1,136 @@
+#include "StrongHold.h"
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+using namespace std;
+
+// Constructor
+ThreadPool::ThreadPool(int numThreads)
+    : workers(nullptr), numWorkers(0), currentTask(nullptr), taskCount(0), nextIndex(0),
+    busyWorkers(0), generation(0), isStopping(false), firstError(nullptr), firstErrorIndex(-1) {
+
+    // The calling thread takes part in every loop, so it counts as one of the threads
+    if (numThreads < 1) numThreads = 1;
+    numWorkers = numThreads - 1;
+
+    if (numWorkers > 0) {
+        workers = new thread[numWorkers];
+        for (int i = 0; i < numWorkers; i++) {
+            workers[i] = thread(&ThreadPool::workerLoop, this);
+        }
+    }
+}
+
+// Destructor
+ThreadPool::~ThreadPool() {
+    {
+        lock_guard<mutex> lock(poolMutex);
+        isStopping = true;
+    }
+    workAvailable.notify_all();
+
+    for (int i = 0; i < numWorkers; i++) {
+        workers[i].join();
+    }
+
+    delete[] workers;
+}
+
+int ThreadPool::getNumThreads() const {
+    return numWorkers + 1;
+}
+
+// Run task(0) .. task(count - 1) across the pool and wait for all of them
+void ThreadPool::parallelFor(int count, const function<void(int)>& task) {
+    if (count <= 0) {
+        return;
+    }
+
+    // Nothing to share the work with, run inline
+    if (numWorkers == 0 || count == 1) {
+        for (int i = 0; i < count; i++) {
+            task(i);
+        }
+        return;
+    }
+
+    {
+        lock_guard<mutex> lock(poolMutex);
+        currentTask = &task;
+        taskCount = count;
+        nextIndex = 0;
+        busyWorkers = numWorkers;
+        firstError = nullptr;
+        firstErrorIndex = -1;
+        generation++;
+    }
+    workAvailable.notify_all();
+
+    // The calling thread works too
+    runTasks();
+
+    exception_ptr error;
+    {
+        unique_lock<mutex> lock(poolMutex);
+        workFinished.wait(lock, [this] { return busyWorkers == 0; });
+        currentTask = nullptr;
+        error = firstError;
+        firstError = nullptr;
+    }
+
+    // Report the failure of the lowest index so the result does not depend on scheduling
+    if (error) {
+        rethrow_exception(error);
+    }
+}
+
+// Claim and run indices until the loop is exhausted
+void ThreadPool::runTasks() {
+    while (true) {
+        int index = nextIndex.fetch_add(1);
+        if (index >= taskCount) {
+            break;
+        }
+
+        try {
+            (*currentTask)(index);
+        }
+        catch (...) {
+            lock_guard<mutex> lock(poolMutex);
+            if (firstErrorIndex < 0 || index < firstErrorIndex) {
+                firstError = current_exception();
+                firstErrorIndex = index;
+            }
+        }
+    }
+}
+
+// Body of every worker thread
+void ThreadPool::workerLoop() {
+    unsigned long seenGeneration = 0;
+
+    while (true) {
+        {
+            unique_lock<mutex> lock(poolMutex);
+            workAvailable.wait(lock, [this, seenGeneration] {
+                return isStopping || generation != seenGeneration;
+            });
+
+            if (isStopping) {
+                return;
+            }
+
+            seenGeneration = generation;
+        }
+
+        runTasks();
+
+        {
+            lock_guard<mutex> lock(poolMutex);
+            busyWorkers--;
+        }
+        workFinished.notify_one();
+    }
+}
@@ -1,4 +1,4 @@
-#include "Stronghold.h"
+#include "StrongHold.h"
 #include <iostream>
 #include <fstream>
 #include <string>
@@ -231,6 +231,11 @@ void Treasury::applyTurnChanges() {
     }
 }
 
+// Keep the gold in a world store slot (store == nullptr moves it back here)
+void Treasury::bindToStore(WorldStore* store, int slot) {
+    gold.bind(store ? &store->gold : nullptr, slot);
+}
+
 // Update method required by Entity base class
 void Treasury::update() {
     if (!isActive) return;
@@ -287,4 +292,36 @@ void Treasury::load(ifstream& file) {
     file >> inflation;
 
     file.ignore(); // Skip newline
+}
+
+// Save treasury data in binary form
+void Treasury::saveBinary(SaveWriter& writer) const {
+    Entity::saveBinary(writer);
+    writer.writeInt(gold);
+    writer.writeInt(income);
+    writer.writeInt(expenses);
+    writer.writeInt(taxIncome);
+    writer.writeInt(tradeIncome);
+    writer.writeInt(otherIncome);
+    writer.writeInt(militaryExpenses);
+    writer.writeInt(buildingExpenses);
+    writer.writeInt(otherExpenses);
+    writer.writeInt(corruption);
+    writer.writeDouble(inflation);
+}
+
+// Load treasury data in binary form
+void Treasury::loadBinary(SaveReader& reader) {
+    Entity::loadBinary(reader);
+    gold = reader.readInt();
+    income = reader.readInt();
+    expenses = reader.readInt();
+    taxIncome = reader.readInt();
+    tradeIncome = reader.readInt();
+    otherIncome = reader.readInt();
+    militaryExpenses = reader.readInt();
+    buildingExpenses = reader.readInt();
+    otherExpenses = reader.readInt();
+    corruption = reader.readInt();
+    inflation = reader.readDouble();
 }
\ No newline at end of file
@@ -0,0 +1,99 @@
+#include "StrongHold.h"
+#include <string>
+
+using namespace std;
+
+// Constructor; holds up to capacity snapshots
+TurnHistory::TurnHistory(int capacity)
+    : snapshots(nullptr), snapshotTurns(nullptr), capacity(capacity), numSnapshots(0), newestSlot(-1) {
+    if (capacity < 1) {
+        throw invalid_argument("Turn history needs room for at least one snapshot");
+    }
+
+    snapshots = new SaveWriter*[capacity];
+    snapshotTurns = new int[capacity];
+    for (int i = 0; i < capacity; i++) {
+        snapshots[i] = new SaveWriter(true);
+        snapshotTurns[i] = 0;
+    }
+}
+
+// Destructor
+TurnHistory::~TurnHistory() {
+    for (int i = 0; i < capacity; i++) {
+        delete snapshots[i];
+    }
+    delete[] snapshots;
+    delete[] snapshotTurns;
+}
+
+// Empty fragment to write the snapshot of a turn into. When the ring is
+// full it takes the place of the oldest snapshot. A turn played again after
+// a rewind replaces its old snapshot rather than adding a second one.
+SaveWriter& TurnHistory::beginSnapshot(int turn) {
+    dropNewerThan(turn - 1);
+
+    newestSlot = (newestSlot + 1) % capacity;
+    if (numSnapshots < capacity) {
+        numSnapshots++;
+    }
+
+    snapshotTurns[newestSlot] = turn;
+    snapshots[newestSlot]->reset();
+    return *snapshots[newestSlot];
+}
+
+// Snapshot taken at the start of a turn, or null if it is not held
+const SaveWriter* TurnHistory::findSnapshot(int turn) const {
+    for (int age = 0; age < numSnapshots; age++) {
+        int slot = (newestSlot - age + capacity) % capacity;
+        if (snapshotTurns[slot] == turn) {
+            return snapshots[slot];
+        }
+    }
+    return nullptr;
+}
+
+// Forget the snapshots after a turn, e.g. once the game is rewound to it
+void TurnHistory::dropNewerThan(int turn) {
+    while (numSnapshots > 0 && snapshotTurns[newestSlot] > turn) {
+        newestSlot = (newestSlot - 1 + capacity) % capacity;
+        numSnapshots--;
+    }
+}
+
+void TurnHistory::clear() {
+    numSnapshots = 0;
+    newestSlot = -1;
+}
+
+int TurnHistory::getCapacity() const {
+    return capacity;
+}
+
+int TurnHistory::getNumSnapshots() const {
+    return numSnapshots;
+}
+
+int TurnHistory::getOldestTurn() const {
+    if (numSnapshots == 0) {
+        throw logic_error("Turn history is empty");
+    }
+    return snapshotTurns[(newestSlot - numSnapshots + 1 + capacity) % capacity];
+}
+
+int TurnHistory::getNewestTurn() const {
+    if (numSnapshots == 0) {
+        throw logic_error("Turn history is empty");
+    }
+    return snapshotTurns[newestSlot];
+}
+
+// Memory the held snapshots take up
+size_t TurnHistory::getTotalBytes() const {
+    size_t totalBytes = 0;
+    for (int age = 0; age < numSnapshots; age++) {
+        totalBytes += snapshots[(newestSlot - age + capacity) % capacity]->getSize();
+    }
+    return totalBytes;
+}
@@ -0,0 +1,181 @@
+#include "StrongHold.h"
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <chrono>
+
+using namespace std;
+
+bool TurnProfiler::isEnabled = false;
+
+// Bucket holding a duration: exact below 4 ns, then four buckets per power of two
+static int bucketIndex(unsigned long long nanoseconds) {
+    if (nanoseconds < 4) {
+        return static_cast<int>(nanoseconds);
+    }
+
+    int exponent = 63;
+    while (!(nanoseconds >> exponent)) {
+        exponent--;
+    }
+
+    int subBucket = static_cast<int>((nanoseconds >> (exponent - 2)) & 3);
+    return (exponent - 1) * 4 + subBucket;
+}
+
+// Largest duration that falls into a bucket
+static unsigned long long bucketUpperBound(int index) {
+    if (index < 4) {
+        return index;
+    }
+
+    int exponent = index / 4 + 1;
+    unsigned long long subBucket = index % 4;
+    return ((5 + subBucket) << (exponent - 2)) - 1;
+}
+
+// Constructor
+LatencyHistogram::LatencyHistogram()
+    : numSamples(0), totalNanoseconds(0), maxNanoseconds(0) {
+    for (int i = 0; i < NUM_BUCKETS; i++) {
+        counts[i] = 0;
+    }
+}
+
+void LatencyHistogram::record(unsigned long long nanoseconds) {
+    counts[bucketIndex(nanoseconds)]++;
+    numSamples++;
+    totalNanoseconds += nanoseconds;
+    maxNanoseconds = max(maxNanoseconds, nanoseconds);
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other) {
+    for (int i = 0; i < NUM_BUCKETS; i++) {
+        counts[i] += other.counts[i];
+    }
+    numSamples += other.numSamples;
+    totalNanoseconds += other.totalNanoseconds;
+    maxNanoseconds = max(maxNanoseconds, other.maxNanoseconds);
+}
+
+unsigned long long LatencyHistogram::getCount() const {
+    return numSamples;
+}
+
+unsigned long long LatencyHistogram::getTotal() const {
+    return totalNanoseconds;
+}
+
+unsigned long long LatencyHistogram::getMax() const {
+    return maxNanoseconds;
+}
+
+double LatencyHistogram::getMean() const {
+    return (numSamples > 0) ? static_cast<double>(totalNanoseconds) / numSamples : 0.0;
+}
+
+// Upper bound of the bucket containing the given percentile
+unsigned long long LatencyHistogram::getPercentile(double percent) const {
+    if (numSamples == 0) {
+        return 0;
+    }
+
+    unsigned long long target = static_cast<unsigned long long>(percent / 100.0 * numSamples);
+    if (target >= numSamples) {
+        target = numSamples - 1;
+    }
+
+    unsigned long long seen = 0;
+    for (int i = 0; i < NUM_BUCKETS; i++) {
+        seen += counts[i];
+        if (seen > target) {
+            return min(bucketUpperBound(i), maxNanoseconds);
+        }
+    }
+
+    return maxNanoseconds;
+}
+
+void TurnProfile::record(TurnPhase phase, unsigned long long nanoseconds) {
+    phases[phase].record(nanoseconds);
+}
+
+void TurnProfile::merge(const TurnProfile& other) {
+    for (int i = 0; i < NUM_TURN_PHASES; i++) {
+        phases[i].merge(other.phases[i]);
+    }
+}
+
+const LatencyHistogram& TurnProfile::getPhase(TurnPhase phase) const {
+    return phases[phase];
+}
+
+// Table of phase latencies in microseconds with each phase's share of turn time
+void TurnProfile::writeReport(ostream& out) const {
+    unsigned long long totalTime = 0;
+    for (int i = 0; i < NUM_TURN_PHASES; i++) {
+        totalTime += phases[i].getTotal();
+    }
+
+    out << "=== TURN PHASE PROFILE (microseconds) ===" << endl;
+    out << left << setw(12) << "Phase" << right << setw(10) << "Samples" << setw(10) << "Mean"
+        << setw(10) << "p50" << setw(10) << "p99" << setw(10) << "Max" << setw(8) << "Share" << endl;
+
+    out << fixed;
+    for (int i = 0; i < NUM_TURN_PHASES; i++) {
+        const LatencyHistogram& phase = phases[i];
+        double share = (totalTime > 0) ? 100.0 * phase.getTotal() / totalTime : 0.0;
+
+        out << left << setw(12) << getPhaseName(static_cast<TurnPhase>(i)) << right
+            << setw(10) << phase.getCount()
+            << setprecision(2)
+            << setw(10) << phase.getMean() / 1000.0
+            << setw(10) << phase.getPercentile(50) / 1000.0
+            << setw(10) << phase.getPercentile(99) / 1000.0
+            << setw(10) << phase.getMax() / 1000.0
+            << setprecision(1) << setw(7) << share << "%" << endl;
+    }
+}
+
+string TurnProfile::getPhaseName(TurnPhase phase) {
+    switch (phase) {
+    case PHASE_LEADERSHIP: return "Leadership";
+    case PHASE_ELECTION: return "Election";
+    case PHASE_COUP: return "Coup";
+    case PHASE_WEATHER: return "Weather";
+    case PHASE_DISEASE: return "Disease";
+    case PHASE_POPULATION: return "Population";
+    case PHASE_ECONOMY: return "Economy";
+    case PHASE_ARMY: return "Army";
+    case PHASE_LEADER: return "Leader";
+    case PHASE_EVENTS: return "Events";
+    case PHASE_BANK: return "Bank";
+    case PHASE_STABILITY: return "Stability";
+    default: return "Unknown";
+    }
+}
+
+bool TurnProfiler::getIsEnabled() {
+    return isEnabled;
+}
+
+void TurnProfiler::setIsEnabled(bool enabled) {
+    isEnabled = enabled;
+}
+
+// Constructor
+PhaseClock::PhaseClock(TurnProfile* profile) : profile(profile) {
+    if (profile) {
+        lastLap = chrono::steady_clock::now();
+    }
+}
+
+void PhaseClock::lap(TurnPhase phase) {
+    if (!profile) {
+        return;
+    }
+
+    chrono::steady_clock::time_point now = chrono::steady_clock::now();
+    profile->record(phase, chrono::duration_cast<chrono::nanoseconds>(now - lastLap).count());
+    lastLap = now;
+}
@@ -0,0 +1,72 @@
+#include "StrongHold.h"
+#include <string>
+#include <mutex>
+
+using namespace std;
+
+UnitArchetype* UnitCatalog::archetypes = nullptr;
+int UnitCatalog::numArchetypes = 0;
+int UnitCatalog::maxArchetypes = 0;
+mutex UnitCatalog::catalogMutex;
+
+// The built-in archetypes are in place before main() runs
+static const bool builtInArchetypesAdded = UnitCatalog::addBuiltInArchetypes();
+
+bool UnitCatalog::addBuiltInArchetypes() {
+    // Name, attack, defense, speed, food per soldier, cost
+    addArchetype(Symbol("Infantry"), 30, 50, 5, 10, 0);
+    addArchetype(Symbol("Archers"), 50, 40, 3, 15, 0);
+    addArchetype(Symbol("Cavalry"), 70, 60, 8, 25, 0);
+    addArchetype(Symbol("Infantry"), 10, 15, 5, 1, 50);
+    addArchetype(Symbol("Archers"), 15, 5, 8, 1, 75);
+    addArchetype(Symbol("Cavalry"), 20, 10, 15, 1, 100);
+    addArchetype(Symbol("Royal Guards"), 25, 20, 10, 1, 150);
+    return true;
+}
+
+int UnitCatalog::addArchetype(Symbol name, int attack, int defense, int speed, int foodConsumption, int cost) {
+    if (numArchetypes >= maxArchetypes) {
+        int newMaxArchetypes = max(16, maxArchetypes * 2);
+        growArray(archetypes, numArchetypes, newMaxArchetypes);
+        maxArchetypes = newMaxArchetypes;
+    }
+
+    UnitArchetype& archetype = archetypes[numArchetypes];
+    archetype.name = name;
+    archetype.attack = attack;
+    archetype.defense = defense;
+    archetype.speed = speed;
+    archetype.foodConsumption = foodConsumption;
+    archetype.cost = cost;
+    return numArchetypes++;
+}
+
+// Archetype for a unit with these stats. Attack and defense are per-unit
+// bonuses over the archetype anyway, so units only need to match on speed
+// and food consumption; a new archetype is added when none does.
+int UnitCatalog::findOrAdd(Symbol name, int attack, int defense, int speed, int foodConsumption) {
+    lock_guard<mutex> lock(catalogMutex);
+
+    for (int i = 0; i < numArchetypes; i++) {
+        if (archetypes[i].speed == speed && archetypes[i].foodConsumption == foodConsumption) {
+            return i;
+        }
+    }
+    return addArchetype(name, attack, defense, speed, foodConsumption, 0);
+}
+
+const UnitArchetype& UnitCatalog::getArchetype(int id) {
+    if (id < 0 || id >= numArchetypes) {
+        throw out_of_range("Unit archetype id out of range");
+    }
+    return archetypes[id];
+}
+
+// The whole table, for loops over many units
+const UnitArchetype* UnitCatalog::getArchetypes() {
+    return archetypes;
+}
+
+int UnitCatalog::getNumArchetypes() {
+    return numArchetypes;
+}
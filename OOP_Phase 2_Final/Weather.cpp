@@ -1,4 +1,4 @@
-#include "Stronghold.h"
+#include "StrongHold.h"
 #include <iostream>
 #include <fstream>
 #include <string>
@@ -181,14 +181,14 @@ void Weather::generateRandomWeather() {
     setDescription("The kingdom is experiencing " + severityDesc + " " + typeNames[static_cast<int>(type)] + " conditions.");
 
     // Reset and recalculate effects based on new weather
-    Weather temp(getName(), getDescription(), getSeverity(), getType());
+    Weather temp(string(getName()), string(getDescription()), getSeverity(), getType());
     cropEffect = temp.cropEffect;
     movementEffect = temp.movementEffect;
     moraleEffect = temp.moraleEffect;
     diseaseModifier = temp.diseaseModifier;
     isExtreme = temp.isExtreme;
 
-    cout << "Weather has changed to: " << getName() << " - " << getDescription() << endl;
+    LogLine() << "Weather has changed to: " << getName() << " - " << getDescription();
 }
 
 // Apply weather effects to a kingdom
@@ -250,7 +250,7 @@ void Weather::applyEffects(Kingdom* kingdom) {
 
         // Mitigate negative effects based on leader preparedness
         if (preparedness > 0.5 && isExtreme) {
-            cout << leader->getName() << " has prepared the kingdom for the " << getName() << "." << endl;
+            LogLine() << leader->getName() << " has prepared the kingdom for the " << getName() << ".";
 
             // Leadership experience from handling extreme weather
             if (isExtreme) {
@@ -318,3 +318,25 @@ void Weather::load(ifstream& file) {
     file >> isExtreme;
     file.ignore(); // Skip newline
 }
+
+// Save weather data in binary form
+void Weather::saveBinary(SaveWriter& writer) const {
+    EnvironmentalEffect::saveBinary(writer);
+    writer.writeInt(static_cast<int>(type));
+    writer.writeInt(cropEffect);
+    writer.writeInt(movementEffect);
+    writer.writeInt(moraleEffect);
+    writer.writeInt(diseaseModifier);
+    writer.writeBool(isExtreme);
+}
+
+// Load weather data in binary form
+void Weather::loadBinary(SaveReader& reader) {
+    EnvironmentalEffect::loadBinary(reader);
+    type = static_cast<WeatherType>(reader.readInt());
+    cropEffect = reader.readInt();
+    movementEffect = reader.readInt();
+    moraleEffect = reader.readInt();
+    diseaseModifier = reader.readInt();
+    isExtreme = reader.readBool();
+}
@@ -0,0 +1,141 @@
+#include "StrongHold.h"
+#include <string>
+
+using namespace std;
+
+// Constructor
+WorldStore::WorldStore(int initialCapacity)
+    : owners(nullptr), numSlots(0), capacity(0), stabilityLevels(nullptr), gold(nullptr),
+    totalPopulations(nullptr), healthLevels(nullptr), marketStabilities(nullptr),
+    inflations(nullptr), employmentRates(nullptr), overallMorales(nullptr) {
+
+    reserve(max(1, initialCapacity));
+}
+
+// Destructor
+WorldStore::~WorldStore() {
+    delete[] owners;
+    delete[] stabilityLevels;
+    delete[] gold;
+    delete[] totalPopulations;
+    delete[] healthLevels;
+    delete[] marketStabilities;
+    delete[] inflations;
+    delete[] employmentRates;
+    delete[] overallMorales;
+}
+
+int WorldStore::getNumSlots() const {
+    return numSlots;
+}
+
+int WorldStore::getCapacity() const {
+    return capacity;
+}
+
+Kingdom* WorldStore::getOwner(int slot) const {
+    if (slot < 0 || slot >= numSlots) {
+        throw out_of_range("World store slot out of range");
+    }
+    return owners[slot];
+}
+
+// Make room for a number of kingdoms up front, e.g. before building a large world
+void WorldStore::reserve(int newCapacity) {
+    if (newCapacity <= capacity) {
+        return;
+    }
+
+    growArray(owners, numSlots, newCapacity);
+    growArray(stabilityLevels, numSlots, newCapacity);
+    growArray(gold, numSlots, newCapacity);
+    growArray(totalPopulations, numSlots, newCapacity);
+    growArray(healthLevels, numSlots, newCapacity);
+    growArray(marketStabilities, numSlots, newCapacity);
+    growArray(inflations, numSlots, newCapacity);
+    growArray(employmentRates, numSlots, newCapacity);
+    growArray(overallMorales, numSlots, newCapacity);
+
+    capacity = newCapacity;
+}
+
+// Give a kingdom the next free slot. The kingdom moves its values in itself.
+int WorldStore::addKingdom(Kingdom* kingdom) {
+    if (!kingdom) {
+        throw invalid_argument("Cannot add null kingdom to world store");
+    }
+
+    if (numSlots >= capacity) {
+        reserve(capacity * 2);
+    }
+
+    owners[numSlots] = kingdom;
+    return numSlots++;
+}
+
+// Free a slot whose kingdom has already moved its values out
+void WorldStore::removeKingdom(int slot) {
+    if (slot < 0 || slot >= numSlots) {
+        throw out_of_range("World store slot out of range");
+    }
+
+    // Keep the slots dense by moving the last kingdom into the gap
+    int lastSlot = numSlots - 1;
+    if (slot != lastSlot) {
+        owners[slot] = owners[lastSlot];
+        owners[slot]->bindToStore(this, slot);
+    }
+
+    owners[lastSlot] = nullptr;
+    numSlots--;
+}
+
+// One pass per column over all kingdoms
+WorldSummary WorldStore::summarize() const {
+    WorldSummary summary;
+    summary.numKingdoms = numSlots;
+    if (numSlots == 0) {
+        return summary;
+    }
+
+    long long stabilitySum = 0;
+    long long healthSum = 0;
+    long long marketStabilitySum = 0;
+    double inflationSum = 0.0;
+    long long employmentSum = 0;
+    long long moraleSum = 0;
+
+    for (int i = 0; i < numSlots; i++) {
+        summary.totalPopulation += totalPopulations[i];
+    }
+    for (int i = 0; i < numSlots; i++) {
+        summary.totalGold += gold[i];
+    }
+    for (int i = 0; i < numSlots; i++) {
+        stabilitySum += stabilityLevels[i];
+    }
+    for (int i = 0; i < numSlots; i++) {
+        healthSum += healthLevels[i];
+    }
+    for (int i = 0; i < numSlots; i++) {
+        marketStabilitySum += marketStabilities[i];
+    }
+    for (int i = 0; i < numSlots; i++) {
+        inflationSum += inflations[i];
+    }
+    for (int i = 0; i < numSlots; i++) {
+        employmentSum += employmentRates[i];
+    }
+    for (int i = 0; i < numSlots; i++) {
+        moraleSum += overallMorales[i];
+    }
+
+    summary.averageStability = (double)stabilitySum / numSlots;
+    summary.averageHealth = (double)healthSum / numSlots;
+    summary.averageMarketStability = (double)marketStabilitySum / numSlots;
+    summary.averageInflation = inflationSum / numSlots;
+    summary.averageEmploymentRate = (double)employmentSum / numSlots;
+    summary.averageMorale = (double)moraleSum / numSlots;
+
+    return summary;
+}
@@ -1,6 +1,7 @@
-#include "Stronghold.h"
+#include "StrongHold.h"
 #include <iostream>
 #include <string>
+#include <chrono>
 #include <ctime>
 #include <cstdlib>
 
@@ -13,17 +14,114 @@ void startNewGame(GameEngine& gameEngine);
 void loadSavedGame(GameEngine& gameEngine);
 void displayCredits();
 void displayHelp();
+void runMainMenu(GameEngine& gameEngine);
+int replaySession(const string& filename);
 
-int main() {
-    // Seed random number generator
-    srand(static_cast<unsigned int>(time(nullptr)));
+int main(int argc, char* argv[]) {
+    string recordFilename;
+    string replayFilename;
+
+    // Parse command line options
+    for (int i = 1; i < argc; i++) {
+        string option = argv[i];
+
+        if (option == "--record" && i + 1 < argc) {
+            recordFilename = argv[++i];
+        }
+        else if (option == "--replay" && i + 1 < argc) {
+            replayFilename = argv[++i];
+        }
+        else {
+            cerr << "Usage: " << argv[0] << " [--record FILE | --replay FILE]" << endl;
+            cerr << "  --record FILE  Write the seed and every input of the session to FILE" << endl;
+            cerr << "  --replay FILE  Play a recorded session again without console output" << endl;
+            return 1;
+        }
+    }
+
+    if (!replayFilename.empty()) {
+        return replaySession(replayFilename);
+    }
+
+    // Seed the master random generator
+    unsigned long long seed = static_cast<unsigned long long>(time(nullptr));
+    setMasterSeed(seed);
+
+    // Everything the player types goes through the recorder
+    InputRecorder* recorder = nullptr;
+    streambuf* consoleInput = cin.rdbuf();
+    if (!recordFilename.empty()) {
+        try {
+            recorder = new InputRecorder(recordFilename, consoleInput, seed);
+        }
+        catch (const exception& e) {
+            cerr << "Error: " << e.what() << endl;
+            return 1;
+        }
+        cin.rdbuf(recorder);
+    }
 
     // Create game engine
     GameEngine gameEngine;
+    runMainMenu(gameEngine);
+
+    cin.rdbuf(consoleInput);
+    delete recorder;
+
+    return 0;
+}
+
+// Play a recorded session again, without console output and as fast as it runs
+int replaySession(const string& filename) {
+    try {
+        InputReplayer replayer(filename);
+        setMasterSeed(replayer.getSeed());
+
+        // Input comes from the journal and output is dropped. The stream
+        // lets ReplayFinished through once the journal runs out.
+        streambuf* consoleInput = cin.rdbuf(&replayer);
+        streambuf* consoleOutput = cout.rdbuf(nullptr);
+        cin.exceptions(ios::badbit);
+        SimulationLog::setLevel(LOG_NONE);
+
+        auto startTime = chrono::steady_clock::now();
+        int finalTurn = 0;
+        {
+            GameEngine gameEngine;
+            try {
+                runMainMenu(gameEngine);
+            }
+            catch (const ReplayFinished&) {
+                // The recording ends before the player left the game
+            }
+            finalTurn = gameEngine.getCurrentTurn();
+        }
+        double elapsedMilliseconds = chrono::duration<double, milli>(chrono::steady_clock::now() - startTime).count();
+
+        cin.exceptions(ios::goodbit);
+        cin.rdbuf(consoleInput);
+        cin.clear();
+        cout.rdbuf(consoleOutput);
+        cout.clear();
 
+        cout << "Replayed " << replayer.getNumBytes() << " bytes of input from " << filename
+            << " up to turn " << finalTurn << " in " << fixed << setprecision(1) << elapsedMilliseconds << " ms" << endl;
+        return 0;
+    }
+    catch (const exception& e) {
+        cerr << "Error: " << e.what() << endl;
+        return 1;
+    }
+}
+
+// The main menu, until the player chooses to exit
+void runMainMenu(GameEngine& gameEngine) {
     bool exitGame = false;
     int choice;
 
+    // The last few turns can be rewound from the kingdom menu
+    gameEngine.setTurnHistoryDepth(10);
+
     displayWelcomeMessage();
 
     while (!exitGame) {
@@ -60,8 +158,6 @@ int main() {
             break;
         }
     }
-
-    return 0;
 }
 
 void displayWelcomeMessage() {
@@ -168,6 +264,9 @@ void loadSavedGame(GameEngine& gameEngine) {
     }
 
     try {
+        // Binary saves open with just the player's kingdom; the others are
+        // read once the game first needs them
+        gameEngine.setLazyLoading(true);
         gameEngine.loadGame(filename);
         cout << "Game loaded successfully." << endl;
         cout << "Press Enter to continue your reign..." << endl;